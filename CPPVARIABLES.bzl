@@ -65,6 +65,9 @@ DDS_LOCAL_DEFINES = select({
 }) + select({
     "//:tt_reset_debug": ["DDS_DEBUG_TT_RESET"],
     "//conditions:default": [],
+}) + select({
+    "//:threads_stl": ["DDS_THREADS_STL"],
+    "//conditions:default": [],
 })
 
 DDS_LINKOPTS = select({
@@ -76,6 +79,9 @@ DDS_LINKOPTS = select({
 }) + select({
     "//:asan": ["-fsanitize=address"],
     "//conditions:default": [],
+}) + select({
+    "//:threads_stl": ["-pthread"],
+    "//conditions:default": [],
 })
 
 # Per-target define to enable scheduler timing when desired.
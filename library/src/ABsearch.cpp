@@ -18,27 +18,30 @@
 #include <system/TimerList.hpp>
 #include "dump.hpp"
 #include <lookup_tables/LookupTables.hpp>
-
-// Internal ctx-enabled variants (forward declarations)
-static bool ABsearch0_ctx(pos * posPoint, int target, int depth, SolverContext& ctx);
-static bool ABsearch1_ctx(pos * posPoint, int target, int depth, SolverContext& ctx);
-static bool ABsearch2_ctx(pos * posPoint, int target, int depth, SolverContext& ctx);
-static bool ABsearch3_ctx(pos * posPoint, int target, int depth, SolverContext& ctx);
-evalType EvaluateWithContext(pos const * posPoint, int trump, SolverContext& ctx);
-
-// ctx-enabled helpers to keep search-state access behind the facade
+#include <lookup_tables/CardHolders.hpp>
+
+// Internal ctx-enabled variants (forward declarations). They take the
+// context's SearchView, so no node copies or releases a shared_ptr.
+static bool ABsearch_ctx(pos * posPoint, int target, int depth, const SearchView& sv);
+static bool ABsearch0_ctx(pos * posPoint, int target, int depth, const SearchView& sv);
+static bool ABsearch1_ctx(pos * posPoint, int target, int depth, const SearchView& sv);
+static bool ABsearch2_ctx(pos * posPoint, int target, int depth, const SearchView& sv);
+static bool ABsearch3_ctx(pos * posPoint, int target, int depth, const SearchView& sv);
+static evalType Evaluate_ctx(pos const * posPoint, int trump, const SearchView& sv);
+
+// ctx-enabled helpers that work on the SearchView
 static void Make3_ctx(
   pos * posPoint,
   unsigned short trickCards[DDS_SUITS],
   const int depth,
   moveType const * mply,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 static void Undo0_ctx(
   pos * posPoint,
   const int depth,
   const moveType& mply,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 
 void Make3Simple(
@@ -77,12 +80,44 @@ void Undo3(
 
 const int handDelta[DDS_SUITS] = { 256, 16, 1, 0 };
 
+// Completed tricks between two looks at the clock and the cancel flag.
+// Each costs about a microsecond of search, so this is a millisecond.
+const int SEARCH_LIMIT_INTERVAL = 1024;
+
+
+// Called when trickNodes reaches limitCheck. Once the limits are hit it
+// keeps returning true, and the search unwinds without going deeper.
+static bool SearchStopped(ThreadData * thrp)
+{
+  if (thrp->stopReason != RETURN_NO_FAULT)
+    return true;
+
+  thrp->stopReason = thrp->limits->reached();
+  if (thrp->stopReason == RETURN_NO_FAULT)
+  {
+    thrp->limitCheck = thrp->trickNodes + SEARCH_LIMIT_INTERVAL;
+    return false;
+  }
+
+  thrp->limitCheck = 0;
+  return true;
+}
+
 
 bool ABsearch(
   pos * posPoint,
   const int target,
   const int depth,
   SolverContext& ctx)
+{
+  return ABsearch_ctx(posPoint, target, depth, ctx.searchView());
+}
+
+static bool ABsearch_ctx(
+  pos * posPoint,
+  const int target,
+  const int depth,
+  const SearchView& sv)
 {
   /* posPoint points to the current look-ahead position,
      target is number of tricks to take for the player,
@@ -90,26 +125,26 @@ bool ABsearch(
      the value of the subtree is returned.
      This is a specialized AB function for handRelFirst == 0. */
 
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int hand = posPoint->first[depth];
   int tricks = depth >> 2;
-  bool success = (ctx.search().nodeTypeStore(hand) == MAXNODE ? true : false);
+  bool success = (thrp->nodeTypeStore[hand] == MAXNODE ? true : false);
   bool value = ! success;
 #ifdef DDS_TOP_LEVEL
-  ctx.search().nodes()++;
+  thrp->nodes++;
 #endif
 
   TIMER_START(TIMER_NO_MOVEGEN, depth);
   for (int ss = 0; ss < DDS_SUITS; ss++)
-    ctx.search().lowestWin(depth, ss) = 0;
+    thrp->lowestWin[depth][ss] = 0;
 
-  ctx.moveGen().MoveGen0(
+  sv.moves().MoveGen0(
     tricks,
     * posPoint,
-    ctx.search().bestMove(depth),
-    ctx.search().bestMoveTT(depth),
-    thrp->rel);
-  ctx.moveGen().Purge(tricks, 0, ctx.search().forbiddenMoves());
+    thrp->bestMove[depth],
+    thrp->bestMoveTT[depth],
+    thrp->holders);
+  sv.moves().Purge(tricks, 0, thrp->forbiddenMoves);
 
   TIMER_END(TIMER_NO_MOVEGEN, depth);
 
@@ -119,7 +154,7 @@ bool ABsearch(
   while (1)
   {
     TIMER_START(TIMER_NO_MAKE, depth);
-    moveType const * mply = ctx.moveGen().MakeNext(tricks, 0,
+    moveType const * mply = sv.moves().MakeNext(tricks, 0,
       posPoint->winRanks[depth]);
 #ifdef DDS_AB_STATS
     thrp->ABStats.IncrNode(depth);
@@ -132,7 +167,7 @@ bool ABsearch(
     Make0(posPoint, depth, mply);
 
     TIMER_START(TIMER_NO_AB, depth - 1);
-  value = ABsearch1_ctx(posPoint, target, depth - 1, ctx);
+  value = ABsearch1_ctx(posPoint, target, depth - 1, sv);
     TIMER_END(TIMER_NO_AB, depth - 1);
 
     TIMER_START(TIMER_NO_UNDO, depth);
@@ -145,9 +180,9 @@ bool ABsearch(
         posPoint->winRanks[depth][ss] =
           posPoint->winRanks[depth - 1][ss];
 
-  ctx.search().bestMove(depth) = * mply;
+  thrp->bestMove[depth] = * mply;
 #ifdef DDS_MOVES
-  ctx.moveGen().RegisterHit(tricks, 0);
+  sv.moves().RegisterHit(tricks, 0);
 #endif
       goto ABexit;
     }
@@ -176,7 +211,7 @@ bool ABsearch0(
   const int depth,
   SolverContext& ctx)
 {
-  return ABsearch0_ctx(posPoint, target, depth, ctx);
+  return ABsearch0_ctx(posPoint, target, depth, ctx.searchView());
 }
 
 // ctx-enabled implementation
@@ -184,7 +219,7 @@ static bool ABsearch0_ctx(
   pos * posPoint,
   const int target,
   const int depth,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
   /* posPoint points to the current look-ahead position,
      target is number of tricks to take for the player,
@@ -192,13 +227,13 @@ static bool ABsearch0_ctx(
      the value of the subtree is returned.
      This is a specialized AB function for handRelFirst == 0. */
 
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int trump = thrp->trump;
   int hand = posPoint->first[depth];
   int tricks = depth >> 2;
 
 #ifdef DDS_TOP_LEVEL
-  ctx.search().nodes()++;
+  thrp->nodes++;
 #endif
 
   for (int ss = 0; ss < DDS_SUITS; ss++)
@@ -208,7 +243,7 @@ static bool ABsearch0_ctx(
   {
     /* Find node that fits the suit lengths */
     int limit;
-    if (ctx.search().nodeTypeStore(0) == MAXNODE)
+    if (thrp->nodeTypeStore[0] == MAXNODE)
       limit = target - posPoint->tricksMAX - 1;
     else
       limit = tricks - (target - posPoint->tricksMAX - 1);
@@ -216,7 +251,7 @@ static bool ABsearch0_ctx(
     bool lowerFlag;
     TIMER_START(TIMER_NO_LOOKUP, depth);
   NodeCards const * cardsP =
-      ctx.transTable()->lookup(
+      sv.transTable()->lookup(
         tricks, hand, posPoint->aggr, posPoint->handDist,
         limit, lowerFlag);
     TIMER_END(TIMER_NO_LOOKUP, depth);
@@ -235,11 +270,11 @@ static bool ABsearch0_ctx(
 
       if (cardsP->best_move_rank != 0)
       {
-        ctx.search().bestMoveTT(depth).suit = static_cast<unsigned char>(cardsP->best_move_suit);
-        ctx.search().bestMoveTT(depth).rank = static_cast<unsigned char>(cardsP->best_move_rank);
+        thrp->bestMoveTT[depth].suit = static_cast<unsigned char>(cardsP->best_move_suit);
+        thrp->bestMoveTT[depth].rank = static_cast<unsigned char>(cardsP->best_move_rank);
       }
 
-      bool scoreFlag = (ctx.search().nodeTypeStore(0) == MAXNODE ? lowerFlag : ! lowerFlag);
+      bool scoreFlag = (thrp->nodeTypeStore[0] == MAXNODE ? lowerFlag : ! lowerFlag);
 
       AB_COUNT(AB_MAIN_LOOKUP, scoreFlag, depth);
       return scoreFlag;
@@ -259,7 +294,7 @@ static bool ABsearch0_ctx(
   else if (depth == 0) /* Maximum depth? */
   {
     TIMER_START(TIMER_NO_EVALUATE, depth);
-    evalType evalData = EvaluateWithContext(posPoint, trump, ctx);
+    evalType evalData = Evaluate_ctx(posPoint, trump, sv);
     TIMER_END(TIMER_NO_EVALUATE, depth);
 
     bool value = (evalData.tricks >= target ? true : false);
@@ -274,10 +309,10 @@ static bool ABsearch0_ctx(
   bool res;
   TIMER_START(TIMER_NO_QT, depth);
   int qtricks = QuickTricks(* posPoint, hand, depth, target,
-    trump, res, ctx);
+    trump, res, sv);
   TIMER_END(TIMER_NO_QT, depth);
 
-  if (ctx.search().nodeTypeStore(hand) == MAXNODE)
+  if (thrp->nodeTypeStore[hand] == MAXNODE)
   {
     if (res)
     {
@@ -286,7 +321,7 @@ static bool ABsearch0_ctx(
     }
 
   TIMER_START(TIMER_NO_LT, depth);
-  res = LaterTricksMIN(* posPoint, hand, depth, target, trump, ctx);
+  res = LaterTricksMIN(* posPoint, hand, depth, target, trump, sv);
   TIMER_END(TIMER_NO_LT, depth);
 
     if (! res)
@@ -304,7 +339,7 @@ static bool ABsearch0_ctx(
     }
 
   TIMER_START(TIMER_NO_LT, depth);
-  res = LaterTricksMAX(* posPoint, hand, depth, target, trump, ctx);
+  res = LaterTricksMAX(* posPoint, hand, depth, target, trump, sv);
   TIMER_END(TIMER_NO_LT, depth);
 
     if (res)
@@ -318,7 +353,7 @@ static bool ABsearch0_ctx(
   {
     /* Find node that fits the suit lengths */
     int limit;
-    if (ctx.search().nodeTypeStore(0) == MAXNODE)
+    if (thrp->nodeTypeStore[0] == MAXNODE)
       limit = target - posPoint->tricksMAX - 1;
     else
       limit = tricks - (target - posPoint->tricksMAX - 1);
@@ -326,7 +361,7 @@ static bool ABsearch0_ctx(
     bool lowerFlag;
     TIMER_START(TIMER_NO_LOOKUP, depth);
   NodeCards const * cardsP =
-      ctx.transTable()->lookup(
+      sv.transTable()->lookup(
         tricks, hand, posPoint->aggr, posPoint->handDist,
         limit, lowerFlag);
     TIMER_END(TIMER_NO_LOOKUP, depth);
@@ -345,30 +380,30 @@ static bool ABsearch0_ctx(
 
       if (cardsP->best_move_rank != 0)
       {
-        ctx.search().bestMoveTT(depth).suit = static_cast<unsigned char>(cardsP->best_move_suit);
-        ctx.search().bestMoveTT(depth).rank = static_cast<unsigned char>(cardsP->best_move_rank);
+        thrp->bestMoveTT[depth].suit = static_cast<unsigned char>(cardsP->best_move_suit);
+        thrp->bestMoveTT[depth].rank = static_cast<unsigned char>(cardsP->best_move_rank);
       }
 
-      bool scoreFlag = (ctx.search().nodeTypeStore(0) == MAXNODE ? lowerFlag : ! lowerFlag);
+      bool scoreFlag = (thrp->nodeTypeStore[0] == MAXNODE ? lowerFlag : ! lowerFlag);
 
       AB_COUNT(AB_MAIN_LOOKUP, scoreFlag, depth);
       return scoreFlag;
     }
   }
 
-  bool success = (ctx.search().nodeTypeStore(hand) == MAXNODE ? true : false);
+  bool success = (thrp->nodeTypeStore[hand] == MAXNODE ? true : false);
   bool value = ! success;
 
   TIMER_START(TIMER_NO_MOVEGEN, depth);
   for (int ss = 0; ss < DDS_SUITS; ss++)
-    ctx.search().lowestWin(depth, ss) = 0;
+    thrp->lowestWin[depth][ss] = 0;
 
-  ctx.moveGen().MoveGen0(
+  sv.moves().MoveGen0(
     tricks,
     * posPoint,
-    ctx.search().bestMove(depth),
-    ctx.search().bestMoveTT(depth),
-    thrp->rel);
+    thrp->bestMove[depth],
+    thrp->bestMoveTT[depth],
+    thrp->holders);
 
   TIMER_END(TIMER_NO_MOVEGEN, depth);
 
@@ -378,7 +413,7 @@ static bool ABsearch0_ctx(
   while (1)
   {
     TIMER_START(TIMER_NO_MAKE, depth);
-    moveType const * mply = ctx.moveGen().MakeNext(tricks, 0,
+    moveType const * mply = sv.moves().MakeNext(tricks, 0,
       posPoint->winRanks[depth]);
 #ifdef DDS_AB_STATS
     thrp->ABStats.IncrNode(depth);
@@ -391,22 +426,26 @@ static bool ABsearch0_ctx(
     Make0(posPoint, depth, mply);
 
     TIMER_START(TIMER_NO_AB, depth - 1);
-  value = ABsearch1_ctx(posPoint, target, depth - 1, ctx);
+  value = ABsearch1_ctx(posPoint, target, depth - 1, sv);
     TIMER_END(TIMER_NO_AB, depth - 1);
 
     TIMER_START(TIMER_NO_UNDO, depth);
     Undo1(posPoint, depth, * mply);
     TIMER_END(TIMER_NO_UNDO, depth);
 
+    // A stopped search has no value, and nothing may reach the TT.
+    if (thrp->stopReason != RETURN_NO_FAULT)
+      return value;
+
     if (value == success) /* A cut-off? */
     {
       for (int ss = 0; ss < DDS_SUITS; ss++)
         posPoint->winRanks[depth][ss] =
           posPoint->winRanks[depth - 1][ss];
 
-      ctx.search().bestMove(depth) = * mply;
+      thrp->bestMove[depth] = * mply;
 #ifdef DDS_MOVES
-  ctx.moveGen().RegisterHit(tricks, 0);
+  sv.moves().RegisterHit(tricks, 0);
 #endif
       goto ABexit;
     }
@@ -422,7 +461,7 @@ ABexit:
   NodeCards first;
   if (value)
   {
-    if (ctx.search().nodeTypeStore(0) == MAXNODE)
+    if (thrp->nodeTypeStore[0] == MAXNODE)
     {
       first.upper_bound = static_cast<char>(tricks + 1);
       first.lower_bound = static_cast<char>(target - posPoint->tricksMAX);
@@ -436,7 +475,7 @@ ABexit:
   }
   else
   {
-    if (ctx.search().nodeTypeStore(0) == MAXNODE)
+    if (thrp->nodeTypeStore[0] == MAXNODE)
     {
       first.upper_bound = static_cast<char>
                      (target - posPoint->tricksMAX - 1);
@@ -450,16 +489,16 @@ ABexit:
     }
   }
 
-  first.best_move_suit = static_cast<char>(ctx.search().bestMove(depth).suit);
-  first.best_move_rank = static_cast<char>(ctx.search().bestMove(depth).rank);
+  first.best_move_suit = static_cast<char>(thrp->bestMove[depth].suit);
+  first.best_move_rank = static_cast<char>(thrp->bestMove[depth].rank);
 
   bool flag =
-    ((ctx.search().nodeTypeStore(hand) == MAXNODE && value) ||
-     (ctx.search().nodeTypeStore(hand) == MINNODE && !value))
+    ((thrp->nodeTypeStore[hand] == MAXNODE && value) ||
+     (thrp->nodeTypeStore[hand] == MINNODE && !value))
     ? true : false;
 
   TIMER_START(TIMER_NO_BUILD, depth);
-  ctx.transTable()->add(
+  sv.transTable()->add(
     tricks,
     hand,
     posPoint->aggr,
@@ -470,7 +509,7 @@ ABexit:
 
 #ifdef DDS_AB_HITS
   DumpStored(thrp->fileStored.GetStream(), 
-    * posPoint, ctx, first, target, depth);
+    * posPoint, sv.moves(), first, target, depth);
 #endif
 
   AB_COUNT(AB_MOVE_LOOP, value, depth);
@@ -484,28 +523,28 @@ bool ABsearch1(
   const int depth,
   SolverContext& ctx)
 {
-  return ABsearch1_ctx(posPoint, target, depth, ctx);
+  return ABsearch1_ctx(posPoint, target, depth, ctx.searchView());
 }
 
 static bool ABsearch1_ctx(
   pos * posPoint,
   const int target,
   const int depth,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int trump = thrp->trump;
   int hand = handId(posPoint->first[depth], 1);
-  bool success = (ctx.search().nodeTypeStore(hand) == MAXNODE ? true : false);
+  bool success = (thrp->nodeTypeStore[hand] == MAXNODE ? true : false);
   bool value = ! success;
   int tricks = (depth + 3) >> 2;
 
 #ifdef DDS_TOP_LEVEL
-  ctx.search().nodes()++;
+  thrp->nodes++;
 #endif
 
   TIMER_START(TIMER_NO_QT, depth);
-  int res = QuickTricksSecondHand(* posPoint, hand, depth, target, trump, ctx);
+  int res = QuickTricksSecondHand(* posPoint, hand, depth, target, trump, sv);
   TIMER_END(TIMER_NO_QT, depth);
   if (res) 
   {
@@ -515,11 +554,11 @@ static bool ABsearch1_ctx(
 
   TIMER_START(TIMER_NO_MOVEGEN, depth);
   for (int ss = 0; ss < DDS_SUITS; ss++)
-    ctx.search().lowestWin(depth, ss) = 0;
+    thrp->lowestWin[depth][ss] = 0;
 
-  ctx.moveGen().MoveGen123(tricks, 1, * posPoint);
-  if (depth == ctx.search().iniDepth())
-    ctx.moveGen().Purge(tricks, 1, ctx.search().forbiddenMoves());
+  sv.moves().MoveGen123(tricks, 1, * posPoint);
+  if (depth == thrp->iniDepth)
+    sv.moves().Purge(tricks, 1, thrp->forbiddenMoves);
 
   TIMER_END(TIMER_NO_MOVEGEN, depth);
 
@@ -529,7 +568,7 @@ static bool ABsearch1_ctx(
   while (1)
   {
     TIMER_START(TIMER_NO_MAKE, depth);
-  moveType const * mply = ctx.moveGen().MakeNext(tricks, 1, posPoint->winRanks[depth]);
+  moveType const * mply = sv.moves().MakeNext(tricks, 1, posPoint->winRanks[depth]);
 #ifdef DDS_AB_STATS
     thrp->ABStats.IncrNode(depth);
 #endif
@@ -541,7 +580,7 @@ static bool ABsearch1_ctx(
     Make1(posPoint, depth, mply);
 
     TIMER_START(TIMER_NO_AB, depth - 1);
-  value = ABsearch2_ctx(posPoint, target, depth - 1, ctx);
+  value = ABsearch2_ctx(posPoint, target, depth - 1, sv);
     TIMER_END(TIMER_NO_AB, depth - 1);
 
     TIMER_START(TIMER_NO_UNDO, depth);
@@ -553,9 +592,9 @@ static bool ABsearch1_ctx(
       for (int ss = 0; ss < DDS_SUITS; ss++)
         posPoint->winRanks[depth][ss] = posPoint->winRanks[depth - 1][ss];
 
-      ctx.search().bestMove(depth) = * mply;
+      thrp->bestMove[depth] = * mply;
 #ifdef DDS_MOVES
-  ctx.moveGen().RegisterHit(tricks, 1);
+  sv.moves().RegisterHit(tricks, 1);
 #endif
       goto ABexit;
     }
@@ -580,32 +619,32 @@ bool ABsearch2(
   const int depth,
   SolverContext& ctx)
 {
-  return ABsearch2_ctx(posPoint, target, depth, ctx);
+  return ABsearch2_ctx(posPoint, target, depth, ctx.searchView());
 }
 
 static bool ABsearch2_ctx(
   pos * posPoint,
   const int target,
   const int depth,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int hand = handId(posPoint->first[depth], 2);
-  bool success = (ctx.search().nodeTypeStore(hand) == MAXNODE ? true : false);
+  bool success = (thrp->nodeTypeStore[hand] == MAXNODE ? true : false);
   bool value = ! success;
   int tricks = (depth + 3) >> 2;
 
 #ifdef DDS_TOP_LEVEL
-  ctx.search().nodes()++;
+  thrp->nodes++;
 #endif
 
   TIMER_START(TIMER_NO_MOVEGEN, depth);
   for (int ss = 0; ss < DDS_SUITS; ss++)
-    ctx.search().lowestWin(depth, ss) = 0;
+    thrp->lowestWin[depth][ss] = 0;
 
-  ctx.moveGen().MoveGen123(tricks, 2, * posPoint);
-  if (depth == ctx.search().iniDepth())
-    ctx.moveGen().Purge(tricks, 2, ctx.search().forbiddenMoves());
+  sv.moves().MoveGen123(tricks, 2, * posPoint);
+  if (depth == thrp->iniDepth)
+    sv.moves().Purge(tricks, 2, thrp->forbiddenMoves);
 
   TIMER_END(TIMER_NO_MOVEGEN, depth);
 
@@ -615,7 +654,7 @@ static bool ABsearch2_ctx(
   while (1)
   {
     TIMER_START(TIMER_NO_MAKE, depth);
-  moveType const * mply = ctx.moveGen().MakeNext(tricks, 2, posPoint->winRanks[depth]);
+  moveType const * mply = sv.moves().MakeNext(tricks, 2, posPoint->winRanks[depth]);
 
     if (mply == NULL)
       break;
@@ -628,7 +667,7 @@ static bool ABsearch2_ctx(
     TIMER_END(TIMER_NO_MAKE, depth);
 
     TIMER_START(TIMER_NO_AB, depth - 1);
-  value = ABsearch3_ctx(posPoint, target, depth - 1, ctx);
+  value = ABsearch3_ctx(posPoint, target, depth - 1, sv);
     TIMER_END(TIMER_NO_AB, depth - 1);
 
     TIMER_START(TIMER_NO_UNDO, depth);
@@ -640,9 +679,9 @@ static bool ABsearch2_ctx(
       for (int ss = 0; ss < DDS_SUITS; ss++)
         posPoint->winRanks[depth][ss] = posPoint->winRanks[depth - 1][ss];
 
-      ctx.search().bestMove(depth) = * mply;
+      thrp->bestMove[depth] = * mply;
 #ifdef DDS_MOVES
-  ctx.moveGen().RegisterHit(tricks, 2);
+  sv.moves().RegisterHit(tricks, 2);
 #endif
       goto ABexit;
     }
@@ -667,36 +706,36 @@ bool ABsearch3(
   const int depth,
   SolverContext& ctx)
 {
-  return ABsearch3_ctx(posPoint, target, depth, ctx);
+  return ABsearch3_ctx(posPoint, target, depth, ctx.searchView());
 }
 
 static bool ABsearch3_ctx(
   pos * posPoint,
   const int target,
   const int depth,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
   /* This is a specialized AB function for handRelFirst == 3. */
 
   unsigned short int makeWinRank[DDS_SUITS];
 
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int hand = handId(posPoint->first[depth], 3);
-  bool success = (ctx.search().nodeTypeStore(hand) == MAXNODE ? true : false);
+  bool success = (thrp->nodeTypeStore[hand] == MAXNODE ? true : false);
   bool value = ! success;
 
 #ifdef DDS_TOP_LEVEL
-  ctx.search().nodes()++;
+  thrp->nodes++;
 #endif
 
   TIMER_START(TIMER_NO_MOVEGEN, depth);
   for (int ss = 0; ss < DDS_SUITS; ss++)
-    ctx.search().lowestWin(depth, ss) = 0;
+    thrp->lowestWin[depth][ss] = 0;
   int tricks = (depth + 3) >> 2;
 
-  ctx.moveGen().MoveGen123(tricks, 3, * posPoint);
-  if (depth == ctx.search().iniDepth())
-    ctx.moveGen().Purge(tricks, 3, ctx.search().forbiddenMoves());
+  sv.moves().MoveGen123(tricks, 3, * posPoint);
+  if (depth == thrp->iniDepth)
+    sv.moves().Purge(tricks, 3, thrp->forbiddenMoves);
 
   TIMER_END(TIMER_NO_MOVEGEN, depth);
 
@@ -706,7 +745,7 @@ static bool ABsearch3_ctx(
   while (1)
   {
     TIMER_START(TIMER_NO_MAKE, depth);
-  moveType const * mply = ctx.moveGen().MakeNext(tricks, 3, posPoint->winRanks[depth]);
+  moveType const * mply = sv.moves().MakeNext(tricks, 3, posPoint->winRanks[depth]);
 #ifdef DDS_AB_STATS
     thrp->ABStats.IncrNode(depth);
 #endif
@@ -715,21 +754,27 @@ static bool ABsearch3_ctx(
     if (mply == NULL)
       break;
 
-  Make3_ctx(posPoint, makeWinRank, depth, mply, ctx);
+  Make3_ctx(posPoint, makeWinRank, depth, mply, sv);
 
-    ctx.search().trickNodes()++; // As handRelFirst == 0
+    thrp->trickNodes++; // As handRelFirst == 0
 
-    if (ctx.search().nodeTypeStore(posPoint->first[depth - 1]) == MAXNODE)
+    if (thrp->trickNodes >= thrp->limitCheck && SearchStopped(thrp))
+    {
+      Undo0_ctx(posPoint, depth, * mply, sv);
+      return value;
+    }
+
+    if (thrp->nodeTypeStore[posPoint->first[depth - 1]] == MAXNODE)
       posPoint->tricksMAX++;
 
   TIMER_START(TIMER_NO_AB, depth - 1);
-  value = ABsearch0_ctx(posPoint, target, depth - 1, ctx);
+  value = ABsearch0_ctx(posPoint, target, depth - 1, sv);
     TIMER_END(TIMER_NO_AB, depth - 1);
 
     TIMER_START(TIMER_NO_UNDO, depth);
-  Undo0_ctx(posPoint, depth, * mply, ctx);
+  Undo0_ctx(posPoint, depth, * mply, sv);
 
-    if (ctx.search().nodeTypeStore(posPoint->first[depth - 1]) == MAXNODE)
+    if (thrp->nodeTypeStore[posPoint->first[depth - 1]] == MAXNODE)
       posPoint->tricksMAX--;
 
     TIMER_END(TIMER_NO_UNDO, depth);
@@ -740,9 +785,9 @@ static bool ABsearch3_ctx(
         posPoint->winRanks[depth][ss] = static_cast<unsigned short>(
           posPoint->winRanks[depth - 1][ss] | makeWinRank[ss]);
 
-      ctx.search().bestMove(depth) = * mply;
+      thrp->bestMove[depth] = * mply;
 #ifdef DDS_MOVES
-  ctx.moveGen().RegisterHit(tricks, 3);
+  sv.moves().RegisterHit(tricks, 3);
 #endif
       goto ABexit;
     }
@@ -826,10 +871,11 @@ void Make3(
   moveType const * mply,
   SolverContext& ctx)
 {
-  auto thrp = ctx.thread();
+  const SearchView sv = ctx.searchView();
+  ThreadData * const thrp = sv.thread();
   int firstHand = posPoint->first[depth];
 
-  const trickDataType& data = ctx.moveGen().GetTrickData((depth + 3) >> 2);
+  const trickDataType& data = sv.moves().GetTrickData((depth + 3) >> 2);
 
   posPoint->first[depth - 1] = handId(firstHand, data.relWinner);
   /* Defines who is first in the next move */
@@ -872,30 +918,32 @@ void Make3(
       wp->winner[n].secondHand = posPoint->secondBest[st].hand;
       wp->number++;
 
-      int aggr = posPoint->aggr[st];
+      unsigned aggr = posPoint->aggr[st];
 
-  posPoint->winner[st].rank = static_cast<unsigned char>(thrp->rel[aggr].absRank[1][st].rank);
-  posPoint->winner[st].hand = static_cast<unsigned char>(thrp->rel[aggr].absRank[1][st].hand);
-  posPoint->secondBest[st].rank = static_cast<unsigned char>(thrp->rel[aggr].absRank[2][st].rank);
-  posPoint->secondBest[st].hand = static_cast<unsigned char>(thrp->rel[aggr].absRank[2][st].hand);
+      const absRankType first = abs_rank(thrp->holders, aggr, 1, st);
+      const absRankType second = abs_rank(thrp->holders, aggr, 2, st);
+      posPoint->winner[st].rank = static_cast<unsigned char>(first.rank);
+      posPoint->winner[st].hand = static_cast<unsigned char>(first.hand);
+      posPoint->secondBest[st].rank = static_cast<unsigned char>(second.rank);
+      posPoint->secondBest[st].hand = static_cast<unsigned char>(second.hand);
 
     }
   }
 }
 
 
-// ctx-enabled version that records winners via the SearchContext facade
+// ctx-enabled version that records winners through the SearchView
 static void Make3_ctx(
   pos * posPoint,
   unsigned short trickCards[DDS_SUITS],
   const int depth,
   moveType const * mply,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
-  auto thrp = ctx.thread();
+  ThreadData * const thrp = sv.thread();
   int firstHand = posPoint->first[depth];
 
-  const trickDataType& data = ctx.moveGen().GetTrickData((depth + 3) >> 2);
+  const trickDataType& data = sv.moves().GetTrickData((depth + 3) >> 2);
 
   posPoint->first[depth - 1] = handId(firstHand, data.relWinner);
   /* Defines who is first in the next move */
@@ -923,7 +971,7 @@ static void Make3_ctx(
   posPoint->length[h][s]--;
 
   // Changes that we may have to undo.
-  WinnersType * wp = &ctx.search().winners((depth + 3) >> 2);
+  WinnersType * wp = &thrp->winners[(depth + 3) >> 2];
   wp->number = 0;
 
   for (int st = 0; st < 4; st++)
@@ -938,12 +986,14 @@ static void Make3_ctx(
       wp->winner[n].secondHand = posPoint->secondBest[st].hand;
       wp->number++;
 
-      int aggr = posPoint->aggr[st];
+      unsigned aggr = posPoint->aggr[st];
 
-      posPoint->winner[st].rank = static_cast<unsigned char>(thrp->rel[aggr].absRank[1][st].rank);
-      posPoint->winner[st].hand = static_cast<unsigned char>(thrp->rel[aggr].absRank[1][st].hand);
-      posPoint->secondBest[st].rank = static_cast<unsigned char>(thrp->rel[aggr].absRank[2][st].rank);
-      posPoint->secondBest[st].hand = static_cast<unsigned char>(thrp->rel[aggr].absRank[2][st].hand);
+      const absRankType first = abs_rank(thrp->holders, aggr, 1, st);
+      const absRankType second = abs_rank(thrp->holders, aggr, 2, st);
+      posPoint->winner[st].rank = static_cast<unsigned char>(first.rank);
+      posPoint->winner[st].hand = static_cast<unsigned char>(first.hand);
+      posPoint->secondBest[st].rank = static_cast<unsigned char>(second.rank);
+      posPoint->secondBest[st].hand = static_cast<unsigned char>(second.hand);
 
     }
   }
@@ -1013,13 +1063,14 @@ void Undo0(
   }
 }
 
-// ctx-enabled version that reads winners via the SearchContext facade
+// ctx-enabled version that reads winners through the SearchView
 static void Undo0_ctx(
   pos * posPoint,
   const int depth,
   const moveType& mply,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
+  ThreadData * const thrp = sv.thread();
   // No timers here; macros not used in this helper
   int h = handId(posPoint->first[depth], 3);
   int s = mply.suit;
@@ -1031,7 +1082,7 @@ static void Undo0_ctx(
   posPoint->length[h][s]++;
 
   // Changes that we now undo.
-  WinnersType const * wp = &ctx.search().winners((depth + 3) >> 2);
+  WinnersType const * wp = &thrp->winners[(depth + 3) >> 2];
 
   for (int n = 0; n < wp->number; n++)
   {
@@ -1111,7 +1162,16 @@ evalType EvaluateWithContext(
   const int trump,
   SolverContext& ctx)
 {
-  auto thrp = ctx.thread();
+  return Evaluate_ctx(posPoint, trump, ctx.searchView());
+}
+
+
+static evalType Evaluate_ctx(
+  pos const * posPoint,
+  const int trump,
+  const SearchView& sv)
+{
+  ThreadData * const thrp = sv.thread();
   int s, h, hmax = 0, count = 0, k = 0;
   unsigned short rmax = 0;
   evalType eval;
@@ -1141,7 +1201,7 @@ evalType EvaluateWithContext(
       if (count >= 2)
         eval.winRanks[trump] = rmax;
 
-      if (ctx.search().nodeTypeStore(hmax) == MAXNODE)
+      if (thrp->nodeTypeStore[hmax] == MAXNODE)
         goto maxexit;
       else
         goto minexit;
@@ -1174,7 +1234,7 @@ evalType EvaluateWithContext(
   if (count >= 2)
     eval.winRanks[k] = rmax;
 
-  if (ctx.search().nodeTypeStore(hmax) == MAXNODE)
+  if (thrp->nodeTypeStore[hmax] == MAXNODE)
     goto maxexit;
   else
     goto minexit;
@@ -11,89 +11,210 @@
 #include "CalcTables.hpp"
 #include "SolverIF.hpp"
 #include "SolveBoard.hpp"
+#include "EngineState.hpp"
 #include <system/System.hpp>
 #include <system/Memory.hpp>
 #include <system/Scheduler.hpp>
+#include <system/ResultCache.hpp>
+#include <system/DealFingerprint.hpp>
+#include <system/DealSymmetry.hpp>
 #include "PBN.hpp"
+#include <solver_context/ContextPool.hpp>
+#include <api/SolveBoard.hpp>
+#include <atomic>
+#include <unordered_map>
 
 
-paramType cparam;
+extern ResultCache calcCache;
 
-extern System sysdep;
-extern Memory memory;
-extern Scheduler scheduler;
+int BoardRangeChecks(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode);
 
-int CalcAllBoardsN(
-  boards * bop,
-  solvedBoards * solvedp);
 
+static dealFingerprint CalcCacheKey(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  int& rotation)
+{
+  deal canon;
+  dealSymmetry sym;
+  CanonicalDeal(dl, canon, sym);
+  canon.first = 0;
+  rotation = sym.rotation;
+  return DealFingerprint(canon, target, solutions, mode);
+}
 
-void CalcSingleCommon(
-  const int thrId,
-  const int bno)
+
+static bool LookupCalcCache(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  int score[DDS_HANDS])
 {
-  // Solves a single deal and strain for all four declarers.
+  int rotation;
+  futureTricks fut;
+  if (! calcCache.Lookup(
+      CalcCacheKey(dl, target, solutions, mode, rotation), fut))
+    return false;
+
+  for (int k = 0; k < DDS_HANDS; k++)
+    score[k] = fut.score[(k + rotation) % DDS_HANDS];
+  return true;
+}
+
+
+static void StoreCalcCache(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  const int score[DDS_HANDS])
+{
+  int rotation;
+  const dealFingerprint fp =
+    CalcCacheKey(dl, target, solutions, mode, rotation);
 
   futureTricks fut;
-  cparam.bop->deals[bno].first = 0;
+  for (int k = 0; k < DDS_HANDS; k++)
+    fut.score[(k + rotation) % DDS_HANDS] = score[k];
+  calcCache.Store(fp, fut);
+}
 
-  START_THREAD_TIMER(thrId);
-  int res = SolveBoard(
-                cparam.bop->deals[bno],
-                cparam.bop->target[bno],
-                cparam.bop->solutions[bno],
-                cparam.bop->mode[bno],
-                &fut,
-                thrId);
+
+int CalcSingleDeal(
+  SolverContext& ctx,
+  deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  int score[DDS_HANDS])
+{
+  // All four declarers are solved in the long-lived context of this
+  // thread. SolveBoard only resets its TT when the deal or the strain
+  // changes, and the repeat solves run on the same tables and TT.
+
+  // The four scores are cached together, keyed by the canonical form
+  // of the deal, so that a rotated deal or one with the non-trump
+  // suits relabelled is also a hit. The cache holds the scores in
+  // canonical hand order.
+
+  futureTricks fut;
+  int error = RETURN_NO_FAULT;
+
+  dl.first = 0;
+  const bool useCache =
+    ctx.config().useResultCache && calcCache.Capacity() > 0;
+
+  // Invalid input gets its error, never a cached result.
+  if (useCache)
+  {
+    const int ret = BoardRangeChecks(dl, target, solutions, mode);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+  }
+
+  if (useCache && LookupCalcCache(dl, target, solutions, mode, score))
+  {
+    dl.first = DDS_HANDS - 1;
+    return RETURN_NO_FAULT;
+  }
+
+  // Not through the cached SolveBoard, as SolveSameBoard below needs
+  // the search state that this solve leaves behind.
+  int res = SolveBoardInternal(ctx, dl, target, solutions, mode, &fut);
 
   // SH: I'm making a terrible use of the fut structure here.
 
   if (res == 1)
-    cparam.solvedp->solvedBoard[bno].score[0] = fut.score[0];
+    score[0] = fut.score[0];
   else
-    cparam.error = res;
+    error = res;
 
-  // Create an owned context for this worker and use its ThreadData for
-  // subsequent same-board solves.
-  SolverContext outer_ctx;
-  auto thrp = outer_ctx.thread();
   for (int k = 1; k < DDS_HANDS; k++)
   {
     int hint = (k == 2 ? fut.score[0] : 13 - fut.score[0]);
 
-    cparam.bop->deals[bno].first = k; // Next declarer
+    dl.first = k; // Next declarer
 
-    res = SolveSameBoard(thrp, cparam.bop->deals[bno], &fut, hint);
+    res = SolveSameBoard(ctx, dl, &fut, hint);
 
     if (res == 1)
-      cparam.solvedp->solvedBoard[bno].score[k] = fut.score[0];
+      score[k] = fut.score[0];
     else
-      cparam.error = res;
+      error = res;
   }
+
+  if (useCache && error == RETURN_NO_FAULT)
+    StoreCalcCache(dl, target, solutions, mode, score);
+  return error;
+}
+
+
+void CalcSingleCommon(
+  EngineState& eng,
+  const int thrId,
+  const int bno)
+{
+  // Solves a single deal and strain for all four declarers.
+
+  paramType& cparam = eng.calc.param;
+  [[maybe_unused]] Scheduler& scheduler = eng.scheduler;
+  SolverContext& ctx = eng.contextPool.Get(static_cast<unsigned>(thrId));
+
+  START_THREAD_TIMER(thrId);
+  const int res = CalcSingleDeal(
+                    ctx,
+                    cparam.bop->deals[bno],
+                    cparam.bop->target[bno],
+                    cparam.bop->solutions[bno],
+                    cparam.bop->mode[bno],
+                    cparam.solvedp->solvedBoard[bno].score);
   END_THREAD_TIMER(thrId);
+
+  if (res != RETURN_NO_FAULT)
+    cparam.error = res;
 }
 
 
-void CopyCalcSingle(const vector<int>& crossrefs)
+void CopyCalcSingle(
+  EngineState& eng,
+  const vector<int>& crossrefs)
 {
+  paramType& cparam = eng.calc.param;
+  const vector<int>& calcRotations = eng.calc.rotations;
   for (unsigned i = 0; i < crossrefs.size(); i++)
   {
     if (crossrefs[i] == -1)
       continue;
 
-    START_THREAD_TIMER(thrId);
+    // Hand k of board i is the same canonical hand as hand j of the
+    // board it repeats.
+    const unsigned ref = static_cast<unsigned>(crossrefs[i]);
+    const int shift = calcRotations[i] - calcRotations[ref] + DDS_HANDS;
+
     for (int k = 0; k < DDS_HANDS; k++)
+    {
+      const int j = (k + shift) % DDS_HANDS;
       cparam.solvedp->solvedBoard[i].score[k] = 
-        cparam.solvedp->solvedBoard[ crossrefs[i] ].score[k];
-    END_THREAD_TIMER(thrId);
+        cparam.solvedp->solvedBoard[ref].score[j];
+    }
   }
 }
 
 
 void CalcChunkCommon(
+  EngineState& eng,
   const int thrId)
 {
   // Solves each deal and strain for all four declarers.
+  const paramType& cparam = eng.calc.param;
+  Scheduler& scheduler = eng.scheduler;
   vector<futureTricks> fut;
   fut.resize(static_cast<unsigned>(cparam.noOfBoards));
 
@@ -109,44 +230,54 @@ void CalcChunkCommon(
 
     if (st.repeatOf != -1)
     {
+      // The repeat may be a rotation of the deal it repeats, as in
+      // CopyCalcSingle.
       START_THREAD_TIMER(thrId);
+      const int shift = scheduler.Rotation(index) -
+        scheduler.Rotation(st.repeatOf) + DDS_HANDS;
+
       for (int k = 0; k < DDS_HANDS; k++)
       {
         cparam.bop->deals[index].first = k;
 
         cparam.solvedp->solvedBoard[index].score[k] =
-          cparam.solvedp->solvedBoard[ st.repeatOf ].score[k];
+          cparam.solvedp->solvedBoard[ st.repeatOf ].score[
+            (k + shift) % DDS_HANDS];
       }
       END_THREAD_TIMER(thrId);
       continue;
     }
 
-    CalcSingleCommon(thrId, index);
+    CalcSingleCommon(eng, thrId, index);
   }
 }
 
 
 int CalcAllBoardsN(
+  EngineState& eng,
   boards * bop,
   solvedBoards * solvedp)
 {
-  cparam.error = 0;
-
   if (bop->noOfBoards > MAXNOOFBOARDS)
     return RETURN_TOO_MANY_BOARDS;
 
+  lock_guard<mutex> lk(eng.runMtx);
+  paramType& cparam = eng.calc.param;
+  Scheduler& scheduler = eng.scheduler;
+
+  cparam.error = 0;
   cparam.bop = bop;
   cparam.solvedp = solvedp;
   cparam.noOfBoards = bop->noOfBoards;
 
   scheduler.RegisterRun(DDS_RUN_CALC, * bop);
-  sysdep.RegisterRun(DDS_RUN_CALC, * bop);
+  eng.sysdep.RegisterRun(DDS_RUN_CALC, * bop);
 
   for (int k = 0; k < MAXNOOFBOARDS; k++)
     solvedp->solvedBoard[k].cards = 0;
 
   START_BLOCK_TIMER;
-  int retRun = sysdep.RunThreads();
+  int retRun = eng.sysdep.RunThreads();
   END_BLOCK_TIMER;
 
   if (retRun != RETURN_NO_FAULT)
@@ -169,6 +300,15 @@ int CalcAllBoardsN(
 int STDCALL CalcDDtable(
   ddTableDeal tableDeal,
   ddTableResults * tablep)
+{
+  return CalcDDtable(DefaultEngine(), tableDeal, tablep);
+}
+
+
+int CalcDDtable(
+  EngineState& eng,
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep)
 {
   deal dl;
   boards bo;
@@ -197,7 +337,7 @@ int STDCALL CalcDDtable(
     ind++;
   }
 
-  int res = CalcAllBoardsN(&bo, &solved);
+  int res = CalcAllBoardsN(eng, &bo, &solved);
   if (res != 1)
     return res;
 
@@ -217,12 +357,253 @@ int STDCALL CalcDDtable(
 }
 
 
+// The 20 entries of one table as separate jobs, for CalcDDtableParallel.
+// A thread keeps to one strain while it has declarers left, so that
+// the later declarers reuse its TT as in CalcSingleDeal. A thread
+// without one takes a strain that no thread works on yet, and after
+// that helps with a strain that still has most of its declarers left.
+
+static int TableHint(
+  const tableParamType& tparam,
+  const int strain,
+  const int first)
+{
+  // The partner of the leader usually makes as many tricks on lead,
+  // and an opponent the rest.
+  const int partner = tparam.score[strain][(first + 2) % DDS_HANDS];
+  if (partner >= 0)
+    return partner;
+
+  for (int k = 1; k < DDS_HANDS; k += 2)
+  {
+    const int opp = tparam.score[strain][(first + k) % DDS_HANDS];
+    if (opp >= 0)
+      return 13 - opp;
+  }
+
+  // As in SolveBoard.
+  return 7 - (first & 0x1);
+}
+
+
+static int SolveTableEntry(
+  SolverContext& ctx,
+  tableParamType& tparam,
+  const int thrId,
+  const int strain,
+  const int first)
+{
+  deal dl = tparam.dl;
+  dl.trump = strain;
+  dl.first = first;
+
+  futureTricks fut;
+  const unsigned t = static_cast<unsigned>(thrId);
+  if (tparam.lastStrain[t] != strain)
+  {
+    // Target 0 scores nothing, but sets up the deal tables and the TT
+    // of the context for the SolveSameBoard calls of this strain.
+    const int ret = SolveBoardInternal(ctx, dl, 0, 1, 1, &fut);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+    ctx.ResetBestMovesLite();
+    tparam.lastStrain[t] = strain;
+  }
+
+  const int ret = SolveSameBoard(ctx, dl, &fut,
+    TableHint(tparam, strain, first));
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  tparam.score[strain][first] = fut.score[0];
+  return RETURN_NO_FAULT;
+}
+
+
+static int PickTableStrain(const tableParamType& tparam)
+{
+  // Fewest workers first, then most declarers left. Notrump is last in
+  // the strain order but is tried first, as it usually takes longest.
+  int best = -1, bestWorkers = 0, bestLeft = 0;
+  for (int tr = DDS_STRAINS-1; tr >= 0; tr--)
+  {
+    // A cold solve of a later declarer costs about as much as the
+    // owner's warm solves of two, so only help where more are left.
+    const int left = DDS_HANDS - tparam.next[tr];
+    const int workers = tparam.workers[tr];
+    if (left <= 0 || (workers > 0 && left < 3))
+      continue;
+
+    if (best == -1 || workers < bestWorkers ||
+        (workers == bestWorkers && left > bestLeft))
+    {
+      best = tr;
+      bestWorkers = workers;
+      bestLeft = left;
+    }
+  }
+  return best;
+}
+
+
+static void CalcTableCommon(
+  EngineState& eng,
+  const int thrId)
+{
+  SolverContext& ctx = eng.contextPool.Get(static_cast<unsigned>(thrId));
+  tableParamType& tparam = eng.calc.table;
+  int strain = -1;
+
+  while (tparam.error == RETURN_NO_FAULT)
+  {
+    int first = (strain == -1 ? DDS_HANDS : tparam.next[strain]++);
+    if (first >= DDS_HANDS)
+    {
+      if (strain != -1)
+        tparam.workers[strain]--;
+
+      strain = PickTableStrain(tparam);
+      if (strain == -1)
+        break;
+
+      tparam.workers[strain]++;
+      first = tparam.next[strain]++;
+      if (first >= DDS_HANDS)
+        continue;
+    }
+
+    const int ret = SolveTableEntry(ctx, tparam, thrId, strain, first);
+    if (ret != RETURN_NO_FAULT)
+    {
+      int expected = RETURN_NO_FAULT;
+      tparam.error.compare_exchange_strong(expected, ret);
+    }
+  }
+}
+
+
+int STDCALL CalcDDtableParallel(
+  ddTableDeal tableDeal,
+  ddTableResults * tablep)
+{
+  return CalcDDtableParallel(DefaultEngine(), tableDeal, tablep);
+}
+
+
+int CalcDDtableParallel(
+  EngineState& eng,
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep)
+{
+  const int nthreads = eng.sysdep.GetNumThreads();
+  if (eng.contextPool.NumThreads() < static_cast<unsigned>(nthreads))
+    return RETURN_THREAD_INDEX;
+
+  if (nthreads == 1)
+    return CalcDDtable(eng, tableDeal, tablep);
+
+  lock_guard<mutex> lk(eng.runMtx);
+  tableParamType& tparam = eng.calc.table;
+  deal& dl = tparam.dl;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      dl.remainCards[h][s] = tableDeal.cards[h][s];
+
+  for (int k = 0; k <= 2; k++)
+  {
+    dl.currentTrickRank[k] = 0;
+    dl.currentTrickSuit[k] = 0;
+  }
+  dl.first = 0;
+
+  // A strain in the result cache needs no solves. Invalid cards get
+  // their error, never a cached result.
+  const bool useCache = eng.contextPool.Get(0).config().useResultCache &&
+    calcCache.Capacity() > 0;
+  if (useCache)
+  {
+    dl.trump = 0;
+    const int ret = BoardRangeChecks(dl, -1, 1, 1);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+  }
+  bool cached[DDS_STRAINS];
+  bool any = false;
+
+  for (int tr = 0; tr < DDS_STRAINS; tr++)
+  {
+    dl.trump = tr;
+    int score[DDS_HANDS];
+    cached[tr] = useCache && LookupCalcCache(dl, -1, 1, 1, score);
+    any = any || ! cached[tr];
+
+    for (int first = 0; first < DDS_HANDS; first++)
+      tparam.score[tr][first] = (cached[tr] ? score[first] : -1);
+    tparam.next[tr] = (cached[tr] ? DDS_HANDS : 0);
+    tparam.workers[tr] = 0;
+  }
+
+  if (any)
+  {
+    tparam.lastStrain.assign(static_cast<unsigned>(nthreads), -1);
+    tparam.error = RETURN_NO_FAULT;
+
+    int ret = eng.sysdep.RunThreads(CalcTableCommon);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+    if (tparam.error != RETURN_NO_FAULT)
+      return tparam.error;
+  }
+
+  for (int tr = 0; tr < DDS_STRAINS; tr++)
+  {
+    int score[DDS_HANDS];
+    for (int first = 0; first < DDS_HANDS; first++)
+    {
+      score[first] = tparam.score[tr][first];
+      tablep->resTable[tr][ rho[first] ] = 13 - score[first];
+    }
+
+    if (useCache && ! cached[tr])
+    {
+      dl.trump = tr;
+      StoreCalcCache(dl, -1, 1, 1, score);
+    }
+  }
+  return RETURN_NO_FAULT;
+}
+
+
+int STDCALL CalcDDtablePBNParallel(
+  ddTableDealPBN tableDealPBN,
+  ddTableResults * tablep)
+{
+  ddTableDeal tableDeal;
+  if (ConvertFromPBN(tableDealPBN.cards, tableDeal.cards) != 1)
+    return RETURN_PBN_FAULT;
+
+  return CalcDDtableParallel(tableDeal, tablep);
+}
+
 int STDCALL CalcAllTables(
   ddTableDeals * dealsp,
   int mode,
   int trumpFilter[5],
   ddTablesRes * resp,
   allParResults * presp)
+{
+  return CalcAllTables(DefaultEngine(), * dealsp, mode, trumpFilter,
+    resp, presp);
+}
+
+
+int CalcAllTables(
+  EngineState& eng,
+  const ddTableDeals& deals,
+  const int mode,
+  const int trumpFilter[DDS_STRAINS],
+  ddTablesRes * resp,
+  allParResults * presp)
 {
   /* mode = 0: par calculation, vulnerability None
      mode = 1: par calculation, vulnerability All
@@ -247,14 +628,14 @@ int STDCALL CalcAllTables(
   if (!okey)
     return RETURN_NO_SUIT;
 
-  if (count * dealsp->noOfTables > MAXNOOFTABLES * DDS_STRAINS)
+  if (count * deals.noOfTables > MAXNOOFTABLES * DDS_STRAINS)
     return RETURN_TOO_MANY_TABLES;
 
   int ind = 0;
   int lastIndex = 0;
   resp->noOfBoards = 0;
 
-  for (int m = 0; m < dealsp->noOfTables; m++)
+  for (int m = 0; m < deals.noOfTables; m++)
   {
     for (int tr = DDS_STRAINS-1; tr >= 0; tr--)
     {
@@ -264,7 +645,7 @@ int STDCALL CalcAllTables(
       for (int h = 0; h < DDS_HANDS; h++)
         for (int s = 0; s < DDS_SUITS; s++)
           bo.deals[ind].remainCards[h][s] =
-            dealsp->deals[m].cards[h][s];
+            deals.deals[m].cards[h][s];
 
       bo.deals[ind].trump = tr;
 
@@ -284,13 +665,13 @@ int STDCALL CalcAllTables(
 
   bo.noOfBoards = lastIndex + 1;
 
-  int res = CalcAllBoardsN(&bo, &solved);
+  int res = CalcAllBoardsN(eng, &bo, &solved);
   if (res != 1)
     return res;
 
   resp->noOfBoards += 4 * solved.noOfBoards;
 
-  for (int m = 0; m < dealsp->noOfTables; m++)
+  for (int m = 0; m < deals.noOfTables; m++)
   {
     for (int strainIndex = 0; strainIndex < count; strainIndex++)
     {
@@ -310,7 +691,7 @@ int STDCALL CalcAllTables(
   if ((mode > -1) && (mode < 4) && (count == 5))
   {
     /* Calculate par */
-    for (int k = 0; k < dealsp->noOfTables; k++)
+    for (int k = 0; k < deals.noOfTables; k++)
     {
       res = Par(&(resp->results[k]), &(presp->presults[k]), mode);
       /* vulnerable 0: None 1: Both 2: NS 3: EW */
@@ -354,13 +735,68 @@ int STDCALL CalcDDtablePBN(
 }
 
 
+static void DetectCalcDuplicates(
+  const boards& bds,
+  vector<int>& uniques,
+  vector<int>& crossrefs,
+  vector<int>& calcRotations)
+{
+  // As DetectSolveDuplicates, but on the canonical deals: boards that
+  // only differ by a rotation of the seats or by the names of the
+  // non-trump suits are solved once. The leader does not matter, as
+  // all four are solved.
+
+  const unsigned nu = static_cast<unsigned>(bds.noOfBoards);
+
+  uniques.clear();
+  crossrefs.resize(nu);
+  calcRotations.resize(nu);
+
+  vector<deal> canon(nu);
+  unordered_map<dealFingerprint, unsigned, dealFingerprintHash> seen;
+  seen.reserve(nu);
+
+  for (unsigned i = 0; i < nu; i++)
+  {
+    crossrefs[i] = -1;
+
+    dealSymmetry sym;
+    CanonicalDeal(bds.deals[i], canon[i], sym);
+    canon[i].first = 0;
+    calcRotations[i] = sym.rotation;
+
+    const dealFingerprint fp = DealFingerprint(
+      canon[i], bds.target[i], bds.solutions[i], bds.mode[i]);
+
+    auto it = seen.find(fp);
+    if (it == seen.end())
+      seen.emplace(fp, i);
+    else if (SameCardsAndStrain(canon[it->second], canon[i]))
+    {
+      crossrefs[i] = static_cast<int>(it->second);
+      continue;
+    }
+
+    uniques.push_back(static_cast<int>(i));
+  }
+}
+
+
 void DetectCalcDuplicates(
   const boards& bds,
   vector<int>& uniques,
   vector<int>& crossrefs)
 {
-  // Could save a little bit of time with a dedicated checker that
-  // only looks at the cards.
-  return DetectSolveDuplicates(bds, uniques, crossrefs);
+  vector<int> rotations;
+  DetectCalcDuplicates(bds, uniques, crossrefs, rotations);
 }
 
+
+void DetectCalcDuplicates(
+  EngineState& eng,
+  const boards& bds,
+  vector<int>& uniques,
+  vector<int>& crossrefs)
+{
+  DetectCalcDuplicates(bds, uniques, crossrefs, eng.calc.rotations);
+}
@@ -10,12 +10,70 @@
 #ifndef DDS_CALCTABLES_H
 #define DDS_CALCTABLES_H
 
+#include <atomic>
 #include <vector>
 
 #include <api/dll.h>
+#include <api/dds.h>
 
 using namespace std;
 
+class SolverContext;
+struct EngineState;
+
+
+// The 20 entries of one table as separate jobs, for CalcDDtableParallel.
+
+struct tableParamType
+{
+  deal dl;
+  // The next declarer of each strain, up to DDS_HANDS.
+  atomic<int> next[DDS_STRAINS];
+  // Threads working on each strain.
+  atomic<int> workers[DDS_STRAINS];
+  atomic<int> error;
+  // Tricks for the side on lead, or -1 while not known.
+  atomic<int> score[DDS_STRAINS][DDS_HANDS];
+  // The strain that each thread last set up its context for.
+  vector<int> lastStrain;
+};
+
+// The table calculations of one engine that use all of its threads.
+
+struct calcStateType
+{
+  paramType param;
+  // Rotation of each board onto its canonical deal, from the last
+  // DetectCalcDuplicates and used by CopyCalcSingle.
+  vector<int> rotations;
+  tableParamType table;
+};
+
+
+/**
+ * @brief Solve one deal and strain for all four declarers in a context.
+ *
+ * score[k] holds the tricks for the side on lead when hand k leads.
+ * Failing solves leave their score untouched. The result is looked up
+ * in and stored to the table result cache unless the context opts out,
+ * keyed by the canonical deal (see CanonicalDeal), so that rotated and
+ * suit-permuted copies of a deal share an entry.
+ *
+ * @param ctx Solver context of the calling thread.
+ * @param dl Deal with the strain set; first is overwritten.
+ * @param target Target number of tricks.
+ * @param solutions Solution mode.
+ * @param mode Analysis mode.
+ * @param score Output scores, one per declarer.
+ * @return RETURN_NO_FAULT, or the error code of a failing solve.
+ */
+int CalcSingleDeal(
+  SolverContext& ctx,
+  deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  int score[DDS_HANDS]);
 
 /**
  * @brief Perform common single-board calculations for double dummy analysis.
@@ -26,6 +84,7 @@ using namespace std;
  * @param bno Board number to analyze.
  */
 void CalcSingleCommon(
+  EngineState& eng,
   const int thrID,
   const int bno);
 
@@ -37,6 +96,7 @@ void CalcSingleCommon(
  * @param crossrefs Vector of cross-reference indices mapping boards to be copied.
  */
 void CopyCalcSingle(
+  EngineState& eng,
   const vector<int>& crossrefs);
 
 /**
@@ -47,12 +107,15 @@ void CopyCalcSingle(
  * @param thrId Thread identifier for parallel execution.
  */
 void CalcChunkCommon(
+  EngineState& eng,
   const int thrId);
 
 /**
  * @brief Detect duplicate board calculations and build cross-reference maps.
  *
  * Identifies unique and duplicate boards in a batch, populating vectors for unique indices and cross-references.
+ * Boards that only differ by a rotation of the seats or by the names of the non-trump suits count as duplicates;
+ * CopyCalcSingle rotates their scores back.
  *
  * @param bds Boards to analyze for duplicates.
  * @param uniques Output vector of indices for unique boards.
@@ -63,4 +126,37 @@ void DetectCalcDuplicates(
   vector<int>& uniques,
   vector<int>& crossrefs);
 
+// As above, keeping the rotations for CopyCalcSingle in eng.
+void DetectCalcDuplicates(
+  EngineState& eng,
+  const boards& bds,
+  vector<int>& uniques,
+  vector<int>& crossrefs);
+
+// The table calculations behind the C interface, on the threads of
+// eng. Each holds the run lock of eng while it runs.
+
+int CalcAllBoardsN(
+  EngineState& eng,
+  boards * bop,
+  solvedBoards * solvedp);
+
+int CalcDDtable(
+  EngineState& eng,
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep);
+
+int CalcDDtableParallel(
+  EngineState& eng,
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep);
+
+int CalcAllTables(
+  EngineState& eng,
+  const ddTableDeals& deals,
+  const int mode,
+  const int trumpFilter[DDS_STRAINS],
+  ddTablesRes * resp,
+  allParResults * presp);
+
 #endif
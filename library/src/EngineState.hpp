@@ -0,0 +1,82 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_ENGINESTATE_H
+#define DDS_ENGINESTATE_H
+
+#include <mutex>
+
+#include <system/System.hpp>
+#include <system/Memory.hpp>
+#include <system/Scheduler.hpp>
+#include <solver_context/ContextPool.hpp>
+#include "SolveBoard.hpp"
+#include "CalcTables.hpp"
+#include "PlayAnalyser.hpp"
+#include "SolveStream.hpp"
+
+using namespace std;
+
+
+/**
+ * @brief Everything that the functions on all solver threads work on.
+ *
+ * Each engine has its own threads, scheduler and per-thread solver
+ * contexts, and the state of the run in progress on them. The System
+ * callbacks and the batch, parallel and stream functions get it passed
+ * in, so different engines can run side by side. The default engine,
+ * behind the C interface, is built on the process-wide sysdep, memory,
+ * scheduler and contextPool. The result caches are shared by all.
+ *
+ * Everything that uses all threads of an engine holds runMtx while it
+ * runs, so a second call on the same engine waits for the first.
+ * EngineState is an internal component and not part of the public API.
+ */
+struct EngineState
+{
+  System& sysdep;
+  Memory& memory;
+  Scheduler& scheduler;
+  ContextPool& contextPool;
+
+  mutex runMtx;
+
+  solveStateType solve;
+  calcStateType calc;
+  playStateType play;
+  streamParamType stream;
+
+  EngineState(
+    System& sys,
+    Memory& mem,
+    Scheduler& sched,
+    ContextPool& pool);
+
+  ~EngineState();
+
+  EngineState(const EngineState&) = delete;
+  EngineState& operator=(const EngineState&) = delete;
+};
+
+// The engine of the C interface.
+EngineState& DefaultEngine();
+
+// A System with the callbacks of the batch functions.
+System MakeSystem();
+
+// SetResources and FreeMemory for one engine. Both wait for a run on
+// the engine to finish.
+void SetEngineResources(
+  EngineState& eng,
+  const int maxMemoryMB,
+  const int maxThreadsIn);
+
+void FreeEngineMemory(EngineState& eng);
+
+#endif
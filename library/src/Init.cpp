@@ -9,21 +9,31 @@
 
 
 #include "Init.hpp"
+#include "EngineState.hpp"
+#include <algorithm>
 #include <cstring>
+#include <bit>
+#include <vector>
 #include <system/System.hpp>
 #include <system/Scheduler.hpp>
 #include <system/ThreadMgr.hpp>
+#include <system/ResultCache.hpp>
 #include <utility/debug.h>
 #include <utility/Constants.h>
 #include <lookup_tables/LookupTables.hpp>
+#include <lookup_tables/CardHolders.hpp>
 #include "SolveBoard.hpp"
 #include "CalcTables.hpp"
 #include "PlayAnalyser.hpp"
 // Order matters: include TransTable to ensure complete type for virtual calls
 #include <trans_table/TransTable.hpp>
+#include <trans_table/TransTableShared.hpp>
 #include <solver_context/SolverContext.hpp>
+#include <solver_context/ContextPool.hpp>
 
-System sysdep(
+System MakeSystem()
+{
+  return System(
     &SolveChunkCommon,
     &CalcChunkCommon,
     &PlayChunkCommon,
@@ -36,16 +46,61 @@ System sysdep(
     &CopySolveSingle,
     &CopyCalcSingle,
     &CopyPlaySingle
-);
+  );
+}
+
+System sysdep = MakeSystem();
 Memory memory;
 Scheduler scheduler;
+ContextPool contextPool;
+ResultCache solveCache;
+ResultCache calcCache;
+
+// The settings that all engines follow, and the list of engines that
+// SetSharedTTSize switches. Whoever also needs the run lock of an
+// engine takes settingsMtx first.
+mutex settingsMtx;
+vector<EngineState *> engines;
+
+// Large (private) or Shared, see SetSharedTTSize.
+TTKind largeTTKind = TTKind::Large;
+
+EngineState defaultEngine(sysdep, memory, scheduler, contextPool);
 
 void InitDebugFiles();
+void StopAsync();
 
 
 int _initialized = 0;
 
 
+EngineState::EngineState(
+  System& sys,
+  Memory& mem,
+  Scheduler& sched,
+  ContextPool& pool)
+  : sysdep(sys), memory(mem), scheduler(sched), contextPool(pool)
+{
+  sysdep.SetOwner(* this);
+
+  lock_guard<mutex> lk(settingsMtx);
+  engines.push_back(this);
+}
+
+
+EngineState::~EngineState()
+{
+  lock_guard<mutex> lk(settingsMtx);
+  engines.erase(find(engines.begin(), engines.end(), this));
+}
+
+
+EngineState& DefaultEngine()
+{
+  return defaultEngine;
+}
+
+
 /**
  * @brief Set the maximum number of threads used by the solver.
  *
@@ -68,10 +123,25 @@ void STDCALL SetResources(
   int maxMemoryMB,
   int maxThreadsIn)
 {
+  SetEngineResources(defaultEngine, maxMemoryMB, maxThreadsIn);
+}
+
+
+void SetEngineResources(
+  EngineState& eng,
+  const int maxMemoryMB,
+  const int maxThreadsIn)
+{
+  // settingsMtx also covers the process-wide state below, which
+  // runMtx alone would not guard against another engine: the
+  // lookup tables behind _initialized, and the ThreadMgr reset.
+  lock_guard<mutex> slk(settingsMtx);
+  lock_guard<mutex> lk(eng.runMtx);
+
   // Figure out system resources.
   int ncores;
   unsigned long long kilobytesFree;
-  sysdep.GetHardware(ncores, kilobytesFree);
+  eng.sysdep.GetHardware(ncores, kilobytesFree);
 
   // Memory usage will be limited to the lower of:
   // - maxMemoryMB + 30% (if given; statistically this works out)
@@ -94,9 +164,9 @@ void STDCALL SetResources(
   // - Otherwise the lower of maxThreads and ncores
 
   int thrMax;
-  if (sysdep.IsSingleThreaded())
+  if (eng.sysdep.IsSingleThreaded())
     thrMax = 1;
-  else if (sysdep.IsIMPL() || maxThreadsIn <= 0)
+  else if (eng.sysdep.IsIMPL() || maxThreadsIn <= 0)
     thrMax = ncores;
   else
     thrMax = min(maxThreadsIn, ncores);
@@ -133,20 +203,35 @@ void STDCALL SetResources(
     noOfSmallThreads = thrMax - noOfLargeThreads;
   }
 
-  sysdep.RegisterParams(noOfThreads, memMaxMB);
+  eng.sysdep.RegisterParams(noOfThreads, memMaxMB);
+  eng.sysdep.StartThreads();
 
-  scheduler.RegisterThreads(noOfThreads);
+  eng.scheduler.RegisterThreads(noOfThreads);
 
   // Clear the thread memory and fill it up again.
-  memory.Resize(0, DDS_TT_SMALL, 0, 0);
+  eng.memory.Resize(0, DDS_TT_SMALL, 0, 0);
   if (noOfLargeThreads > 0)
-    memory.Resize(static_cast<unsigned>(noOfLargeThreads),
+    eng.memory.Resize(static_cast<unsigned>(noOfLargeThreads),
       DDS_TT_LARGE, THREADMEM_LARGE_DEF_MB, THREADMEM_LARGE_MAX_MB);
   if (noOfSmallThreads > 0)
-    memory.Resize(static_cast<unsigned>(noOfThreads),
+    eng.memory.Resize(static_cast<unsigned>(noOfThreads),
       DDS_TT_SMALL, THREADMEM_SMALL_DEF_MB, THREADMEM_SMALL_MAX_MB);
 
-  ThreadMgr::instance().Reset(noOfThreads);
+  // The solver contexts follow the same layout: large threads first,
+  // then small ones. They stay alive until the next SetResources call.
+  eng.contextPool.Resize(0, TTKind::Small, 0, 0);
+  if (noOfLargeThreads > 0)
+    eng.contextPool.Resize(static_cast<unsigned>(noOfLargeThreads),
+      largeTTKind, THREADMEM_LARGE_DEF_MB, THREADMEM_LARGE_MAX_MB);
+  if (noOfSmallThreads > 0)
+    eng.contextPool.Resize(static_cast<unsigned>(noOfThreads),
+      TTKind::Small, THREADMEM_SMALL_DEF_MB, THREADMEM_SMALL_MAX_MB);
+
+  // Only the IMPL backends use ThreadMgr, and only the default engine
+  // may choose them (SolverEngine::SetThreading). So its runs, which
+  // reset ThreadMgr as well, cannot overlap this.
+  if (eng.sysdep.IsIMPL())
+    ThreadMgr::instance().Reset(noOfThreads);
 
   InitDebugFiles();
 
@@ -173,20 +258,14 @@ int STDCALL SetThreading(
 
 void InitDebugFiles()
 {
-#ifdef DDS_SCHEDULER
-  InitFileScheduler();
-#endif
+  // The scheduler opens its own file in Scheduler::PrintTiming.
 }
 
 
 void CloseDebugFiles()
 {
-  for (unsigned thrId = 0; thrId < memory.NumThreads(); thrId++)
-  {
-  SolverContext tmp_ctx;
-  [[maybe_unused]] auto thrp = tmp_ctx.thread();
-  thrp->close_debug_files();
-  }
+  for (unsigned thrId = 0; thrId < contextPool.NumThreads(); thrId++)
+    contextPool.Get(thrId).thread()->close_debug_files();
 }
 
 
@@ -229,79 +308,44 @@ void SetDealTables(
   SolverContext& ctx)
 {
   auto thrp = ctx.thread();
-  unsigned int topBitRank = 1;
-  unsigned int topBitNo = 2;
-
-  // Initialization of the rel structure is inspired by
-  // a solution given by Thomas Andrews.
-
-  // rel[aggr].absRank[absolute rank][suit].hand is the hand
-  // (N = 0, E = 1 etc.) which holds the absolute rank in
-  // the suit characterized by aggr.
-  // rel[aggr].absRank[absolute rank][suit].rank is the
-  // relative rank of that card.
-
-  for (int s = 0; s < DDS_SUITS; s++)
-  {
-    for (int ord = 1; ord <= 13; ord++)
-    {
-      thrp->rel[0].absRank[ord][s].hand = -1;
-      thrp->rel[0].absRank[ord][s].rank = 0;
-    }
-  }
 
   // handLookup[suit][absolute rank] is the hand (N = 0 etc.)
   // holding the absolute rank in suit.
 
+  // held[suit] is the set of cards still out in suit. No later
+  // position of this deal can have any other card in that suit.
+
   int handLookup[DDS_SUITS][15];
+  unsigned short held[DDS_SUITS];
   for (int s = 0; s < DDS_SUITS; s++)
   {
-    for (int r = 14; r >= 2; r--)
-    {
+    held[s] = 0;
+    for (int r = 2; r <= 14; r++)
       handLookup[s][r] = 0;
-      for (int h = 0; h < DDS_HANDS; h++)
-      {
-        if (thrp->suit[h][s] & bitMapRank[r])
-        {
-          handLookup[s][r] = h;
-          break;
-        }
-      }
+
+    for (int h = 0; h < DDS_HANDS; h++)
+    {
+      const unsigned cards = thrp->suit[h][s];
+      held[s] |= static_cast<unsigned short>(cards);
+      for (unsigned c = cards; c != 0; c &= c - 1)
+        handLookup[s][std::countr_zero(c) + 2] = h;
     }
   }
 
   {
-    ctx.transTable()->init(handLookup);
+    ctx.transTable()->init_deal(handLookup, held);
   }
 
-  relRanksType * relp;
-  for (unsigned int aggr = 1; aggr < 8192; aggr++)
-  {
-    if (aggr >= (topBitRank << 1))
-    {
-      /* Next top bit */
-      topBitRank <<= 1;
-      topBitNo++;
-    }
-
-    thrp->rel[aggr] = thrp->rel[aggr ^ topBitRank];
-    relp = &thrp->rel[aggr];
+  // The holders replace the former rel[8192] table: the k-th highest
+  // card of any set of remaining cards is found from its bits (see
+  // abs_rank), so only the holder of each card depends on the deal.
 
-    int weight = count_table[aggr];
-    for (int c = weight; c >= 2; c--)
-    {
-      for (int s = 0; s < DDS_SUITS; s++)
-      {
-        relp->absRank[c][s].hand = relp->absRank[c - 1][s].hand;
-        relp->absRank[c][s].rank = relp->absRank[c - 1][s].rank;
-      }
-    }
-    for (int s = 0; s < DDS_SUITS; s++)
-    {
-      relp->absRank[1][s].hand =
-        static_cast<signed char>(handLookup[s][topBitNo]);
-      relp->absRank[1][s].rank = static_cast<char>(topBitNo);
-    }
+  for (int s = 0; s < DDS_SUITS; s++)
+  {
+    thrp->holders.hand[s][0] = -1;
+    thrp->holders.hand[s][1] = -1;
+    for (int r = 2; r <= 14; r++)
+      thrp->holders.hand[s][r] = static_cast<signed char>(handLookup[s][r]);
   }
 }
 
@@ -326,17 +370,19 @@ void InitWinners(
     startMovesBitMap[hand][suit] |= bitMapRank[rank];
   }
 
-  int aggr;
+  unsigned aggr;
   for (int s = 0; s < DDS_SUITS; s++)
   {
     aggr = 0;
     for (int h = 0; h < DDS_HANDS; h++)
       aggr |= startMovesBitMap[h][s] | thrp->suit[h][s];
 
-    posPoint.winner[s].rank = thrp->rel[aggr].absRank[1][s].rank;
-    posPoint.winner[s].hand = thrp->rel[aggr].absRank[1][s].hand;
-    posPoint.secondBest[s].rank = thrp->rel[aggr].absRank[2][s].rank;
-    posPoint.secondBest[s].hand = thrp->rel[aggr].absRank[2][s].hand;
+    const absRankType first = abs_rank(thrp->holders, aggr, 1, s);
+    const absRankType second = abs_rank(thrp->holders, aggr, 2, s);
+    posPoint.winner[s].rank = first.rank;
+    posPoint.winner[s].hand = first.hand;
+    posPoint.secondBest[s].rank = second.rank;
+    posPoint.secondBest[s].hand = second.hand;
   }
 }
 
@@ -404,6 +450,13 @@ void STDCALL GetDDSInfo(DDSInfo * info)
   ss << left << setw(9) << "Threading" <<
     setw(24) << right << strThreading << "\n";
 
+  resultCacheStats cs;
+  solveCache.GetStats(cs);
+  const string strCache = to_string(cs.hits) + " / " + 
+    to_string(cs.hits + cs.misses);
+  ss << left << setw(17) << "Result cache hits" <<
+    setw(16) << right << strCache << "\n";
+
   const string st = ss.str();
   strcpy(info->systemString, st.c_str());
 }
@@ -414,8 +467,68 @@ void STDCALL GetDDSInfo(DDSInfo * info)
  */
 void STDCALL FreeMemory()
 {
-  for (unsigned thrId = 0; thrId < memory.NumThreads(); thrId++)
-    memory.ReturnThread(thrId);
+  // The async requests run on the default engine.
+  StopAsync();
+  FreeEngineMemory(defaultEngine);
+
+  solveCache.Clear();
+  calcCache.Clear();
+}
+
+
+void FreeEngineMemory(EngineState& eng)
+{
+  lock_guard<mutex> lk(eng.runMtx);
+
+  for (unsigned thrId = 0; thrId < eng.memory.NumThreads(); thrId++)
+    eng.memory.ReturnThread(thrId);
+
+  for (unsigned thrId = 0; thrId < eng.contextPool.NumThreads(); thrId++)
+    eng.contextPool.ReturnThread(thrId);
+
+  eng.sysdep.StopThreads();
+}
+
+
+void STDCALL SetResultCacheSize(int maxEntries)
+{
+  const size_t n = (maxEntries > 0 ? static_cast<size_t>(maxEntries) : 0);
+  solveCache.SetCapacity(n);
+  calcCache.SetCapacity(n);
+}
+
+
+void STDCALL GetResultCacheStats(
+  resultCacheStats * solvep,
+  resultCacheStats * tablep)
+{
+  solveCache.GetStats(* solvep);
+  calcCache.GetStats(* tablep);
+}
+
+
+void STDCALL SetSharedTTSize(int megabytes)
+{
+  // The store is replaced under the threads of every engine, so the
+  // runs on all of them have to finish first.
+  lock_guard<mutex> lk(settingsMtx);
+  vector<unique_lock<mutex>> runs;
+  for (EngineState * eng: engines)
+    runs.emplace_back(eng->runMtx);
+
+  const TTKind from = largeTTKind;
+  largeTTKind = (megabytes > 0 ? TTKind::Shared : TTKind::Large);
+
+  // The contexts let go of the old store before it goes.
+  if (megabytes <= 0)
+    for (EngineState * eng: engines)
+      eng->contextPool.SwitchKind(from, largeTTKind);
+
+  SharedTTStore::instance().resize(megabytes);
+
+  if (megabytes > 0)
+    for (EngineState * eng: engines)
+      eng->contextPool.SwitchKind(from, largeTTKind);
 }
 
 void STDCALL ErrorMessage(int code, char line[80])
@@ -503,6 +616,12 @@ void STDCALL ErrorMessage(int code, char line[80])
     case RETURN_CHUNK_SIZE:
       strcpy(line, TEXT_CHUNK_SIZE);
       break;
+    case RETURN_TIMEOUT:
+      strcpy(line, TEXT_TIMEOUT);
+      break;
+    case RETURN_CANCELLED:
+      strcpy(line, TEXT_CANCELLED);
+      break;
     default:
       strcpy(line, "Not a DDS error code");
       break;
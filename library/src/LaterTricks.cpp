@@ -11,6 +11,7 @@
 
 #include "LaterTricks.hpp"
 #include <solver_context/SolverContext.hpp>
+#include <lookup_tables/CardHolders.hpp>
 
 
 /**
@@ -33,8 +34,9 @@ bool LaterTricksMIN(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
+  ThreadData * const thrp = sv.thread();
   
   const bool depth_ok = (depth >= 0 && depth < 50);
   if ((trump == DDS_NOTRUMP) || (tpos.winner[trump].rank == 0))
@@ -46,7 +48,7 @@ bool LaterTricksMIN(
       if (hh != -1)
       {
         if (static_cast<unsigned>(hh) < static_cast<unsigned>(DDS_HANDS) &&
-            ctx.search().nodeTypeStore(hh) == MAXNODE)
+            thrp->nodeTypeStore[hh] == MAXNODE)
           sum += max(tpos.length[hh][ss],
                      tpos.length[partner[hh]][ss]);
       }
@@ -69,7 +71,7 @@ bool LaterTricksMIN(
           if (depth_ok) tpos.winRanks[depth][ss] = 0;
           continue;
         }
-        else if (ctx.search().nodeTypeStore(win_hand) == MINNODE)
+        else if (thrp->nodeTypeStore[win_hand] == MINNODE)
         {
           if ((tpos.rankInSuit[partner[win_hand]][ss] == 0) &&
               (tpos.rankInSuit[lho[win_hand]][ss] == 0) &&
@@ -85,7 +87,7 @@ bool LaterTricksMIN(
       return false;
     }
   }
-  else if (ctx.search().nodeTypeStore(tpos.winner[trump].hand) == MINNODE)
+  else if (thrp->nodeTypeStore[tpos.winner[trump].hand] == MINNODE)
   {
     if ((tpos.length[hand][trump] == 0) &&
         (tpos.length[partner[hand]][trump] == 0))
@@ -117,7 +119,7 @@ bool LaterTricksMIN(
         return true;
 
       int r2 = tpos.secondBest[trump].rank;
-      if ((ctx.search().nodeTypeStore(hh) == MINNODE) && (r2 != 0))
+      if ((thrp->nodeTypeStore[hh] == MINNODE) && (r2 != 0))
       {
         if (tpos.length[hh][trump] > 1 ||
             tpos.length[partner[hh]][trump] > 1)
@@ -138,7 +140,7 @@ bool LaterTricksMIN(
     if (static_cast<unsigned>(hh) >= static_cast<unsigned>(DDS_HANDS))
       return true;
 
-    if ((ctx.search().nodeTypeStore(hh) != MINNODE) ||
+    if ((thrp->nodeTypeStore[hh] != MINNODE) ||
         (tpos.length[hh][trump] <= 1))
       return true;
 
@@ -156,27 +158,30 @@ bool LaterTricksMIN(
     else
     {
       unsigned short aggr = tpos.aggr[trump];
-      // Defensive check: rel[] is sized 8192 in ThreadData. If aggr
-      // is out of bounds we avoid a crash and return a conservative result.
+      // Defensive check: aggr indexes the 8192-entry rank tables. If
+      // it is out of bounds we avoid a crash and return a conservative
+      // result.
       if (aggr >= 8192u)
       {
         fprintf(stderr, "LaterTricksMIN: invalid aggr=%u (depth=%d)", aggr, depth);
         return true; // conservative fallback
       }
-  int h = ctx.thread()->rel[aggr].absRank[3][trump].hand;
+      const absRankType third =
+        abs_rank(sv.thread()->holders, aggr, 3, trump);
+      int h = third.hand;
       if (h == -1)
         return true;
 
       if (static_cast<unsigned>(h) >= static_cast<unsigned>(DDS_HANDS))
         return true;
 
-      if ((ctx.search().nodeTypeStore(h) == MINNODE) &&
+      if ((thrp->nodeTypeStore[h] == MINNODE) &&
           ((tpos.tricksMAX + (depth >> 2)) < target))
       {
         for (int ss = 0; ss < DDS_SUITS; ss++)
           if (depth_ok) tpos.winRanks[depth][ss] = 0;
         if (depth_ok) tpos.winRanks[depth][trump] = bitMapRank[
-          static_cast<int>(static_cast<unsigned char>(ctx.thread()->rel[aggr].absRank[3][trump].rank)) ];
+          static_cast<int>(static_cast<unsigned char>(third.rank)) ];
         return false;
       }
     }
@@ -205,8 +210,9 @@ bool LaterTricksMAX(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
+  ThreadData * const thrp = sv.thread();
   
   const bool depth_ok = (depth >= 0 && depth < 50);
   if ((trump == DDS_NOTRUMP) || (tpos.winner[trump].rank == 0))
@@ -218,7 +224,7 @@ bool LaterTricksMAX(
       if (hh != -1)
       {
         if (static_cast<unsigned>(hh) < static_cast<unsigned>(DDS_HANDS) &&
-            ctx.search().nodeTypeStore(hh) == MINNODE)
+            thrp->nodeTypeStore[hh] == MINNODE)
           sum += max(tpos.length[hh][ss],
                      tpos.length[partner[hh]][ss]);
       }
@@ -240,7 +246,7 @@ bool LaterTricksMAX(
           if (depth_ok) tpos.winRanks[depth][ss] = 0;
           continue;
         }
-        else if (ctx.search().nodeTypeStore(win_hand) == MAXNODE)
+        else if (thrp->nodeTypeStore[win_hand] == MAXNODE)
         {
           if ((tpos.rankInSuit[partner[win_hand]][ss] == 0) &&
               (tpos.rankInSuit[lho[win_hand]][ss] == 0) &&
@@ -257,7 +263,7 @@ bool LaterTricksMAX(
       return true;
     }
   }
-  else if (ctx.search().nodeTypeStore(tpos.winner[trump].hand) == MAXNODE)
+  else if (thrp->nodeTypeStore[tpos.winner[trump].hand] == MAXNODE)
   {
     if ((tpos.length[hand][trump] == 0) &&
         (tpos.length[partner[hand]][trump] == 0))
@@ -289,7 +295,7 @@ bool LaterTricksMAX(
       if (static_cast<unsigned>(hh) >= static_cast<unsigned>(DDS_HANDS))
         return false;
 
-      if ((ctx.search().nodeTypeStore(hh) == MAXNODE) &&
+      if ((thrp->nodeTypeStore[hh] == MAXNODE) &&
           (tpos.secondBest[trump].rank != 0))
       {
         if (((tpos.length[hh][trump] > 1) ||
@@ -314,7 +320,7 @@ bool LaterTricksMAX(
     if (static_cast<unsigned>(hh) >= static_cast<unsigned>(DDS_HANDS))
       return false;
 
-    if ((ctx.search().nodeTypeStore(hh) != MAXNODE) ||
+    if ((thrp->nodeTypeStore[hh] != MAXNODE) ||
         (tpos.length[hh][trump] <= 1))
       return false;
 
@@ -332,26 +338,28 @@ bool LaterTricksMAX(
     else
     {
       unsigned short aggr = tpos.aggr[trump];
-      // Defensive check mirroring LaterTricksMIN: ThreadData::rel has 8192 entries.
+      // Defensive check mirroring LaterTricksMIN.
       if (aggr >= 8192u)
       {
         fprintf(stderr, "LaterTricksMAX: invalid aggr=%u (depth=%d)\n", aggr, depth);
         return false; // conservative fallback for MAX
       }
-  int h = ctx.thread()->rel[aggr].absRank[3][trump].hand;
+      const absRankType third =
+        abs_rank(sv.thread()->holders, aggr, 3, trump);
+      int h = third.hand;
       if (h == -1)
         return false;
 
       if (static_cast<unsigned>(h) >= static_cast<unsigned>(DDS_HANDS))
         return false;
 
-      if ((ctx.search().nodeTypeStore(h) == MAXNODE) &&
+      if ((thrp->nodeTypeStore[h] == MAXNODE) &&
           ((tpos.tricksMAX + 1) >= target))
       {
         for (int ss = 0; ss < DDS_SUITS; ss++)
           if (depth_ok) tpos.winRanks[depth][ss] = 0;
         if (depth_ok) tpos.winRanks[depth][trump] = bitMapRank[
-          static_cast<int>(static_cast<unsigned char>(ctx.thread()->rel[aggr].absRank[3][trump].rank)) ];
+          static_cast<int>(static_cast<unsigned char>(third.rank)) ];
         return true;
       }
     }
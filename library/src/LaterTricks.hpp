@@ -20,7 +20,7 @@ bool LaterTricksMIN(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 bool LaterTricksMAX(
   pos& tpos,
@@ -28,6 +28,6 @@ bool LaterTricksMAX(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 #endif
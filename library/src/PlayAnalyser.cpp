@@ -9,11 +9,17 @@
 
 #include "PlayAnalyser.hpp"
 #include "SolverIF.hpp"
+#include "EngineState.hpp"
 #include <system/System.hpp>
 #include <system/Memory.hpp>
 #include <system/Scheduler.hpp>
 #include <PBN.hpp>
 #include <solver_context/SolverContext.hpp>
+#include <solver_context/ContextPool.hpp>
+#include <lookup_tables/LookupTables.hpp>
+
+#include <atomic>
+#include <cmath>
 
 using namespace std;
 
@@ -26,20 +32,218 @@ using namespace std;
   ofstream fout;
 #endif
 
-struct playparamType
+
+// Trick winner, next player and search hint after one more card.
+static void AdvanceRun(
+  playRunType& run,
+  const int suit,
+  const int rr)
+{
+  deal& dl = run.dl;
+
+  /* Keep track of the winner of the trick so far */
+  if (run.card == 1)
+  {
+    run.leadSuit = suit;
+    run.bestCard = rr;
+    run.bestSuit = suit;
+    run.bestPlayer = dl.first;
+    run.trumpPlayed = (suit == dl.trump);
+  }
+  else if (suit == dl.trump)
+  {
+    if (! run.trumpPlayed || rr > run.bestCard)
+    {
+      run.bestCard = rr;
+      run.bestSuit = suit;
+      run.bestPlayer = run.player;
+      run.trumpPlayed = true;
+    }
+  }
+  else if (! run.trumpPlayed && suit == run.bestSuit && rr > run.bestCard)
+  {
+    run.bestCard = rr;
+    run.bestPlayer = run.player;
+  }
+
+  if (run.card == 4)
+  {
+    run.declarer += (run.bestPlayer % 2 == run.startSide ? 0 : 1);
+    run.remainder--;
+
+    if ((dl.first + run.bestPlayer) % 2 == 0)
+    {
+      run.hintDir = 0; // Same side leads again; lower bound
+      run.hint = run.remainder - run.fut.score[0];
+    }
+    else
+    {
+      run.hintDir = 1; // Other ("our") side wins trick; upper bound
+      run.hint = run.fut.score[0] - 1;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+      dl.currentTrickSuit[i] = 0;
+      dl.currentTrickRank[i] = 0;
+    }
+
+    dl.first = run.bestPlayer;
+    run.side = (dl.first % 2 == run.startSide ? 1 : 0);
+    run.player = dl.first;
+    run.trick++;
+    run.card = 1;
+  }
+  else
+  {
+    dl.currentTrickSuit[run.card - 1] = suit;
+    dl.currentTrickRank[run.card - 1] = rr;
+
+    run.player = (run.player + 1) % 4;
+    run.side = 1 - run.side;
+    run.hint = run.remainder - run.fut.score[0];
+    run.hintDir = 0;
+    run.card++;
+  }
+}
+
+
+// The state before the first card, without solving. The hint is not
+// set, as the solve of each position sets its own.
+static void PlaySetup(
+  const deal& dl,
+  playRunType& run)
+{
+  int cardCount = 0;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      cardCount += count_table[dl.remainCards[h][s] >> 2];
+
+  // As in SolveBoardInternal.
+  const int iniDepth = cardCount - 4;
+  run.dl = dl;
+  run.numTricks = ((iniDepth + 3) >> 2) + 1;
+  run.numCardsPlayed = ((48 - iniDepth) % 4) + 1;
+
+  run.fut.score[0] = 0;
+  run.hint = 0;
+  run.hintDir = 0;
+  run.trick = 1;
+  run.card = 1;
+  run.remainder = run.numTricks;
+  run.declarer = 0;
+  run.player = dl.first;
+  run.side = 1; /* defenders */
+  run.startSide = run.player % 2;
+  run.leadSuit = 0;
+  run.bestCard = 0;
+  run.bestSuit = 0;
+  run.bestPlayer = 0;
+  run.trumpPlayed = false;
+  run.tricks = 0;
+
+  // The cards that are already in the current trick.
+  for (int c = 0; c < run.numCardsPlayed - 1; c++)
+    AdvanceRun(run, dl.currentTrickSuit[c], dl.currentTrickRank[c]);
+}
+
+
+// Solves the current position of run from scratch.
+static int PlaySolve(
+  SolverContext& ctx,
+  playRunType& run)
 {
-  int noOfBoards;
-  playTracesBin * plp;
-  solvedPlays * solvedp;
-  int error;
-};
+  int ret = SolveBoardInternal(ctx, run.dl, -1, 1, 1, &run.fut);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  run.tricks = run.declarer + (run.side ?
+    run.remainder - run.fut.score[0] : run.fut.score[0]);
+  return RETURN_NO_FAULT;
+}
+
+
+// Removes the card from the hand to play and moves on, without
+// solving.
+static int PlayMove(
+  playRunType& run,
+  const int suit,
+  const int rank)
+{
+  if (run.trick > run.numTricks || suit < 0 || suit >= DDS_SUITS ||
+      rank < 2 || rank > 14)
+    return RETURN_PLAY_FAULT;
+
+  unsigned hold = static_cast<unsigned>(bitMapRank[rank] << 2);
+  if ((run.dl.remainCards[run.player][suit] & hold) == 0)
+    return RETURN_PLAY_FAULT;
+
+  run.dl.remainCards[run.player][suit] ^= hold;
+  AdvanceRun(run, suit, rank);
+  return RETURN_NO_FAULT;
+}
+
+
+int PlayStart(
+  SolverContext& ctx,
+  const deal& dl,
+  playRunType& run)
+{
+  PlaySetup(dl, run);
+  return PlaySolve(ctx, run);
+}
+
+
+int PlayCard(
+  SolverContext& ctx,
+  playRunType& run,
+  const int suit,
+  const int rank)
+{
+  const bool lastTrick = (run.trick == run.numTricks);
+  int ret = PlayMove(run, suit, rank);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  if (lastTrick)
+  {
+    // Every card is forced, so only the completed trick counts.
+    if (run.card == 1)
+      run.tricks = run.declarer;
+    return RETURN_NO_FAULT;
+  }
 
-paramType playparam;
-playparamType traceparam;
+  moveType move;
+  move.suit = suit;
+  move.rank = rank;
+  move.sequence = rank;
 
-extern System sysdep;
-extern Memory memory;
-extern Scheduler scheduler;
+  ret = AnalyseLaterBoard(ctx, run.dl.first, &move, run.hint,
+    run.hintDir, &run.fut);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  run.tricks = run.declarer + (run.side ?
+    run.remainder - run.fut.score[0] : run.fut.score[0]);
+  return RETURN_NO_FAULT;
+}
+
+
+// The number of positions that AnalysePlayBin reports: the start and
+// every card of the trace, but not those of the last trick.
+static int TraceLength(
+  const playTraceBin& play,
+  const playRunType& run)
+{
+  int last_trick = (play.number + 3) / 4;
+  int last_card = ((play.number + 3) % 4) + 1;
+  if (last_trick >= run.numTricks) 
+  {
+    last_trick = run.numTricks - 1;
+    last_card = 4;
+  }
+  return 4 * last_trick + last_card - 3 - (run.numCardsPlayed - 1);
+}
 
 
 /**
@@ -60,191 +264,65 @@ int STDCALL AnalysePlayBin(
   solvedPlay * solvedp,
   int thrId)
 {
-  if (! sysdep.ThreadOK(thrId))
-    return RETURN_THREAD_INDEX;
+  return AnalysePlayBin(DefaultEngine(), dl, play, solvedp, thrId);
+}
 
-  // Create an owned context for this analysis and obtain its ThreadData.
-  SolverContext outer_ctx;
-  auto thrp = outer_ctx.thread();
 
-  moveType move;
-  futureTricks fut;
+int AnalysePlayBin(
+  EngineState& eng,
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp,
+  const int thrId)
+{
+  if (! eng.sysdep.ThreadOK(thrId))
+    return RETURN_THREAD_INDEX;
 
-  int ret = SolveBoardInternal(outer_ctx, dl, -1, 1, 1, &fut);
+  // One context for the whole trace. Its transposition table is set
+  // up for this deal by the first solve, and every later card reuses
+  // what the earlier ones learned.
+  SolverContext ctx;
+  playRunType run;
+
+  int ret = PlayStart(ctx, dl, run);
   if (ret != RETURN_NO_FAULT)
     return ret;
-  SolverContext& ctx = outer_ctx;
-  const int iniDepth = ctx.search().iniDepth();
-  const int numTricks = ((iniDepth + 3) >> 2) + 1;
-  const int numCardsPlayed = ((48 - iniDepth) % 4) + 1;
 
-  int last_trick = (play.number + 3) / 4;
-  int last_card = ((play.number + 3) % 4) + 1;
-  if (last_trick >= numTricks) 
-  {
-    last_trick = numTricks-1;
-    last_card = 4;
-  }
-  solvedp->number = 0;
+  const int number = TraceLength(play, run);
 
-  solvedp->tricks[0] = (numCardsPlayed % 2 == 1 ? 
-    numTricks - fut.score[0] : fut.score[0]);
-  int hint = solvedp->tricks[0];
-  int hintDir;
+  solvedp->number = 0;
+  solvedp->tricks[0] = run.tricks;
 
-  int running_remainder = numTricks;
-  int running_declarer = 0;
-  int running_player = dl.first;
-  int running_side = 1; /* defenders */
-  int start_side = running_player % 2;
 #if DEBUG
-  int solved_declarer = solvedp->tricks[0];
-  int initial_par = solved_declarer;
   fout.open("trace.txt", ofstream::out | ofstream::app);
-  fout << "Initial solve: " << initial_par << "\n";
-  fout << "no " << play.number << ", Last trick " << last_trick <<
-    ", last card " << last_card << "\n";
-  fout << setw(5) << "trick" << setw(6) << "card" << 
-    setw(6) << "rest" << setw(9) << "declarer" <<
-    setw(7) << "player" << setw(7) << "side" <<
-    setw(6) << "soln0" << setw(6) << "soln1" << setw(6) << "diff" << "\n";
+  fout << "Initial solve: " << run.tricks << "\n";
+  fout << "no " << play.number << ", positions " << number << "\n";
 #endif
 
-  for (int trick = 1; trick <= last_trick; trick++)
+  for (int n = 0; n < number - 1; n++)
   {
-    int best_card = 0, best_suit = 0, best_player = 0, trump_played = 0;
-    int lc = (trick == last_trick ? last_card : 4);
-
-    bool haveCurrent = (numCardsPlayed > 1 && trick == 1);
-    int offset = 4 * (trick - 1) - (numCardsPlayed - 1);
-
-    for (int card = 1; card <= lc; card++)
-    {
-      int suit, rr;
-      bool usingCurrent = (haveCurrent && card < numCardsPlayed);
-      if (usingCurrent)
-      {
-        suit = dl.currentTrickSuit[card - 1];
-        rr = dl.currentTrickRank[card - 1];
-      }
-      else
-      {
-        suit = play.suit[offset + card - 1];
-        rr = play.rank[offset + card - 1];
-      }
-      unsigned hold = static_cast<unsigned>(bitMapRank[rr] << 2);
-
-      move.suit = suit;
-      move.rank = rr;
-      move.sequence = rr;
-
-      /* Keep track of the winner of the trick so far */
-      if (card == 1)
-      {
-        best_card = rr;
-        best_suit = suit;
-        best_player = dl.first;
-        trump_played = (suit == dl.trump ? 1 : 0);
-      }
-      else if (suit == dl.trump)
-      {
-        if (! trump_played || rr > best_card)
-        {
-          best_card = rr;
-          best_suit = suit;
-          best_player = running_player;
-          trump_played = 1;
-        }
-      }
-      else if (! trump_played && suit == best_suit && rr > best_card)
-      {
-        best_card = rr;
-        best_player = running_player;
-      }
-
-      if ((dl.remainCards[running_player][suit] & hold) == 0)
-      {
-        if (! usingCurrent)
-        {
-#if DEBUG
-          fout << "ERR Trick " << trick << " card " << card <<
-            " pl " << running_player << ": suit " << suit <<
-            " hold " << hold << "\n";
-          fout.close();
-#endif
-          return RETURN_PLAY_FAULT;
-        }
-      }
-      else
-        dl.remainCards[running_player][suit] ^= hold;
-
 #if DEBUG
-      int resp_player = running_player;
+    const int resp_player = run.player;
 #endif
 
-      if (card == 4)
-      {
-        running_declarer += (best_player % 2 == start_side ? 0 : 1);
-        running_remainder--;
-
-        if ((dl.first + best_player) % 2 == 0)
-        {
-          hintDir = 0; // Same side leads again; lower bound
-          hint = running_remainder - fut.score[0];
-        }
-        else
-        {
-          hintDir = 1; // Other ("our") side wins trick; upper bound
-          hint = fut.score[0] - 1;
-        }
-
-        dl.first = best_player;
-        running_side = (dl.first % 2 == start_side ? 1 : 0);
-        running_player = dl.first;
-      }
-      else
-      {
-        running_player = (running_player + 1) % 4;
-        running_side = 1 - running_side;
-        hint = running_remainder - fut.score[0];
-        hintDir = 0;
-      }
-
-      if (usingCurrent)
-        continue;
-
-      if ((ret = AnalyseLaterBoard(thrp, dl.first, &move, hint, 
-        hintDir, &fut))
-          != RETURN_NO_FAULT)
-      {
+    if ((ret = PlayCard(ctx, run, play.suit[n], play.rank[n]))
+        != RETURN_NO_FAULT)
+    {
 #if DEBUG
-        fout << "SolveBoard failed, ret " << ret << "\n";
-        fout.close();
+      fout << "Card " << n << " failed, ret " << ret << "\n";
+      fout.close();
 #endif
-        return ret;
-      }
-
-      int new_solved_decl = running_declarer + (running_side ?
-        running_remainder - fut.score[0] : fut.score[0]);
+      return ret;
+    }
 
-      solvedp->tricks[offset + card] = new_solved_decl;
+    solvedp->tricks[n + 1] = run.tricks;
 
 #if DEBUG
-      fout << setw(5) << trick << 
-        setw(6) << card << 
-        setw(6) << running_remainder << 
-        setw(9) << running_declarer <<
-        setw(7) << cardHand[resp_player] << 
-        setw(7) << running_side <<
-        setw(6) << solved_declarer << 
-        setw(6) << new_solved_decl << 
-        setw(6) << new_solved_decl - solved_declarer << "\n";
-        solved_declarer = new_solved_decl;
+    fout << setw(5) << n << setw(7) << cardHand[resp_player] <<
+      setw(6) << solvedp->tricks[n] << setw(6) << run.tricks << "\n";
 #endif
-      
-    }
   }
-  solvedp->number = 4 * last_trick + last_card - 3 - (numCardsPlayed - 1);
+  solvedp->number = number;
 
 #if DEBUG
   fout.close();
@@ -293,13 +371,226 @@ int STDCALL AnalysePlayPBN(
 }
 
 
+// A position is much harder to solve with more cards left, by a
+// factor of about four per trick. The chunks are cut to about equal
+// estimated work, so the first positions get a chunk each and the end
+// of the hand goes into a few long ones. Each chunk costs one solve
+// without a hint, so there are only a few chunks per thread.
+
+static void MakeTraceChunks(
+  const vector<playRunType>& runs,
+  const int nthreads,
+  vector<traceChunkType>& chunks)
+{
+  const int positions = static_cast<int>(runs.size());
+  vector<double> weight(runs.size());
+  double total = 0.;
+  for (unsigned n = 0; n < runs.size(); n++)
+  {
+    const int cardsLeft = 4 * runs[n].remainder - (runs[n].card - 1);
+    weight[n] = ldexp(1., cardsLeft / 2);
+    total += weight[n];
+  }
+
+  const double share = (nthreads == 1 ? total : total / (4 * nthreads));
+
+  chunks.clear();
+  traceChunkType chunk;
+  chunk.first = 0;
+  double sum = 0.;
+  for (int n = 0; n < positions; n++)
+  {
+    sum += weight[static_cast<unsigned>(n)];
+    if (sum >= share || n == positions - 1)
+    {
+      chunk.last = n + 1;
+      chunks.push_back(chunk);
+      chunk.first = n + 1;
+      sum = 0.;
+    }
+  }
+}
+
+
+static void SetTraceError(
+  singleTraceType& singleparam,
+  const int res)
+{
+  int expected = RETURN_NO_FAULT;
+  singleparam.error.compare_exchange_strong(expected, res);
+}
+
+
+static void PlayTraceCommon(
+  EngineState& eng,
+  const int thrId)
+{
+  SolverContext& ctx = eng.contextPool.Get(static_cast<unsigned>(thrId));
+  singleTraceType& singleparam = eng.play.single;
+  const playTraceBin& play = * singleparam.play;
+  solvedPlay * solvedp = singleparam.solvedp;
+
+  while (singleparam.error == RETURN_NO_FAULT)
+  {
+    const unsigned c = static_cast<unsigned>(singleparam.next++);
+    if (c >= singleparam.chunks.size())
+      break;
+
+    // Within a chunk the positions follow each other on one context,
+    // so they get the hints and the warm table of the sequential run.
+    const traceChunkType& chunk = singleparam.chunks[c];
+    playRunType run = singleparam.runs[static_cast<unsigned>(chunk.first)];
+
+    int ret = PlaySolve(ctx, run);
+    if (ret != RETURN_NO_FAULT)
+    {
+      SetTraceError(singleparam, ret);
+      break;
+    }
+    solvedp->tricks[chunk.first] = run.tricks;
+
+    for (int n = chunk.first; n < chunk.last - 1; n++)
+    {
+      if ((ret = PlayCard(ctx, run, play.suit[n], play.rank[n]))
+          != RETURN_NO_FAULT)
+      {
+        SetTraceError(singleparam, ret);
+        break;
+      }
+      solvedp->tricks[n + 1] = run.tricks;
+    }
+  }
+}
+
+
+/**
+ * @brief Analyze one play trace on all solver threads.
+ *
+ * Gives the same result as AnalysePlayBin. The positions of the trace
+ * are found first without solving, and are then solved in parallel in
+ * runs of consecutive positions.
+ *
+ * Like the batch functions, it uses all threads, and waits for any
+ * other batch or stream on the same engine to finish.
+ *
+ * @param dl The deal to analyze
+ * @param play The sequence of played cards (binary format)
+ * @param solvedp Pointer to result structure for solved play
+ * @return 1 on success, error code otherwise
+ */
+int STDCALL AnalysePlayBinParallel(
+  deal dl,
+  playTraceBin play,
+  solvedPlay * solvedp)
+{
+  return AnalysePlayBinParallel(DefaultEngine(), dl, play, solvedp);
+}
+
+
+int AnalysePlayBinParallel(
+  EngineState& eng,
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp)
+{
+  lock_guard<mutex> lk(eng.runMtx);
+  singleTraceType& singleparam = eng.play.single;
+
+  const int nthreads = eng.sysdep.GetNumThreads();
+  if (eng.contextPool.NumThreads() < static_cast<unsigned>(nthreads))
+    return RETURN_THREAD_INDEX;
+
+  // The rest of the deal is checked by the solves.
+  if (dl.trump < 0 || dl.trump > DDS_SUITS)
+    return RETURN_TRUMP_WRONG;
+  if (dl.first < 0 || dl.first >= DDS_HANDS)
+    return RETURN_FIRST_WRONG;
+
+  playRunType run;
+  PlaySetup(dl, run);
+
+  const int number = TraceLength(play, run);
+  const int positions = max(number, 1);
+
+  // Check the whole trace before solving anything, as AnalysePlayBin
+  // would fail on a bad card only after solving the ones before it.
+  vector<playRunType>& runs = singleparam.runs;
+  runs.resize(static_cast<unsigned>(positions));
+  runs[0] = run;
+  for (int n = 1; n < positions; n++)
+  {
+    int ret = PlayMove(run, play.suit[n - 1], play.rank[n - 1]);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+    runs[static_cast<unsigned>(n)] = run;
+  }
+
+  MakeTraceChunks(runs, nthreads, singleparam.chunks);
+  singleparam.play = &play;
+  singleparam.solvedp = solvedp;
+  singleparam.next = 0;
+  singleparam.error = RETURN_NO_FAULT;
+  solvedp->number = 0;
+
+  int retRun;
+  if (singleparam.chunks.size() == 1)
+  {
+    // Nothing to share out.
+    PlayTraceCommon(eng, 0);
+    retRun = RETURN_NO_FAULT;
+  }
+  else
+    retRun = eng.sysdep.RunThreads(PlayTraceCommon);
+
+  if (retRun != RETURN_NO_FAULT)
+    return retRun;
+
+  if (singleparam.error != RETURN_NO_FAULT)
+    return singleparam.error;
+
+  solvedp->number = number;
+  return RETURN_NO_FAULT;
+}
+
+
+int STDCALL AnalysePlayPBNParallel(
+  dealPBN dlPBN,
+  playTracePBN playPBN,
+  solvedPlay * solvedp)
+{
+  deal dl;
+  playTraceBin play;
+
+  if (ConvertFromPBN(dlPBN.remainCards, dl.remainCards) !=
+      RETURN_NO_FAULT)
+    return RETURN_PBN_FAULT;
+
+  dl.first = dlPBN.first;
+  dl.trump = dlPBN.trump;
+  for (int i = 0; i <= 2; i++)
+  {
+    dl.currentTrickSuit[i] = dlPBN.currentTrickSuit[i];
+    dl.currentTrickRank[i] = dlPBN.currentTrickRank[i];
+  }
+
+  if (ConvertPlayFromPBN(playPBN, play) != RETURN_NO_FAULT)
+    return RETURN_PLAY_FAULT;
+
+  return AnalysePlayBinParallel(dl, play, solvedp);
+}
+
+
 void PlaySingleCommon(
+  EngineState& eng,
   const int thrId,
   const int bno)
 {
+  paramType& playparam = eng.play.param;
+  const playparamType& traceparam = eng.play.trace;
   solvedPlay solved;
 
   int res = AnalysePlayBin(
+    eng,
     playparam.bop->deals[bno],
     traceparam.plp->plays[bno],
     &solved,
@@ -313,8 +604,11 @@ void PlaySingleCommon(
 }
 
 
-void PlayChunkCommon(const int thrId)
+void PlayChunkCommon(
+  EngineState& eng,
+  const int thrId)
 {
+  Scheduler& scheduler = eng.scheduler;
   int index;
   schedType st;
 
@@ -325,7 +619,7 @@ void PlayChunkCommon(const int thrId)
     if (index == -1)
       break;
 
-    PlaySingleCommon(thrId, index);
+    PlaySingleCommon(eng, thrId, index);
   }
 }
 
@@ -336,14 +630,28 @@ int STDCALL AnalyseAllPlaysBin(
   solvedPlays * solvedp,
   [[maybe_unused]] int chunkSize)
 {
-  playparam.error = 0;
+  return AnalyseAllPlaysBin(DefaultEngine(), bop, plp, solvedp);
+}
+
 
+int AnalyseAllPlaysBin(
+  EngineState& eng,
+  boards * bop,
+  playTracesBin * plp,
+  solvedPlays * solvedp)
+{
   if (bop->noOfBoards > MAXNOOFBOARDS)
     return RETURN_TOO_MANY_BOARDS;
 
   if (bop->noOfBoards != plp->noOfBoards)
     return RETURN_UNKNOWN_FAULT;
 
+  lock_guard<mutex> lk(eng.runMtx);
+  paramType& playparam = eng.play.param;
+  playparamType& traceparam = eng.play.trace;
+  Scheduler& scheduler = eng.scheduler;
+
+  playparam.error = 0;
   playparam.bop = bop;
   traceparam.plp = plp;
   playparam.noOfBoards = bop->noOfBoards;
@@ -351,10 +659,10 @@ int STDCALL AnalyseAllPlaysBin(
   traceparam.solvedp = solvedp;
 
   scheduler.RegisterRun(DDS_RUN_TRACE, * bop, * plp);
-  sysdep.RegisterRun(DDS_RUN_TRACE, * bop);
+  eng.sysdep.RegisterRun(DDS_RUN_TRACE, * bop);
 
   START_BLOCK_TIMER;
-  int retRun = sysdep.RunThreads();
+  int retRun = eng.sysdep.RunThreads();
   END_BLOCK_TIMER;
 
   if (retRun != RETURN_NO_FAULT)
@@ -420,6 +728,7 @@ int STDCALL AnalyseAllPlaysPBN(
 
 
 void DetectPlayDuplicates(
+  [[maybe_unused]] EngineState& eng,
   const boards& bds,
   vector<int>& uniques,
   vector<int>& crossrefs)
@@ -439,6 +748,8 @@ void DetectPlayDuplicates(
 }
 
 
-void CopyPlaySingle([[maybe_unused]] const vector<int>& crossrefs)
+void CopyPlaySingle(
+  [[maybe_unused]] EngineState& eng,
+  [[maybe_unused]] const vector<int>& crossrefs)
 { }
 
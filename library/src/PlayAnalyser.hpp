@@ -10,26 +10,135 @@
 #ifndef DDS_PLAYANALYSER_H
 #define DDS_PLAYANALYSER_H
 
+#include <atomic>
 #include <vector>
 
 #include <api/dll.h>
+#include <api/dds.h>
+#include <solver_context/SolverContext.hpp>
 
 using namespace std;
 
+struct EngineState;
+
+
+// A play trace in progress, one card at a time. PlayStart solves the
+// deal once, and each PlayCard is one AnalyseLaterBoard on the same
+// context, so the transposition table carries over.
+// Tricks are counted for declarer, the side that is not on lead.
+
+struct playRunType
+{
+  deal dl; // The current position, which SolveBoard accepts
+  futureTricks fut; // Latest solve, for the side to play next
+  int numTricks; // Tricks left at the start, including a started one
+  int numCardsPlayed; // Cards already in the first trick, plus one
+  int trick; // 1-based trick of the next card
+  int card; // 1-based position of the next card in its trick
+  int hint;
+  int hintDir;
+  int remainder; // Tricks not yet completed
+  int declarer; // Completed tricks won by declarer
+  int player; // Hand to play next
+  int side; // 1 if the hand to play next is a defender
+  int startSide;
+  int leadSuit;
+  int bestCard;
+  int bestSuit;
+  int bestPlayer;
+  bool trumpPlayed;
+  int tricks; // Double dummy tricks for declarer
+};
+
+int PlayStart(
+  SolverContext& ctx,
+  const deal& dl,
+  playRunType& run);
+
+// RETURN_PLAY_FAULT if the hand to play does not hold the card.
+// The last trick is forced, so its cards are not solved.
+int PlayCard(
+  SolverContext& ctx,
+  playRunType& run,
+  const int suit,
+  const int rank);
+
+
+// The play analyses of one engine that use all of its threads.
+
+struct playparamType
+{
+  int noOfBoards;
+  playTracesBin * plp;
+  solvedPlays * solvedp;
+  int error;
+};
+
+// One trace spread over the worker threads.
+
+struct traceChunkType
+{
+  int first; // Solved from scratch
+  int last; // One past the last position
+};
+
+struct singleTraceType
+{
+  playTraceBin const * play;
+  vector<playRunType> runs; // After n cards, not yet solved
+  vector<traceChunkType> chunks;
+  atomic<int> next;
+  solvedPlay * solvedp;
+  atomic<int> error;
+};
+
+struct playStateType
+{
+  paramType param;
+  playparamType trace;
+  singleTraceType single;
+};
+
 
 void PlaySingleCommon(
+  EngineState& eng,
   const int thrId,
   const int bno);
 
 void PlayChunkCommon(
+  EngineState& eng,
   const int thrId);
 
 void DetectPlayDuplicates(
+  EngineState& eng,
   const boards& bds,
   vector<int>& uniques,
   vector<int>& crossrefs);
 
 void CopyPlaySingle(
+  EngineState& eng,
   const vector<int>& crossrefs);
 
+// The play analyses behind the C interface, on eng. The parallel and
+// batch ones hold the run lock of eng while they run.
+
+int AnalysePlayBin(
+  EngineState& eng,
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp,
+  const int thrId);
+
+int AnalysePlayBinParallel(
+  EngineState& eng,
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp);
+
+int AnalyseAllPlaysBin(
+  EngineState& eng,
+  boards * bop,
+  playTracesBin * plp,
+  solvedPlays * solvedp);
+
 #endif
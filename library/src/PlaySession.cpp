@@ -0,0 +1,122 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "PlayAnalyser.hpp"
+#include <api/PlaySession.hpp>
+
+
+struct PlaySession::Impl
+{
+  SolverContext ctx;
+  playRunType run;
+  bool started;
+  int played;
+
+  explicit Impl(const SolverConfig& cfg) : ctx(cfg)
+  {
+    started = false;
+    played = 0;
+  }
+};
+
+
+PlaySession::PlaySession(const SolverConfig& cfg)
+  : impl_(std::make_unique<Impl>(cfg))
+{
+}
+
+
+PlaySession::~PlaySession() = default;
+
+
+int PlaySession::Start(const deal& dl)
+{
+  impl_->started = false;
+  impl_->played = 0;
+
+  int ret = PlayStart(impl_->ctx, dl, impl_->run);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  impl_->started = true;
+  return RETURN_NO_FAULT;
+}
+
+
+int PlaySession::Play(
+  const int suit,
+  const int rank,
+  playCardResult * resp)
+{
+  if (! impl_->started || PlaySession::Done() ||
+      suit < 0 || suit >= DDS_SUITS)
+    return RETURN_PLAY_FAULT;
+
+  playRunType& run = impl_->run;
+  const int player = run.player;
+
+  // Must follow suit if possible.
+  if (run.card > 1 && suit != run.leadSuit &&
+      run.dl.remainCards[player][run.leadSuit] != 0)
+    return RETURN_PLAY_FAULT;
+
+  // PlayCard leaves run half-updated if the solve stops early, and
+  // AnalyseLaterBoard has then already stepped the context on by one
+  // card. Both go back, so the next card starts from this position.
+  SolverContext& ctx = impl_->ctx;
+  const playRunType before = run;
+  const int iniDepth = ctx.search().iniDepth();
+  const pos lookAheadPos = ctx.thread()->lookAheadPos;
+  const int ret = PlayCard(ctx, run, suit, rank);
+  if (ret != RETURN_NO_FAULT)
+  {
+    run = before;
+    ctx.search().iniDepth() = iniDepth;
+    ctx.thread()->lookAheadPos = lookAheadPos;
+    return ret;
+  }
+  impl_->played++;
+
+  if (resp)
+  {
+    // Declarer sits on the side that is not on lead at the start.
+    const bool declarerSide = (player % 2 != run.startSide);
+    const int diff = run.tricks - before.tricks;
+    resp->tricks = run.tricks;
+    resp->cost = (declarerSide ? -diff : diff);
+    resp->player = player;
+    resp->next = run.player;
+  }
+  return RETURN_NO_FAULT;
+}
+
+
+int PlaySession::Tricks() const
+{
+  return impl_->started ? impl_->run.tricks : 0;
+}
+
+
+int PlaySession::NextHand() const
+{
+  return impl_->started ? impl_->run.player : -1;
+}
+
+
+int PlaySession::CardsPlayed() const
+{
+  return impl_->played;
+}
+
+
+bool PlaySession::Done() const
+{
+  return impl_->started && impl_->run.trick > impl_->run.numTricks;
+}
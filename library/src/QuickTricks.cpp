@@ -13,6 +13,7 @@
 #include "QuickTricks.hpp"
 #include <solver_context/SolverContext.hpp>
 #include <lookup_tables/LookupTables.hpp>
+#include <lookup_tables/CardHolders.hpp>
 
 
 int QtricksLeadHandNT(
@@ -64,7 +65,7 @@ int QuickTricksPartnerHand(
   const int commSuit,
   const int commRank,
   int& res,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 int QuickTricksPartnerHandTrump(
   const int hand,
@@ -82,7 +83,7 @@ int QuickTricksPartnerHandTrump(
   const int commSuit,
   const int commRank,
   int& res,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 int QuickTricksPartnerHandNT(
   const int hand,
@@ -98,7 +99,7 @@ int QuickTricksPartnerHandNT(
   const int commSuit,
   const int commRank,
   int& res,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 
 /**
@@ -123,8 +124,9 @@ int QuickTricks(
   const int target,
   const int trump,
   bool& result,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
+  ThreadData * const thrp = sv.thread();
   int suit, commRank = 0, commSuit = -1;
   int res;
   int lhoTrumpRanks = 0, rhoTrumpRanks = 0;
@@ -133,7 +135,7 @@ int QuickTricks(
   result = true;
   int qtricks = 0;
 
-  if (ctx.search().nodeTypeStore(hand) == MAXNODE)
+  if (thrp->nodeTypeStore[hand] == MAXNODE)
     cutoff = target - tpos.tricksMAX;
   else
     cutoff = tpos.tricksMAX - target + (depth >> 2) + 2;
@@ -521,7 +523,7 @@ int QuickTricks(
             qtricks = QuickTricksPartnerHandTrump(hand, tpos,
               cutoff, depth, countLho, countRho,
               lhoTrumpRanks, rhoTrumpRanks, countOwn,
-              countPart, suit, qtricks, commSuit, commRank, res, ctx);
+              countPart, suit, qtricks, commSuit, commRank, res, sv);
 
             if (res == 1)
               return qtricks;
@@ -537,7 +539,7 @@ int QuickTricks(
           {
             qtricks = QuickTricksPartnerHandNT(hand, tpos, cutoff,
               depth, countLho, countRho, countOwn, countPart,
-              suit, qtricks, commSuit, commRank, res, ctx);
+              suit, qtricks, commSuit, commRank, res, sv);
 
             if (res == 1)
               return qtricks;
@@ -680,7 +682,7 @@ int QuickTricks(
         }
       }
 
-      if (ctx.search().nodeTypeStore(hand) != MAXNODE)
+      if (thrp->nodeTypeStore[hand] != MAXNODE)
         cutoff = target - tpos.tricksMAX;
       else
       {
@@ -903,7 +905,7 @@ int QuickTricksPartnerHandTrump(
   const int commSuit,
   const int commRank,
   int& res,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
   /* res=0 Continue with same suit.
      res=1 Cutoff.
@@ -998,10 +1000,12 @@ int QuickTricksPartnerHandTrump(
     for (int h = 0; h < DDS_HANDS; h++)
       ranks |= tpos.rankInSuit[h][suit];
 
-    if (ctx.thread()->rel[ranks].absRank[3][suit].hand == partner[hand])
+    const absRankType third =
+      abs_rank(sv.thread()->holders, ranks, 3, suit);
+    if (third.hand == partner[hand])
     {
       tpos.winRanks[depth][suit] |= bitMapRank[
-        static_cast<int>(static_cast<unsigned char>(ctx.thread()->rel[ranks].absRank[3][suit].rank)) ];
+        static_cast<int>(static_cast<unsigned char>(third.rank)) ];
 
       tpos.winRanks[depth][commSuit] |= bitMapRank[commRank];
 
@@ -1039,7 +1043,7 @@ int QuickTricksPartnerHandNT(
   const int commSuit,
   const int commRank,
   int& res,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
   res = 1;
   int qt = qtricks;
@@ -1108,10 +1112,12 @@ int QuickTricksPartnerHandNT(
     for (int h = 0; h < DDS_HANDS; h++)
       ranks |= tpos.rankInSuit[h][suit];
 
-    if (ctx.thread()->rel[ranks].absRank[3][suit].hand == partner[hand])
+    const absRankType third =
+      abs_rank(sv.thread()->holders, ranks, 3, suit);
+    if (third.hand == partner[hand])
     {
       tpos.winRanks[depth][suit] |= bitMapRank[
-        static_cast<int>(static_cast<unsigned char>(ctx.thread()->rel[ranks].absRank[3][suit].rank)) ];
+        static_cast<int>(static_cast<unsigned char>(third.rank)) ];
       qt++;
       if (qt >= cutoff)
         return qt;
@@ -1136,9 +1142,10 @@ bool QuickTricksSecondHand(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx)
+  const SearchView& sv)
 {
-  if (depth == ctx.search().iniDepth())
+  ThreadData * const thrp = sv.thread();
+  if (depth == thrp->iniDepth)
     return false;
 
   int ss = tpos.move[depth + 1].suit;
@@ -1183,7 +1190,7 @@ bool QuickTricksSecondHand(
   int qtricks = 1;
 
   int cutoff;
-  if (ctx.search().nodeTypeStore(hand) == MAXNODE)
+  if (thrp->nodeTypeStore[hand] == MAXNODE)
     cutoff = target - tpos.tricksMAX;
   else
     cutoff = tpos.tricksMAX - target + (depth >> 2) + 3;
@@ -22,7 +22,7 @@ int QuickTricks(
   const int target,
   const int trump,
   bool& result,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 bool QuickTricksSecondHand(
   pos& tpos,
@@ -30,6 +30,6 @@ bool QuickTricksSecondHand(
   const int depth,
   const int target,
   const int trump,
-  SolverContext& ctx);
+  const SearchView& sv);
 
 #endif
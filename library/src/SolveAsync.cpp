@@ -0,0 +1,427 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <api/SolveAsync.hpp>
+
+using namespace std;
+
+
+namespace
+{
+
+struct boardRequest
+{
+  streamBoard bd;
+  BoardCallback done;
+};
+
+struct tableRequest
+{
+  ddTableDeal td;
+  TableCallback done;
+};
+
+
+/**
+ * @brief The queue behind SubmitBoard and SubmitTable.
+ *
+ * The dispatcher thread starts with the first submission and sleeps
+ * while the queue is empty. Each stream it runs takes requests from
+ * the queue until the queue is empty, so the requests in flight are
+ * keyed by their position in the current stream.
+ */
+class AsyncQueue
+{
+  private:
+
+    mutex mtx;
+    condition_variable cvWork;
+    condition_variable cvIdle;
+
+    deque<boardRequest> boards;
+    deque<tableRequest> tables;
+    unordered_map<int, boardRequest> boardsRunning;
+    unordered_map<int, tableRequest> tablesRunning;
+
+    unsigned outstanding;
+    bool stopping;
+    bool dispatching; // The dispatcher thread has not yet returned
+    thread dispatcher;
+
+    void Dispatch();
+
+    void RunBoards();
+
+    void RunTables();
+
+    void Finish();
+
+    void Wake();
+
+  public:
+
+    AsyncQueue();
+
+    AsyncQueue(const AsyncQueue&) = delete;
+    AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+    void Add(boardRequest&& req);
+
+    void Add(tableRequest&& req);
+
+    void WaitAll();
+
+    void Stop();
+};
+
+
+// Never destroyed. A destructor would join the dispatcher during
+// static destruction, when the engine that it solves on may already
+// be gone. FreeMemory stops the dispatcher instead.
+AsyncQueue& Queue()
+{
+  static AsyncQueue& queue = * new AsyncQueue;
+  return queue;
+}
+
+
+AsyncQueue::AsyncQueue()
+{
+  outstanding = 0;
+  stopping = false;
+  dispatching = false;
+}
+
+
+void AsyncQueue::Wake()
+{
+  // Called with mtx held. A dispatcher that has returned is joined
+  // here, before the next one starts.
+  outstanding++;
+  if (! dispatching)
+  {
+    if (dispatcher.joinable())
+      dispatcher.join();
+    dispatcher = thread(&AsyncQueue::Dispatch, this);
+    dispatching = true;
+  }
+  cvWork.notify_one();
+}
+
+
+void AsyncQueue::Add(boardRequest&& req)
+{
+  lock_guard<mutex> lk(mtx);
+  boards.push_back(move(req));
+  Wake();
+}
+
+
+void AsyncQueue::Add(tableRequest&& req)
+{
+  lock_guard<mutex> lk(mtx);
+  tables.push_back(move(req));
+  Wake();
+}
+
+
+void AsyncQueue::Finish()
+{
+  lock_guard<mutex> lk(mtx);
+  if (--outstanding == 0)
+    cvIdle.notify_all();
+}
+
+
+void AsyncQueue::WaitAll()
+{
+  unique_lock<mutex> lk(mtx);
+  cvIdle.wait(lk, [this]() { return outstanding == 0; });
+}
+
+
+void AsyncQueue::Stop()
+{
+  // Drains the queue and joins the dispatcher. The next submission
+  // starts a new one.
+  AsyncQueue::WaitAll();
+
+  thread th;
+  {
+    lock_guard<mutex> lk(mtx);
+    stopping = true;
+    th = move(dispatcher);
+  }
+  cvWork.notify_one();
+
+  if (th.joinable())
+    th.join();
+
+  lock_guard<mutex> lk(mtx);
+  stopping = false;
+}
+
+
+void AsyncQueue::Dispatch()
+{
+  unique_lock<mutex> lk(mtx);
+  while (1)
+  {
+    cvWork.wait(lk, [this]()
+    {
+      return stopping || ! boards.empty() || ! tables.empty();
+    });
+
+    if (boards.empty() && tables.empty())
+    {
+      dispatching = false;
+      return;
+    }
+
+    lk.unlock();
+    RunBoards();
+    RunTables();
+    lk.lock();
+  }
+}
+
+
+void AsyncQueue::RunBoards()
+{
+  int produced = 0;
+
+  const BoardProducer next = [this, &produced](streamBoard& bd)
+  {
+    lock_guard<mutex> lk(mtx);
+    if (boards.empty())
+      return false;
+
+    bd = boards.front().bd;
+    boardsRunning.emplace(produced++, move(boards.front()));
+    boards.pop_front();
+    return true;
+  };
+
+  const BoardConsumer done = [this](
+    int index,
+    int status,
+    const futureTricks& fut)
+  {
+    BoardCallback cb;
+    {
+      lock_guard<mutex> lk(mtx);
+      auto it = boardsRunning.find(index);
+      cb = move(it->second.done);
+      boardsRunning.erase(it);
+    }
+    cb(status, fut);
+    AsyncQueue::Finish();
+  };
+
+  {
+    lock_guard<mutex> lk(mtx);
+    if (boards.empty())
+      return;
+  }
+
+  const int res = SolveBoardStream(next, done);
+
+  // Requests that the stream took but did not finish fail with its
+  // error. If it could not start at all, so does the whole queue.
+  deque<boardRequest> failed;
+  {
+    lock_guard<mutex> lk(mtx);
+    for (auto& r: boardsRunning)
+      failed.push_back(move(r.second));
+    boardsRunning.clear();
+
+    if (res != RETURN_NO_FAULT && produced == 0)
+    {
+      for (auto& r: boards)
+        failed.push_back(move(r));
+      boards.clear();
+    }
+  }
+
+  const int status = (res == RETURN_NO_FAULT ? RETURN_UNKNOWN_FAULT : res);
+  const futureTricks none = {};
+  for (auto& req: failed)
+  {
+    req.done(status, none);
+    AsyncQueue::Finish();
+  }
+}
+
+
+void AsyncQueue::RunTables()
+{
+  int produced = 0;
+
+  const TableProducer next = [this, &produced](ddTableDeal& td)
+  {
+    lock_guard<mutex> lk(mtx);
+    if (tables.empty())
+      return false;
+
+    td = tables.front().td;
+    tablesRunning.emplace(produced++, move(tables.front()));
+    tables.pop_front();
+    return true;
+  };
+
+  const TableConsumer done = [this](
+    int index,
+    int status,
+    const ddTableResults& table)
+  {
+    TableCallback cb;
+    {
+      lock_guard<mutex> lk(mtx);
+      auto it = tablesRunning.find(index);
+      cb = move(it->second.done);
+      tablesRunning.erase(it);
+    }
+    cb(status, table);
+    AsyncQueue::Finish();
+  };
+
+  {
+    lock_guard<mutex> lk(mtx);
+    if (tables.empty())
+      return;
+  }
+
+  const int res = CalcTableStream(next, done);
+
+  deque<tableRequest> failed;
+  {
+    lock_guard<mutex> lk(mtx);
+    for (auto& r: tablesRunning)
+      failed.push_back(move(r.second));
+    tablesRunning.clear();
+
+    if (res != RETURN_NO_FAULT && produced == 0)
+    {
+      for (auto& r: tables)
+        failed.push_back(move(r));
+      tables.clear();
+    }
+  }
+
+  const int status = (res == RETURN_NO_FAULT ? RETURN_UNKNOWN_FAULT : res);
+  const ddTableResults none = {};
+  for (auto& req: failed)
+  {
+    req.done(status, none);
+    AsyncQueue::Finish();
+  }
+}
+
+}
+
+
+void SubmitBoard(
+  const streamBoard& bd,
+  BoardCallback done)
+{
+  Queue().Add(boardRequest{bd, move(done)});
+}
+
+
+future<asyncBoardResult> SubmitBoard(
+  const streamBoard& bd)
+{
+  auto prom = make_shared<promise<asyncBoardResult>>();
+  future<asyncBoardResult> fut = prom->get_future();
+
+  SubmitBoard(bd, [prom](int status, const futureTricks& ft)
+  {
+    prom->set_value(asyncBoardResult{status, ft});
+  });
+  return fut;
+}
+
+
+void SubmitTable(
+  const ddTableDeal& td,
+  TableCallback done)
+{
+  Queue().Add(tableRequest{td, move(done)});
+}
+
+
+future<asyncTableResult> SubmitTable(
+  const ddTableDeal& td)
+{
+  auto prom = make_shared<promise<asyncTableResult>>();
+  future<asyncTableResult> fut = prom->get_future();
+
+  SubmitTable(td, [prom](int status, const ddTableResults& table)
+  {
+    prom->set_value(asyncTableResult{status, table});
+  });
+  return fut;
+}
+
+
+int STDCALL SolveBoardAsync(
+  deal dl,
+  int target,
+  int solutions,
+  int mode,
+  SolveBoardCallback callback,
+  void * user)
+{
+  if (callback == nullptr)
+    return RETURN_UNKNOWN_FAULT;
+
+  SubmitBoard(streamBoard{dl, target, solutions, mode},
+    [callback, user](int status, const futureTricks& fut)
+  {
+    callback(user, status, &fut);
+  });
+  return RETURN_NO_FAULT;
+}
+
+
+int STDCALL CalcDDtableAsync(
+  ddTableDeal tableDeal,
+  CalcDDtableCallback callback,
+  void * user)
+{
+  if (callback == nullptr)
+    return RETURN_UNKNOWN_FAULT;
+
+  SubmitTable(tableDeal,
+    [callback, user](int status, const ddTableResults& table)
+  {
+    callback(user, status, &table);
+  });
+  return RETURN_NO_FAULT;
+}
+
+
+void STDCALL WaitAllAsync()
+{
+  Queue().WaitAll();
+}
+
+
+void StopAsync()
+{
+  Queue().Stop();
+}
@@ -10,23 +10,30 @@
 
 #include "SolverIF.hpp"
 #include "SolveBoard.hpp"
+#include "EngineState.hpp"
+#include <api/SolveBoard.hpp>
 #include <system/System.hpp>
 #include <system/Memory.hpp>
 #include <system/Scheduler.hpp>
+#include <system/DealFingerprint.hpp>
+#include <system/ResultCache.hpp>
+#include <solver_context/ContextPool.hpp>
+#include <lookup_tables/LookupTables.hpp>
 #include <PBN.hpp>
 #include <utility/debug.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <unordered_map>
 
 
-paramType param;
+extern ResultCache solveCache;
 
-extern System sysdep;
-extern Memory memory;
-extern Scheduler scheduler;
-
-int SolveAllBoardsN(
-  boards& bds,
-  solvedBoards& solved);
+int BoardRangeChecks(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode);
 
 bool SameBoard(
   const boards& bds,
@@ -35,9 +42,12 @@ bool SameBoard(
 
 
 void SolveSingleCommon(
+  EngineState& eng,
   const int thrId,
   const int bno)
 {
+  paramType& param = eng.solve.param;
+  Scheduler& scheduler = eng.scheduler;
   futureTricks fut;
 
   // Fallback timing: measure per-board elapsed time (ms) even when
@@ -45,13 +55,22 @@ void SolveSingleCommon(
   // dtest -r/--report option to print per-board timings.
   START_THREAD_TIMER(thrId);
   auto t0 = std::chrono::steady_clock::now();
-  int res = SolveBoard(
-              param.bop->deals[bno],
-              param.bop->target[bno],
-              param.bop->solutions[bno],
-              param.bop->mode[bno],
-              &fut,
-              thrId);
+  // A batch that hit its limits skips its remaining boards.
+  int res = eng.solve.limits.reached();
+  if (res == RETURN_NO_FAULT)
+  {
+    SolverContext& ctx = eng.contextPool.Get(static_cast<unsigned>(thrId));
+    ctx.SetSearchLimits(eng.solve.limits);
+    res = SolveBoard(
+            eng,
+            param.bop->deals[bno],
+            param.bop->target[bno],
+            param.bop->solutions[bno],
+            param.bop->mode[bno],
+            &fut,
+            thrId);
+    ctx.SetSearchLimits(SearchLimits{});
+  }
   auto t1 = std::chrono::steady_clock::now();
   END_THREAD_TIMER(thrId);
 
@@ -69,24 +88,28 @@ void SolveSingleCommon(
 }
 
 
-void CopySolveSingle(const vector<int>& crossrefs)
+void CopySolveSingle(
+  EngineState& eng,
+  const vector<int>& crossrefs)
 {
+  paramType& param = eng.solve.param;
   for (unsigned i = 0; i < crossrefs.size(); i++)
   {
     if (crossrefs[i] == -1)
       continue;
 
-    START_THREAD_TIMER(thrId);
     param.solvedp->solvedBoard[i] = 
       param.solvedp->solvedBoard[crossrefs[i]];
-    END_THREAD_TIMER(thrId);
   }
 }
 
 
 void SolveChunkCommon(
+  EngineState& eng,
   const int thrId)
 {
+  const paramType& param = eng.solve.param;
+  Scheduler& scheduler = eng.scheduler;
   int index;
   schedType st;
 
@@ -114,34 +137,41 @@ void SolveChunkCommon(
     }
     else
     {
-      SolveSingleCommon(thrId, index);
+      SolveSingleCommon(eng, thrId, index);
     }
   }
 }
 
 
 int SolveAllBoardsN(
+  EngineState& eng,
   boards& bds,
-  solvedBoards& solved)
+  solvedBoards& solved,
+  const SearchLimits& limits)
 {
-  param.error = 0;
-
   if (bds.noOfBoards > MAXNOOFBOARDS)
     return RETURN_TOO_MANY_BOARDS;
 
+  lock_guard<mutex> lk(eng.runMtx);
+  paramType& param = eng.solve.param;
+  Scheduler& scheduler = eng.scheduler;
+
+  param.error = 0;
   param.bop = &bds;
   param.solvedp = &solved;
   param.noOfBoards = bds.noOfBoards;
 
   scheduler.RegisterRun(DDS_RUN_SOLVE, bds);
-  sysdep.RegisterRun(DDS_RUN_SOLVE, bds);
+  eng.sysdep.RegisterRun(DDS_RUN_SOLVE, bds);
 
   for (int k = 0; k < MAXNOOFBOARDS; k++)
     solved.solvedBoard[k].cards = 0;
 
+  eng.solve.limits = limits;
   START_BLOCK_TIMER;
-  int retRun = sysdep.RunThreads();
+  int retRun = eng.sysdep.RunThreads();
   END_BLOCK_TIMER;
+  eng.solve.limits = SearchLimits{};
 
   if (retRun != RETURN_NO_FAULT)
     return retRun;
@@ -197,6 +227,361 @@ int STDCALL SolveBoardPBN(
 }
 
 
+// One job per run of cards that no other card splits, so equal cards
+// are searched once. A card in the current trick splits a run, as it
+// decides who wins the trick.
+
+static void MakeRootJobs(
+  const deal& dl,
+  const int hand,
+  const int handRelFirst,
+  vector<rootJobType>& jobs)
+{
+  jobs.clear();
+  const int leadSuit = dl.currentTrickSuit[0];
+  const bool follow =
+    (handRelFirst > 0 && dl.remainCards[hand][leadSuit] != 0);
+
+  for (int s = 0; s < DDS_SUITS; s++)
+  {
+    if (follow && s != leadSuit)
+      continue;
+
+    const unsigned held = dl.remainCards[hand][s];
+    unsigned others = 0;
+    for (int h = 0; h < DDS_HANDS; h++)
+      if (h != hand)
+        others |= dl.remainCards[h][s];
+    for (int k = 0; k < handRelFirst; k++)
+      if (dl.currentTrickSuit[k] == s)
+        others |= static_cast<unsigned>(bitMapRank[dl.currentTrickRank[k]] << 2);
+
+    bool open = false;
+    for (int r = 14; r >= 2; r--)
+    {
+      const unsigned bit = static_cast<unsigned>(bitMapRank[r] << 2);
+      if (others & bit)
+        open = false;
+      else if (held & bit)
+      {
+        if (! open)
+        {
+          rootJobType job;
+          job.suit = s;
+          job.rank = r;
+          job.cards = 0;
+          jobs.push_back(job);
+          open = true;
+        }
+        jobs.back().cards |= bit;
+      }
+    }
+  }
+}
+
+
+// The score of the side to play if it plays the job's cards.
+
+static int ScoreRootJob(
+  SolverContext& ctx,
+  rootParamType& rootparam,
+  const rootJobType& job,
+  int& score,
+  int& nodes)
+{
+  const deal& dl = * rootparam.dl;
+  const int hand = rootparam.handToPlay;
+  const int rel = rootparam.handRelFirst;
+
+  deal child = dl;
+  child.remainCards[hand][job.suit] &=
+    ~static_cast<unsigned>(bitMapRank[job.rank] << 2);
+
+  int winner = -1;
+  if (rel < 3)
+  {
+    child.currentTrickSuit[rel] = job.suit;
+    child.currentTrickRank[rel] = job.rank;
+  }
+  else
+  {
+    // The card completes the trick.
+    int bestSuit = dl.currentTrickSuit[0];
+    int bestRank = dl.currentTrickRank[0];
+    int bestRel = 0;
+    for (int k = 1; k <= 3; k++)
+    {
+      const int s = (k < 3 ? dl.currentTrickSuit[k] : job.suit);
+      const int r = (k < 3 ? dl.currentTrickRank[k] : job.rank);
+      if ((s == bestSuit && r > bestRank) ||
+          (s == dl.trump && bestSuit != dl.trump))
+      {
+        bestSuit = s;
+        bestRank = r;
+        bestRel = k;
+      }
+    }
+
+    winner = handId(dl.first, bestRel);
+    child.first = winner;
+    for (int k = 0; k < 3; k++)
+    {
+      child.currentTrickSuit[k] = 0;
+      child.currentTrickRank[k] = 0;
+    }
+  }
+
+  // The child score is for the hand to play after the card.
+  const int tricks = rootparam.tricksLeft;
+  const int childTricks = (winner == -1 ? tricks : tricks - 1);
+  const bool sameSide = (winner != -1 && winner % 2 == hand % 2);
+  const int offset = (sameSide ? 1 : 0);
+
+  futureTricks fut;
+  int childScore;
+  nodes = 0;
+
+  // A single trick left goes to the last-trick shortcut, which
+  // ignores the target.
+  const int estimate = rootparam.estimate;
+  if (estimate < 0 || childTricks == 1)
+  {
+    int ret = SolveBoardInternal(ctx, child, -1, 1, 1, &fut);
+    if (ret != RETURN_NO_FAULT)
+      return ret;
+    nodes = fut.nodes;
+    childScore = fut.score[0];
+  }
+  else
+  {
+    // Null-window searches from the score of a card that is already
+    // known, as the cards of one hand tend to score alike.
+    int guess = (sameSide ? estimate - offset : childTricks - estimate);
+    guess = max(1, min(guess, childTricks));
+    int lowerbound = 0;
+    int upperbound = childTricks;
+    while (lowerbound < upperbound)
+    {
+      int ret = SolveBoardInternal(ctx, child, guess, 1, 1, &fut);
+      if (ret != RETURN_NO_FAULT)
+        return ret;
+      nodes += fut.nodes;
+
+      if (fut.cards > 0)
+        lowerbound = guess++;
+      else
+        upperbound = --guess;
+    }
+    childScore = lowerbound;
+  }
+
+  score = (sameSide ? offset + childScore : childTricks - childScore);
+  rootparam.estimate = score;
+  return RETURN_NO_FAULT;
+}
+
+
+static void SolveRootCommon(
+  EngineState& eng,
+  const int thrId)
+{
+  SolverContext& ctx = eng.contextPool.Get(static_cast<unsigned>(thrId));
+  rootParamType& rootparam = eng.solve.root;
+
+  while (rootparam.error == RETURN_NO_FAULT)
+  {
+    const unsigned j = static_cast<unsigned>(rootparam.next++);
+    if (j >= rootparam.jobs.size())
+      break;
+
+    rootJobType& job = rootparam.jobs[j];
+    int score, nodes;
+    int ret = ScoreRootJob(ctx, rootparam, job, score, nodes);
+    if (ret != RETURN_NO_FAULT)
+    {
+      int expected = RETURN_NO_FAULT;
+      rootparam.error.compare_exchange_strong(expected, ret);
+      break;
+    }
+
+    rootparam.nodes += nodes;
+    job.score = score;
+  }
+}
+
+
+// The cards from the best score down, each job as one card with the
+// rest of its run as equals. Equal scores keep the root move order,
+// as SolveBoard finds its cards in that order.
+
+static int OrderIndex(
+  const rootJobType& job,
+  const futureTricks& order)
+{
+  for (int m = 0; m < order.cards; m++)
+    if (order.suit[m] == job.suit &&
+        (job.cards & static_cast<unsigned>(bitMapRank[order.rank[m]] << 2)))
+      return m;
+  return order.cards;
+}
+
+
+static void RootResult(
+  const rootParamType& rootparam,
+  const futureTricks& order,
+  futureTricks * futp)
+{
+  vector<rootJobType> jobs = rootparam.jobs;
+  sort(jobs.begin(), jobs.end(),
+    [&order](const rootJobType& a, const rootJobType& b)
+    {
+      if (a.score != b.score)
+        return a.score > b.score;
+      return OrderIndex(a, order) < OrderIndex(b, order);
+    });
+
+  futp->nodes = rootparam.nodes;
+  futp->cards = static_cast<int>(jobs.size());
+  for (unsigned m = 0; m < jobs.size(); m++)
+  {
+    const rootJobType& job = jobs[m];
+    futp->suit[m] = job.suit;
+    futp->rank[m] = job.rank;
+    futp->equals[m] = static_cast<int>(job.cards &
+      ~static_cast<unsigned>(bitMapRank[job.rank] << 2));
+    futp->score[m] = job.score;
+  }
+}
+
+
+/**
+ * @brief Solve one deal with the root cards spread over all threads.
+ *
+ * For solutions == 3 the threads score the cards of the hand to play
+ * in parallel, and the result is made from those scores. It has the
+ * same cards, equals and scores in the same order as from SolveBoard:
+ * cards with equal scores come in the order of the root move
+ * generator, which is the order in which SolveBoard finds them. The
+ * node count adds up all threads. Other values of
+ * solutions, and a single thread, solve as SolveBoard on thread 0.
+ *
+ * Like the batch functions, it uses all threads, and waits for any
+ * other batch or stream on the same engine to finish.
+ *
+ * @param dl The deal to solve
+ * @param target Target number of tricks
+ * @param solutions Number of solutions to find
+ * @param mode Analysis mode
+ * @param futp Pointer to result structure
+ * @return 1 on success, error code otherwise
+ */
+int STDCALL SolveBoardParallel(
+  deal dl,
+  int target,
+  int solutions,
+  int mode,
+  futureTricks * futp)
+{
+  return SolveBoardParallel(DefaultEngine(), dl, target, solutions,
+    mode, futp);
+}
+
+
+int SolveBoardParallel(
+  EngineState& eng,
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  futureTricks * futp)
+{
+  lock_guard<mutex> lk(eng.runMtx);
+  rootParamType& rootparam = eng.solve.root;
+
+  const int nthreads = eng.sysdep.GetNumThreads();
+  if (eng.contextPool.NumThreads() < static_cast<unsigned>(nthreads))
+    return RETURN_THREAD_INDEX;
+
+  SolverContext& ctx = eng.contextPool.Get(0);
+  if (solutions != 3 || nthreads == 1)
+    return SolveBoard(ctx, dl, target, solutions, mode, futp);
+
+  int ret = BoardRangeChecks(dl, target, solutions, mode);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  const bool useCache =
+    ctx.config().useResultCache && solveCache.Capacity() > 0;
+  const dealFingerprint fp = DealFingerprint(dl, target, solutions, mode);
+  if (useCache && solveCache.Lookup(fp, * futp))
+    return RETURN_NO_FAULT;
+
+  int cardCount = 0;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      cardCount += count_table[dl.remainCards[h][s] >> 2];
+
+  // As in SolveBoardInternal.
+  const int handRelFirst = (52 - cardCount) % 4;
+  rootparam.dl = &dl;
+  rootparam.handRelFirst = handRelFirst;
+  rootparam.handToPlay = handId(dl.first, handRelFirst);
+  rootparam.tricksLeft = (cardCount + handRelFirst) / 4;
+  MakeRootJobs(dl, rootparam.handToPlay, handRelFirst, rootparam.jobs);
+
+  // The last trick, or a single card, gains nothing from threads.
+  if (cardCount <= 4 || rootparam.jobs.size() <= 1)
+    return SolveBoard(ctx, dl, target, solutions, mode, futp);
+
+  futureTricks order;
+  ret = RootMoveOrder(ctx, dl, &order);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  rootparam.next = 0;
+  rootparam.error = RETURN_NO_FAULT;
+  rootparam.nodes = 0;
+  rootparam.estimate = -1;
+
+  ret = eng.sysdep.RunThreads(SolveRootCommon);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  // A bad deal fails in the threads. The plain solve then returns the
+  // same error as SolveBoard.
+  if (rootparam.error != RETURN_NO_FAULT)
+    return SolveBoardInternal(ctx, dl, target, solutions, mode, futp);
+
+  RootResult(rootparam, order, futp);
+  if (useCache)
+    solveCache.Store(fp, * futp);
+  return RETURN_NO_FAULT;
+}
+
+
+int STDCALL SolveBoardPBNParallel(
+  dealPBN dlpbn,
+  int target,
+  int solutions,
+  int mode,
+  futureTricks * futp)
+{
+  deal dl;
+  if (ConvertFromPBN(dlpbn.remainCards, dl.remainCards) != RETURN_NO_FAULT)
+    return RETURN_PBN_FAULT;
+
+  for (int k = 0; k <= 2; k++)
+  {
+    dl.currentTrickRank[k] = dlpbn.currentTrickRank[k];
+    dl.currentTrickSuit[k] = dlpbn.currentTrickSuit[k];
+  }
+  dl.first = dlpbn.first;
+  dl.trump = dlpbn.trump;
+
+  return SolveBoardParallel(dl, target, solutions, mode, futp);
+}
+
+
 /**
  * @brief Solve multiple bridge deals in PBN format.
  *
@@ -234,7 +619,7 @@ int STDCALL SolveAllBoards(
       return RETURN_PBN_FAULT;
   }
 
-  int res = SolveAllBoardsN(bo, * solvedp);
+  int res = SolveAllBoardsN(DefaultEngine(), bo, * solvedp);
   return res;
 }
 
@@ -243,7 +628,16 @@ int STDCALL SolveAllBoardsBin(
   boards * bop,
   solvedBoards * solvedp)
 {
-  return SolveAllBoardsN(* bop, * solvedp);
+  return SolveAllBoardsN(DefaultEngine(), * bop, * solvedp);
+}
+
+
+int SolveAllBoardsBin(
+  boards& bds,
+  solvedBoards& solved,
+  const SearchLimits& limits)
+{
+  return SolveAllBoardsN(DefaultEngine(), bds, solved, limits);
 }
 
 
@@ -282,7 +676,7 @@ int STDCALL SolveAllChunksBin(
   if (chunkSize < 1)
     return RETURN_CHUNK_SIZE;
 
-  return SolveAllBoardsN(* bop, * solvedp);
+  return SolveAllBoardsN(DefaultEngine(), * bop, * solvedp);
 }
 
 
@@ -291,30 +685,49 @@ void DetectSolveDuplicates(
   vector<int>& uniques,
   vector<int>& crossrefs)
 {
+  // One pass with a hash map from fingerprint to the first board that
+  // has it. SameBoard confirms the match, so a fingerprint collision
+  // costs a solve but never a wrong result.
+
   const unsigned nu = static_cast<unsigned>(bds.noOfBoards);
 
   uniques.clear();
   crossrefs.resize(nu);
 
-  for (unsigned i = 0; i < nu; i++)
-    crossrefs[i] = -1;
+  unordered_map<dealFingerprint, unsigned, dealFingerprintHash> seen;
+  seen.reserve(nu);
 
   for (unsigned i = 0; i < nu; i++)
   {
-    if (crossrefs[i] != -1)
-      continue;
+    crossrefs[i] = -1;
 
-    uniques.push_back(static_cast<int>(i));
+    const dealFingerprint fp = DealFingerprint(
+      bds.deals[i], bds.target[i], bds.solutions[i], bds.mode[i]);
 
-    for (unsigned index = i+1; index < nu; index++)
+    auto it = seen.find(fp);
+    if (it == seen.end())
+      seen.emplace(fp, i);
+    else if (SameBoard(bds, it->second, i))
     {
-      if (SameBoard(bds, i, index))
-        crossrefs[index] = static_cast<int>(i);
+      crossrefs[i] = static_cast<int>(it->second);
+      continue;
     }
+
+    uniques.push_back(static_cast<int>(i));
   }
 }
 
 
+void DetectSolveDuplicates(
+  [[maybe_unused]] EngineState& eng,
+  const boards& bds,
+  vector<int>& uniques,
+  vector<int>& crossrefs)
+{
+  DetectSolveDuplicates(bds, uniques, crossrefs);
+}
+
+
 bool SameBoard(
   const boards& bds,
   const unsigned index1,
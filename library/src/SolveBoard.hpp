@@ -10,21 +10,61 @@
 #ifndef DDS_SOLVEBOARD_H
 #define DDS_SOLVEBOARD_H
 
+#include <atomic>
 #include <vector>
 
 #include <api/dll.h>
+#include "SolverIF.hpp"
 
 using namespace std;
 
+struct EngineState;
+
+
+// SolveBoardParallel: the root cards of one deal on all threads.
+
+struct rootJobType
+{
+  int suit;
+  int rank; // Top card of the run
+  unsigned cards; // The run, as in remainCards
+  int score; // For the side to play, once the job is done
+};
+
+struct rootParamType
+{
+  deal const * dl;
+  int handToPlay;
+  int handRelFirst;
+  int tricksLeft; // Including a started trick
+  vector<rootJobType> jobs;
+  atomic<int> next;
+  atomic<int> error;
+  atomic<int> nodes;
+  atomic<int> estimate; // A score already found, or -1
+};
+
+// The solves of one engine that use all of its threads.
+
+struct solveStateType
+{
+  paramType param;
+  rootParamType root;
+  SearchLimits limits; // Of the batch being solved, if any
+};
+
 
 void SolveSingleCommon(
+  EngineState& eng,
   const int thrId,
   const int bno);
 
 void CopySolveSingle(
+  EngineState& eng,
   const vector<int>& crossrefs);
 
 void SolveChunkCommon(
+  EngineState& eng,
   const int thrId);
 
 void DetectSolveDuplicates(
@@ -32,4 +72,27 @@ void DetectSolveDuplicates(
   vector<int>& uniques,
   vector<int>& crossrefs);
 
+void DetectSolveDuplicates(
+  EngineState& eng,
+  const boards& bds,
+  vector<int>& uniques,
+  vector<int>& crossrefs);
+
+// The batch and parallel solves behind the C interface, on the
+// threads of eng. Each holds the run lock of eng while it runs.
+
+int SolveAllBoardsN(
+  EngineState& eng,
+  boards& bds,
+  solvedBoards& solved,
+  const SearchLimits& limits = SearchLimits{});
+
+int SolveBoardParallel(
+  EngineState& eng,
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  futureTricks * futp);
+
 #endif
@@ -0,0 +1,368 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "SolveStream.hpp"
+#include "CalcTables.hpp"
+#include "EngineState.hpp"
+#include <system/System.hpp>
+#include <solver_context/ContextPool.hpp>
+#include <api/SolveBoard.hpp>
+#include <utility/Constants.h>
+
+
+namespace
+{
+
+bool SameCards(
+  const deal& dl1,
+  const deal& dl2)
+{
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      if (dl1.remainCards[h][s] != dl2.remainCards[h][s])
+        return false;
+  return true;
+}
+
+
+bool SameStreamBoard(
+  const streamBoard& bd1,
+  const streamBoard& bd2)
+{
+  if (! SameCards(bd1.dl, bd2.dl))
+    return false;
+
+  if (bd1.target != bd2.target ||
+      bd1.solutions != bd2.solutions ||
+      bd1.mode != bd2.mode ||
+      bd1.dl.first != bd2.dl.first ||
+      bd1.dl.trump != bd2.dl.trump)
+    return false;
+
+  for (int k = 0; k < 3; k++)
+  {
+    if (bd1.dl.currentTrickSuit[k] != bd2.dl.currentTrickSuit[k] ||
+        bd1.dl.currentTrickRank[k] != bd2.dl.currentTrickRank[k])
+      return false;
+  }
+  return true;
+}
+
+
+void SetError(
+  streamParamType& sparam,
+  const int res)
+{
+  if (res == RETURN_NO_FAULT)
+    return;
+
+  int expected = RETURN_NO_FAULT;
+  sparam.error.compare_exchange_strong(expected, res);
+}
+
+
+void ProduceTable(
+  streamParamType& sparam,
+  const ddTableDeal& td)
+{
+  const int index = sparam.produced++;
+  tableAccum& acc = sparam.tables[index];
+  acc.res = {};
+  acc.left = 0;
+  acc.status = RETURN_NO_FAULT;
+
+  streamJob job;
+  job.index = index;
+  job.bd.dl = {};
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      job.bd.dl.remainCards[h][s] = td.cards[h][s];
+  job.bd.target = -1;
+  job.bd.solutions = 1;
+  job.bd.mode = 1;
+
+  for (int tr = DDS_STRAINS-1; tr >= 0; tr--)
+  {
+    if (sparam.skipStrain[tr])
+      continue;
+
+    job.bd.dl.trump = tr;
+    sparam.pending.push_back(job);
+    acc.left++;
+  }
+}
+
+
+void Refill(streamParamType& sparam)
+{
+  // Called with mtx held.
+  while (! sparam.exhausted && sparam.pending.size() < sparam.window)
+  {
+    if (sparam.boardNext)
+    {
+      streamJob job;
+      if (! (*sparam.boardNext)(job.bd))
+        sparam.exhausted = true;
+      else
+      {
+        job.index = sparam.produced++;
+        sparam.pending.push_back(job);
+      }
+    }
+    else
+    {
+      ddTableDeal td;
+      if (! (*sparam.tableNext)(td))
+        sparam.exhausted = true;
+      else
+        ProduceTable(sparam, td);
+    }
+  }
+}
+
+
+bool TakeJob(
+  streamParamType& sparam,
+  const unsigned tu,
+  streamJob& job)
+{
+  lock_guard<mutex> lk(sparam.mtx);
+  Refill(sparam);
+
+  if (sparam.pending.empty())
+    return false;
+
+  // Prefer an exact repeat of the last job, which is only copied, and
+  // then the same cards, so the TT of this thread is still warm.
+  // Otherwise take the oldest job in the window.
+
+  auto it = sparam.pending.begin();
+  const lastType& last = sparam.last[tu];
+  if (last.valid)
+  {
+    auto same = sparam.pending.end();
+    for (auto jt = sparam.pending.begin(); jt != sparam.pending.end(); jt++)
+    {
+      if (! SameCards(jt->bd.dl, last.bd.dl))
+        continue;
+
+      if (SameStreamBoard(jt->bd, last.bd))
+      {
+        same = jt;
+        break;
+      }
+      else if (same == sparam.pending.end())
+        same = jt;
+    }
+
+    if (same != sparam.pending.end())
+      it = same;
+  }
+
+  job = * it;
+  sparam.pending.erase(it);
+  return true;
+}
+
+
+void SolveStreamCommon(
+  EngineState& eng,
+  const int thrId)
+{
+  streamParamType& sparam = eng.stream;
+  const unsigned tu = static_cast<unsigned>(thrId);
+  SolverContext& ctx = eng.contextPool.Get(tu);
+  lastType& last = sparam.last[tu];
+  streamJob job;
+
+  while (TakeJob(sparam, tu, job))
+  {
+    if (! last.valid || ! SameStreamBoard(job.bd, last.bd))
+    {
+      last.status = SolveBoard(
+                      ctx,
+                      job.bd.dl,
+                      job.bd.target,
+                      job.bd.solutions,
+                      job.bd.mode,
+                      &last.fut);
+      last.bd = job.bd;
+      last.valid = true;
+    }
+
+    SetError(sparam, last.status);
+
+    lock_guard<mutex> lk(sparam.emitMtx);
+    (*sparam.boardDone)(job.index, last.status, last.fut);
+  }
+}
+
+
+void CalcStreamCommon(
+  EngineState& eng,
+  const int thrId)
+{
+  streamParamType& sparam = eng.stream;
+  const unsigned tu = static_cast<unsigned>(thrId);
+  SolverContext& ctx = eng.contextPool.Get(tu);
+  lastType& last = sparam.last[tu];
+  streamJob job;
+
+  while (TakeJob(sparam, tu, job))
+  {
+    // The same table may well occur twice in a stream, and then the
+    // strains in the two tables run back-to-back on this thread.
+
+    if (! last.valid || ! SameStreamBoard(job.bd, last.bd))
+    {
+      last.bd = job.bd;
+      last.valid = true;
+      last.status = CalcSingleDeal(
+                      ctx,
+                      last.bd.dl,
+                      job.bd.target,
+                      job.bd.solutions,
+                      job.bd.mode,
+                      last.fut.score);
+      last.bd.dl.first = job.bd.dl.first;
+    }
+
+    SetError(sparam, last.status);
+
+    const int strain = job.bd.dl.trump;
+    ddTableResults table;
+    int status;
+    {
+      lock_guard<mutex> lk(sparam.mtx);
+      tableAccum& acc = sparam.tables[job.index];
+
+      for (int first = 0; first < DDS_HANDS; first++)
+        acc.res.resTable[strain][ rho[first] ] =
+          13 - last.fut.score[first];
+
+      if (last.status != RETURN_NO_FAULT)
+        acc.status = last.status;
+
+      if (--acc.left > 0)
+        continue;
+
+      table = acc.res;
+      status = acc.status;
+      sparam.tables.erase(job.index);
+    }
+
+    lock_guard<mutex> lk(sparam.emitMtx);
+    (*sparam.tableDone)(job.index, status, table);
+  }
+}
+
+
+int RunStream(
+  EngineState& eng,
+  const fptrType fptr,
+  const int window)
+{
+  // The caller holds the run lock of eng.
+  streamParamType& sparam = eng.stream;
+  const unsigned nu = static_cast<unsigned>(eng.sysdep.GetNumThreads());
+  if (eng.contextPool.NumThreads() < nu)
+    return RETURN_THREAD_INDEX;
+
+  sparam.pending.clear();
+  sparam.tables.clear();
+  sparam.exhausted = false;
+  sparam.produced = 0;
+  sparam.window = static_cast<unsigned>(
+    window > 0 ? window : MAXNOOFBOARDS);
+  sparam.error = RETURN_NO_FAULT;
+
+  sparam.last.resize(nu);
+  for (auto& l: sparam.last)
+    l.valid = false;
+
+  const int retRun = eng.sysdep.RunThreads(fptr);
+
+  sparam.pending.clear();
+  sparam.tables.clear();
+
+  if (retRun != RETURN_NO_FAULT)
+    return retRun;
+
+  return sparam.error;
+}
+
+}
+
+
+int SolveBoardStream(
+  const BoardProducer& next,
+  const BoardConsumer& done,
+  const int window)
+{
+  return SolveBoardStream(DefaultEngine(), next, done, window);
+}
+
+
+int SolveBoardStream(
+  EngineState& eng,
+  const BoardProducer& next,
+  const BoardConsumer& done,
+  const int window)
+{
+  lock_guard<mutex> lk(eng.runMtx);
+  streamParamType& sparam = eng.stream;
+
+  sparam.boardNext = &next;
+  sparam.boardDone = &done;
+  sparam.tableNext = nullptr;
+  sparam.tableDone = nullptr;
+
+  return RunStream(eng, SolveStreamCommon, window);
+}
+
+
+int CalcTableStream(
+  const TableProducer& next,
+  const TableConsumer& done,
+  const int trumpFilter[DDS_STRAINS],
+  const int window)
+{
+  return CalcTableStream(DefaultEngine(), next, done, trumpFilter, window);
+}
+
+
+int CalcTableStream(
+  EngineState& eng,
+  const TableProducer& next,
+  const TableConsumer& done,
+  const int trumpFilter[DDS_STRAINS],
+  const int window)
+{
+  lock_guard<mutex> lk(eng.runMtx);
+  streamParamType& sparam = eng.stream;
+
+  bool okey = false;
+  for (int k = 0; k < DDS_STRAINS; k++)
+  {
+    sparam.skipStrain[k] = (trumpFilter != nullptr && trumpFilter[k]);
+    if (! sparam.skipStrain[k])
+      okey = true;
+  }
+
+  if (! okey)
+    return RETURN_NO_SUIT;
+
+  sparam.boardNext = nullptr;
+  sparam.boardDone = nullptr;
+  sparam.tableNext = &next;
+  sparam.tableDone = &done;
+
+  return RunStream(eng, CalcStreamCommon, window);
+}
@@ -0,0 +1,88 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_SOLVESTREAM_H
+#define DDS_SOLVESTREAM_H
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <api/SolveStream.hpp>
+
+using namespace std;
+
+struct EngineState;
+
+
+struct streamJob
+{
+  int index; // Position of the board or table in the stream
+  streamBoard bd;
+};
+
+struct lastType
+{
+  bool valid;
+  streamBoard bd;
+  futureTricks fut;
+  int status;
+};
+
+struct tableAccum
+{
+  ddTableResults res;
+  int left;
+  int status;
+};
+
+// The stream running on one engine.
+
+struct streamParamType
+{
+  mutex mtx;
+  deque<streamJob> pending;
+  bool exhausted;
+  int produced;
+  unsigned window;
+
+  BoardProducer const * boardNext;
+  BoardConsumer const * boardDone;
+  TableProducer const * tableNext;
+  TableConsumer const * tableDone;
+
+  bool skipStrain[DDS_STRAINS];
+  map<int, tableAccum> tables; // In progress, guarded by mtx
+
+  // Last deal solved by each thread, for preference and repeats.
+  vector<lastType> last;
+
+  mutex emitMtx;
+  atomic<int> error;
+};
+
+// SolveBoardStream and CalcTableStream on the threads of eng. Each
+// holds the run lock of eng while it runs.
+
+int SolveBoardStream(
+  EngineState& eng,
+  const BoardProducer& next,
+  const BoardConsumer& done,
+  const int window);
+
+int CalcTableStream(
+  EngineState& eng,
+  const TableProducer& next,
+  const TableConsumer& done,
+  const int trumpFilter[DDS_STRAINS],
+  const int window);
+
+#endif
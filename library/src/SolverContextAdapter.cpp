@@ -1,6 +1,15 @@
 #include <solver_context/SolverContext.hpp>
+#include <system/ResultCache.hpp>
 #include "SolverIF.hpp"
 
+extern ResultCache solveCache;
+
+int BoardRangeChecks(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode);
+
 int SolveBoard(
   SolverContext& ctx,
   const deal& dl,
@@ -11,5 +20,22 @@ int SolveBoard(
 {
   // Use ThreadData-attached TT so all contexts created in lower layers
   // observe the same table. No ownership adoption to avoid duplication.
-  return SolveBoardInternal(ctx, dl, target, solutions, mode, futp);
+  if (! ctx.config().useResultCache || solveCache.Capacity() == 0)
+    return SolveBoardInternal(ctx, dl, target, solutions, mode, futp);
+
+  // Invalid input gets its error, never a cached result.
+  const int ret = BoardRangeChecks(dl, target, solutions, mode);
+  if (ret != RETURN_NO_FAULT)
+    return ret;
+
+  // A deal that was solved before in this process is answered from
+  // the cache. Only successful results are stored.
+  const dealFingerprint fp = DealFingerprint(dl, target, solutions, mode);
+  if (solveCache.Lookup(fp, * futp))
+    return RETURN_NO_FAULT;
+
+  const int res = SolveBoardInternal(ctx, dl, target, solutions, mode, futp);
+  if (res == RETURN_NO_FAULT)
+    solveCache.Store(fp, * futp);
+  return res;
 }
@@ -0,0 +1,206 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "EngineState.hpp"
+#include <api/SolverEngine.hpp>
+
+
+struct SolverEngine::Impl
+{
+  System sysdep;
+  Memory memory;
+  Scheduler scheduler;
+  ContextPool contextPool;
+  EngineState state;
+
+  Impl()
+    : sysdep(MakeSystem()),
+      state(sysdep, memory, scheduler, contextPool)
+  {
+  }
+};
+
+
+SolverEngine::SolverEngine(
+  const int maxMemoryMB,
+  const int maxThreads)
+  : impl_(std::make_unique<Impl>())
+{
+  state_ = &impl_->state;
+  SetEngineResources(* state_, maxMemoryMB, maxThreads);
+}
+
+
+SolverEngine::SolverEngine(EngineState& state)
+  : state_(&state)
+{
+}
+
+
+SolverEngine::~SolverEngine()
+{
+  // The threads are joined before the state they work on goes.
+  if (impl_)
+    FreeEngineMemory(* state_);
+}
+
+
+SolverEngine& SolverEngine::Default()
+{
+  static SolverEngine engine(DefaultEngine());
+  return engine;
+}
+
+
+void SolverEngine::SetResources(
+  const int maxMemoryMB,
+  const int maxThreads)
+{
+  SetEngineResources(* state_, maxMemoryMB, maxThreads);
+}
+
+
+int SolverEngine::SetThreading(const int code)
+{
+  lock_guard<mutex> lk(state_->runMtx);
+
+  // Only the default engine may use the process-wide backends.
+  const unsigned ucode = static_cast<unsigned>(code);
+  if (impl_ && state_->sysdep.IsProcessWide(ucode))
+    return RETURN_THREAD_MISSING;
+
+  return state_->sysdep.PreferThreading(ucode);
+}
+
+
+void SolverEngine::FreeMemory()
+{
+  FreeEngineMemory(* state_);
+}
+
+
+int SolverEngine::NumThreads() const
+{
+  return state_->sysdep.GetNumThreads();
+}
+
+
+int SolverEngine::SolveBoard(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  futureTricks * futp,
+  const int thrId)
+{
+  return ::SolveBoard(* state_, dl, target, solutions, mode, futp, thrId);
+}
+
+
+int SolverEngine::SolveBoardParallel(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  futureTricks * futp)
+{
+  return ::SolveBoardParallel(* state_, dl, target, solutions, mode, futp);
+}
+
+
+int SolverEngine::SolveAllBoardsBin(
+  boards& bds,
+  solvedBoards& solved)
+{
+  return SolveAllBoardsN(* state_, bds, solved);
+}
+
+
+int SolverEngine::SolveAllBoardsBin(
+  boards& bds,
+  solvedBoards& solved,
+  const SearchLimits& limits)
+{
+  return SolveAllBoardsN(* state_, bds, solved, limits);
+}
+
+
+int SolverEngine::CalcDDtable(
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep)
+{
+  return ::CalcDDtable(* state_, tableDeal, tablep);
+}
+
+
+int SolverEngine::CalcDDtableParallel(
+  const ddTableDeal& tableDeal,
+  ddTableResults * tablep)
+{
+  return ::CalcDDtableParallel(* state_, tableDeal, tablep);
+}
+
+
+int SolverEngine::CalcAllTables(
+  const ddTableDeals& deals,
+  const int mode,
+  const int trumpFilter[DDS_STRAINS],
+  ddTablesRes * resp,
+  allParResults * presp)
+{
+  return ::CalcAllTables(* state_, deals, mode, trumpFilter, resp, presp);
+}
+
+
+int SolverEngine::AnalysePlayBin(
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp,
+  const int thrId)
+{
+  return ::AnalysePlayBin(* state_, dl, play, solvedp, thrId);
+}
+
+
+int SolverEngine::AnalysePlayBinParallel(
+  const deal& dl,
+  const playTraceBin& play,
+  solvedPlay * solvedp)
+{
+  return ::AnalysePlayBinParallel(* state_, dl, play, solvedp);
+}
+
+
+int SolverEngine::AnalyseAllPlaysBin(
+  boards& bds,
+  playTracesBin& plays,
+  solvedPlays& solved)
+{
+  return ::AnalyseAllPlaysBin(* state_, &bds, &plays, &solved);
+}
+
+
+int SolverEngine::SolveBoardStream(
+  const BoardProducer& next,
+  const BoardConsumer& done,
+  const int window)
+{
+  return ::SolveBoardStream(* state_, next, done, window);
+}
+
+
+int SolverEngine::CalcTableStream(
+  const TableProducer& next,
+  const TableConsumer& done,
+  const int trumpFilter[DDS_STRAINS],
+  const int window)
+{
+  return ::CalcTableStream(* state_, next, done, trumpFilter, window);
+}
@@ -22,14 +22,33 @@ int SolveBoardInternal(
   const int mode,
   futureTricks * futp);
 
+// The cards of the hand to play in the order in which SolveBoard
+// lists equal scores.
+int RootMoveOrder(
+  SolverContext& ctx,
+  const deal& dl,
+  futureTricks * futp);
+
+struct EngineState;
+
+// SolveBoard on the context of thread thrId of eng.
+int SolveBoard(
+  EngineState& eng,
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode,
+  futureTricks * futp,
+  const int thrId);
+
 int SolveSameBoard(
-  const std::shared_ptr<ThreadData>& thrp,
+  SolverContext& ctx,
   const deal& dl,
   futureTricks * futp,
   const int hint);
 
 int AnalyseLaterBoard(
-  const std::shared_ptr<ThreadData>& thrp,
+  SolverContext& ctx,
   const int leadHand,
   moveType const * move,
   const int hint,
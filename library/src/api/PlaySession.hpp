@@ -0,0 +1,83 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_PLAYSESSION_HPP
+#define DDS_PLAYSESSION_HPP
+
+#include <memory>
+
+#include <api/dll.h>
+#include <solver_context/SolverContext.hpp>
+
+// C++-only live counterpart of AnalysePlayBin. The cards arrive one
+// at a time, and each one costs a single re-solve of the position
+// after it. The session keeps its own SolverContext, so the
+// transposition table and the move ordering state carry over from
+// card to card.
+//
+// As in AnalysePlayBin, tricks are counted for declarer, the side that
+// is not on lead when the session starts, and include the tricks that
+// declarer has already won. A session may be used from one thread at
+// a time, and several sessions may run side by side.
+
+struct playCardResult
+{
+  // Double dummy tricks for declarer after the card.
+  int tricks;
+  // Tricks the card gave away for the side that played it; 0 for a
+  // double dummy best card.
+  int cost;
+  // The hand that played the card, and the hand to play next.
+  int player;
+  int next;
+};
+
+class PlaySession
+{
+  public:
+
+    explicit PlaySession(const SolverConfig& cfg = {});
+
+    ~PlaySession();
+
+    PlaySession(const PlaySession&) = delete;
+    PlaySession& operator=(const PlaySession&) = delete;
+
+    // Solves the deal, which may have a trick in progress. Any earlier
+    // play is forgotten. Returns RETURN_NO_FAULT or an error code as
+    // from SolveBoard.
+    int Start(const deal& dl);
+
+    // Plays the next card. RETURN_PLAY_FAULT if the hand to play does
+    // not hold it, does not follow suit, or the hand is over; the
+    // session is then unchanged.
+    int Play(
+      const int suit,
+      const int rank,
+      playCardResult * resp = nullptr);
+
+    // Double dummy tricks for declarer in the current position.
+    int Tricks() const;
+
+    // The hand to play next, or -1 before Start.
+    int NextHand() const;
+
+    // Cards passed to Play since Start.
+    int CardsPlayed() const;
+
+    // True when all cards are played.
+    bool Done() const;
+
+  private:
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif // DDS_PLAYSESSION_HPP
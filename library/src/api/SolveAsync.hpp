@@ -0,0 +1,78 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_SOLVEASYNC_HPP
+#define DDS_SOLVEASYNC_HPP
+
+#include <functional>
+#include <future>
+
+#include <api/dll.h>
+#include <api/SolveStream.hpp>
+
+// C++-only asynchronous counterparts of SolveBoard and CalcDDtable.
+// A submission returns at once, and the result arrives through a
+// callback or a std::future. The C interface is SolveBoardAsync and
+// CalcDDtableAsync in dll.h.
+//
+// Submissions from all threads go to one queue. Whenever the queue is
+// not empty, a dispatcher thread hands it to SolveBoardStream or
+// CalcTableStream. Requests that arrive while a stream runs join it
+// if it is still reading the queue, and otherwise start the next
+// stream together. So small requests from many clients are solved as
+// batches, on all solver threads, with the stream's preference for
+// warm transposition tables and its copying of repeats.
+//
+// Callbacks run on the solver threads, one at a time, with
+// RETURN_NO_FAULT or an error code. They should return quickly. They
+// may submit more work, but must not wait for async results.
+//
+// The requests run on the solver threads of the default engine, so
+// batch and stream functions on it wait for the current stream. While
+// any are outstanding, do not call SolveBoard with a thread index;
+// WaitAllAsync waits until all requests are done. A SolverEngine of
+// its own keeps other work off these threads. FreeMemory also waits
+// for them, and stops the thread that hands them to the engine; the
+// next request starts it again.
+
+struct asyncBoardResult
+{
+  int status;
+  futureTricks fut;
+};
+
+struct asyncTableResult
+{
+  int status;
+  ddTableResults table;
+};
+
+using BoardCallback = std::function<void(
+  int status,
+  const futureTricks& fut)>;
+
+using TableCallback = std::function<void(
+  int status,
+  const ddTableResults& table)>;
+
+void SubmitBoard(
+  const streamBoard& bd,
+  BoardCallback done);
+
+std::future<asyncBoardResult> SubmitBoard(
+  const streamBoard& bd);
+
+void SubmitTable(
+  const ddTableDeal& td,
+  TableCallback done);
+
+std::future<asyncTableResult> SubmitTable(
+  const ddTableDeal& td);
+
+#endif // DDS_SOLVEASYNC_HPP
@@ -22,4 +22,13 @@ int SolveBoard(
   const int mode,
   futureTricks* futp);
 
+// SolveAllBoardsBin with limits on the whole batch. Once they are hit,
+// the boards being solved stop, the remaining ones are skipped, and the
+// call returns RETURN_TIMEOUT or RETURN_CANCELLED. Boards that did not
+// finish are left with cards == 0.
+int SolveAllBoardsBin(
+  boards& bds,
+  solvedBoards& solved,
+  const SearchLimits& limits);
+
 #endif // DDS_SOLVEBOARD_HPP
@@ -0,0 +1,74 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_SOLVESTREAM_HPP
+#define DDS_SOLVESTREAM_HPP
+
+#include <functional>
+
+#include <api/dll.h>
+
+// C++-only streaming counterparts of SolveAllBoardsBin and
+// CalcAllTables. There is no limit on the number of deals: the
+// producer is drained into a look-ahead window, the worker threads
+// stay busy until the stream is empty, and each result is handed
+// to the consumer as soon as it is known.
+//
+// The producer is called under a lock, so it need not be thread-safe.
+// It fills in the next item and returns true, or returns false at the
+// end of the stream. The consumer is called from the worker threads,
+// one call at a time, with the 0-based position of the item in the
+// stream, RETURN_NO_FAULT or an error code, and the result. Results
+// arrive out of order.
+//
+// Within the window, a thread prefers deals with the same cards as the
+// one it just solved (other strains, declarers, targets), so that they
+// run on a warm transposition table, and exact repeats are copied.
+// window <= 0 means MAXNOOFBOARDS deals.
+//
+// Like the batch calls, a stream waits for any other stream or batch
+// on the same engine (see SolverEngine.hpp).
+// The return value is RETURN_NO_FAULT, or the first error seen.
+
+struct streamBoard
+{
+  deal dl;
+  int target;
+  int solutions;
+  int mode;
+};
+
+using BoardProducer = std::function<bool(streamBoard& bd)>;
+
+using BoardConsumer = std::function<void(
+  int index,
+  int status,
+  const futureTricks& fut)>;
+
+using TableProducer = std::function<bool(ddTableDeal& td)>;
+
+using TableConsumer = std::function<void(
+  int index,
+  int status,
+  const ddTableResults& table)>;
+
+int SolveBoardStream(
+  const BoardProducer& next,
+  const BoardConsumer& done,
+  const int window = 0);
+
+// trumpFilter works as in CalcAllTables: a non-zero entry skips that
+// strain, whose table entries are then left at 0.
+int CalcTableStream(
+  const TableProducer& next,
+  const TableConsumer& done,
+  const int trumpFilter[DDS_STRAINS] = nullptr,
+  const int window = 0);
+
+#endif // DDS_SOLVESTREAM_HPP
@@ -0,0 +1,144 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_SOLVERENGINE_HPP
+#define DDS_SOLVERENGINE_HPP
+
+#include <memory>
+
+#include <api/dll.h>
+#include <api/SolveStream.hpp>
+#include <solver_context/SolverContext.hpp>
+
+struct EngineState;
+
+// C++-only owner of a set of solver threads. Each engine has its own
+// threads, scheduler, per-thread solver contexts and transposition
+// tables, so batches on different engines run side by side in one
+// process. The functions are those of the C interface, which runs on
+// SolverEngine::Default().
+//
+// The calls that use all threads of an engine (the batch, parallel
+// and stream functions, and SetResources) wait for each other, so an
+// engine runs one of them at a time. For several at once, use several
+// engines, each with its share of the cores. The result caches
+// (SetResultCacheSize) and the shared transposition table
+// (SetSharedTTSize) are process-wide, and all engines use them.
+//
+// The Windows, OpenMP and GCD threading backends use process-wide
+// thread pools or settings, and the IMPL backends map OS threads to
+// thread indices process-wide. They only work with the default
+// engine; SetThreading on any other engine returns
+// RETURN_THREAD_MISSING for them.
+
+class SolverEngine
+{
+  public:
+
+    // Sets up threads and memory as SetResources does.
+    explicit SolverEngine(
+      const int maxMemoryMB = 0,
+      const int maxThreads = 0);
+
+    ~SolverEngine();
+
+    SolverEngine(const SolverEngine&) = delete;
+    SolverEngine& operator=(const SolverEngine&) = delete;
+
+    // The engine behind the C interface.
+    static SolverEngine& Default();
+
+    void SetResources(
+      const int maxMemoryMB,
+      const int maxThreads);
+
+    int SetThreading(const int code);
+
+    // Frees the memory of the engine's threads. They start again with
+    // the next run.
+    void FreeMemory();
+
+    int NumThreads() const;
+
+    int SolveBoard(
+      const deal& dl,
+      const int target,
+      const int solutions,
+      const int mode,
+      futureTricks * futp,
+      const int thrId);
+
+    int SolveBoardParallel(
+      const deal& dl,
+      const int target,
+      const int solutions,
+      const int mode,
+      futureTricks * futp);
+
+    int SolveAllBoardsBin(
+      boards& bds,
+      solvedBoards& solved);
+
+    int SolveAllBoardsBin(
+      boards& bds,
+      solvedBoards& solved,
+      const SearchLimits& limits);
+
+    int CalcDDtable(
+      const ddTableDeal& tableDeal,
+      ddTableResults * tablep);
+
+    int CalcDDtableParallel(
+      const ddTableDeal& tableDeal,
+      ddTableResults * tablep);
+
+    int CalcAllTables(
+      const ddTableDeals& deals,
+      const int mode,
+      const int trumpFilter[DDS_STRAINS],
+      ddTablesRes * resp,
+      allParResults * presp);
+
+    int AnalysePlayBin(
+      const deal& dl,
+      const playTraceBin& play,
+      solvedPlay * solvedp,
+      const int thrId);
+
+    int AnalysePlayBinParallel(
+      const deal& dl,
+      const playTraceBin& play,
+      solvedPlay * solvedp);
+
+    int AnalyseAllPlaysBin(
+      boards& bds,
+      playTracesBin& plays,
+      solvedPlays& solved);
+
+    int SolveBoardStream(
+      const BoardProducer& next,
+      const BoardConsumer& done,
+      const int window = 0);
+
+    int CalcTableStream(
+      const TableProducer& next,
+      const TableConsumer& done,
+      const int trumpFilter[DDS_STRAINS] = nullptr,
+      const int window = 0);
+
+  private:
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_; // Not set for the default engine
+    EngineState * state_;
+
+    explicit SolverEngine(EngineState& state);
+};
+
+#endif // DDS_SOLVERENGINE_HPP
@@ -125,9 +125,12 @@ struct absRankType // 2 bytes
   signed char hand;
 };
 
-struct relRanksType // 120 bytes
+struct cardHoldersType // 60 bytes
 {
-  absRankType absRank[15][DDS_SUITS];
+  // hand[suit][absolute rank] is the hand holding that card in the
+  // deal being solved, 0 for a card that no hand holds, and -1 for
+  // the absent rank 0.
+  signed char hand[DDS_SUITS][15];
 };
 
 struct paramType
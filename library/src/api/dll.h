@@ -153,6 +153,14 @@
 #define RETURN_CHUNK_SIZE -301
 #define TEXT_CHUNK_SIZE "Chunk size is less than 1"
 
+// Solves on a SolverContext with SearchLimits, and batches run
+// under them: the deadline passed or the cancel flag was set.
+#define RETURN_TIMEOUT -401
+#define TEXT_TIMEOUT "Search stopped at its deadline"
+
+#define RETURN_CANCELLED -402
+#define TEXT_CANCELLED "Search was cancelled"
+
 
 
 /**
@@ -411,11 +419,29 @@ struct DDSInfo
   char systemString[1024];
 };
 
+struct resultCacheStats
+{
+  // Counters since the last FreeMemory.
+  long long hits;
+  long long misses;
+  long long evictions;
+
+  // Current and maximum number of cached results.
+  int entries;
+  int capacity;
+};
+
 
 
 /**
  * @brief Set the maximum number of threads used by the solver.
  *
+ * With the STL backend (built with DDS_THREADS_STL, in Bazel
+ * --define=threads=stl), this starts persistent worker threads that
+ * are kept between batches until FreeMemory. The other backends start
+ * their threads for each batch. Workers are not pinned to CPUs; the
+ * operating system places them.
+ *
  * @param userThreads Maximum number of threads to use
  */
 EXTERN_C DLLEXPORT void STDCALL SetMaxThreads(
@@ -442,9 +468,55 @@ EXTERN_C DLLEXPORT void STDCALL SetResources(
 
 /**
  * @brief Free memory used by the solver.
+ *
+ * Waits for the queued async requests first, and stops the thread
+ * that dispatches them. Not to be called from an async callback.
  */
 EXTERN_C DLLEXPORT void STDCALL FreeMemory();
 
+/**
+ * @brief Set the size of the solved-result caches.
+ *
+ * SolveBoard and the table calculations look up each deal in a
+ * process-wide cache before searching it. Each of the two caches holds
+ * up to maxEntries results and evicts the least recently used one.
+ * The caches are off until this is called. A result takes about 250
+ * bytes, so 65536 entries are of the order of 16 MB.
+ *
+ * @param maxEntries Results per cache, 0 or less to turn them off
+ */
+EXTERN_C DLLEXPORT void STDCALL SetResultCacheSize(
+  int maxEntries);
+
+/**
+ * @brief Get hit, miss and eviction counts of the result caches.
+ *
+ * @param solvep Counters of the SolveBoard cache
+ * @param tablep Counters of the table (all declarers) cache
+ */
+EXTERN_C DLLEXPORT void STDCALL GetResultCacheStats(
+  struct resultCacheStats * solvep,
+  struct resultCacheStats * tablep);
+
+/**
+ * @brief Let the solver threads share search results.
+ *
+ * Experimental, and off by default. Threads with a large
+ * transposition table also store and look up exact positions in one
+ * process-wide lock-free table of the given size. Entries are kept
+ * per strain, as the tricks a position is worth depend on it, so the
+ * five strains of a table never share. Sharing helps only when several
+ * threads search the same deal and strain, as SolveBoardParallel does,
+ * and there it saves a few percent of the nodes.
+ * It waits for the batch, parallel and stream functions that are
+ * running on any engine. SolveBoard with a thread index, and solves on
+ * the caller's own SolverContexts, must not run at the same time.
+ *
+ * @param megabytes Size of the shared table, 0 or less to turn it off
+ */
+EXTERN_C DLLEXPORT void STDCALL SetSharedTTSize(
+  int megabytes);
+
 /**
  * @brief Solve a single bridge deal using double dummy analysis.
  *
@@ -483,6 +555,28 @@ EXTERN_C DLLEXPORT int STDCALL SolveBoardPBN(
   struct futureTricks * futp,
   int thrId);
 
+/**
+ * @brief Solve one deal with the root cards spread over all threads.
+ *
+ * For solutions == 3 this cuts the time of a single deal. The result
+ * has the same cards, scores and card order as from SolveBoard. Other
+ * calls run as SolveBoard on thread 0. Like the batch functions, it must
+ * not run at the same time as another batch call.
+ */
+EXTERN_C DLLEXPORT int STDCALL SolveBoardParallel(
+  struct deal dl,
+  int target,
+  int solutions,
+  int mode,
+  struct futureTricks * futp);
+
+EXTERN_C DLLEXPORT int STDCALL SolveBoardPBNParallel(
+  struct dealPBN dlPBN,
+  int target,
+  int solutions,
+  int mode,
+  struct futureTricks * futp);
+
 /**
  * @brief Calculate the double dummy table for a given deal.
  *
@@ -505,6 +599,23 @@ EXTERN_C DLLEXPORT int STDCALL CalcDDtablePBN(
   struct ddTableDealPBN tableDealPBN,
   struct ddTableResults * tablep);
 
+/**
+ * @brief Calculate the double dummy table of one deal on all threads.
+ *
+ * The same table as CalcDDtable, but each strain and declarer is a
+ * job of its own, so that all threads help and not only one per
+ * strain. Scores already found for a strain seed the searches of the
+ * other declarers. Like the batch functions, it must not run at the
+ * same time as another batch call.
+ */
+EXTERN_C DLLEXPORT int STDCALL CalcDDtableParallel(
+  struct ddTableDeal tableDeal,
+  struct ddTableResults * tablep);
+
+EXTERN_C DLLEXPORT int STDCALL CalcDDtablePBNParallel(
+  struct ddTableDealPBN tableDealPBN,
+  struct ddTableResults * tablep);
+
 /**
  * @brief Calculate double dummy tables for multiple deals.
  *
@@ -628,6 +739,23 @@ EXTERN_C DLLEXPORT int STDCALL AnalysePlayPBN(
   struct solvedPlay * solvedp,
   int thrId);
 
+/**
+ * @brief Analyze one play trace on all solver threads.
+ *
+ * The same as AnalysePlayBin, but the positions of the trace are solved
+ * in parallel, which cuts the time for one long trace. Like the batch
+ * functions, it must not run at the same time as another batch call.
+ */
+EXTERN_C DLLEXPORT int STDCALL AnalysePlayBinParallel(
+  struct deal dl,
+  struct playTraceBin play,
+  struct solvedPlay * solvedp);
+
+EXTERN_C DLLEXPORT int STDCALL AnalysePlayPBNParallel(
+  struct dealPBN dlPBN,
+  struct playTracePBN playPBN,
+  struct solvedPlay * solvedp);
+
 EXTERN_C DLLEXPORT int STDCALL AnalyseAllPlaysBin(
   struct boards * bop,
   struct playTracesBin * plp,
@@ -640,6 +768,53 @@ EXTERN_C DLLEXPORT int STDCALL AnalyseAllPlaysPBN(
   struct solvedPlays * solvedp,
   int chunkSize);
 
+typedef void (STDCALL * SolveBoardCallback)(
+  void * user,
+  int status,
+  const struct futureTricks * futp);
+
+typedef void (STDCALL * CalcDDtableCallback)(
+  void * user,
+  int status,
+  const struct ddTableResults * tablep);
+
+/**
+ * @brief Queue a deal for solving and return at once.
+ *
+ * Requests from all threads are solved together in batches on the
+ * solver threads. The callback is then called on one of them, one
+ * call at a time, with the user pointer, 1 or an error code, and the
+ * result. It must not wait for other async results. While requests
+ * are outstanding, do not call the other multi-threaded functions or
+ * SolveBoard with a thread index; see WaitAllAsync.
+ *
+ * @return 1 when queued, RETURN_UNKNOWN_FAULT without a callback
+ */
+EXTERN_C DLLEXPORT int STDCALL SolveBoardAsync(
+  struct deal dl,
+  int target,
+  int solutions,
+  int mode,
+  SolveBoardCallback callback,
+  void * user);
+
+/**
+ * @brief Queue a deal for a double dummy table and return at once.
+ *
+ * As SolveBoardAsync, with the table of CalcDDtable as the result.
+ */
+EXTERN_C DLLEXPORT int STDCALL CalcDDtableAsync(
+  struct ddTableDeal tableDeal,
+  CalcDDtableCallback callback,
+  void * user);
+
+/**
+ * @brief Wait until all queued async requests have completed.
+ *
+ * Not to be called from a callback.
+ */
+EXTERN_C DLLEXPORT void STDCALL WaitAllAsync();
+
 EXTERN_C DLLEXPORT void STDCALL GetDDSInfo(
   struct DDSInfo * info);
 
@@ -1,6 +1,7 @@
 #include "internal.hpp"
 #include <utility/Constants.h>
 #include <lookup_tables/LookupTables.hpp>
+#include <lookup_tables/CardHolders.hpp>
 
 // New overload: accepts a pre-built HeuristicContext. This contains the
 // same inline logic that used to be in the previous function body.
@@ -273,7 +274,7 @@ void WeightAllocTrump0(HeuristicContext& context)
          the side of the hand has the highest card in the next round
          playing this suit. */
 
-      int thirdBestHand = context.thrp_rel[aggr].absRank[3][context.suit].hand;
+      int thirdBestHand = abs_rank(context.holders, aggr, 3, context.suit).hand;
 
       if ((context.tpos.secondBest[context.suit].hand == partner[context.leadHand]) &&
           (partner[context.leadHand] == thirdBestHand))
@@ -431,7 +432,7 @@ void WeightAllocNT0(HeuristicContext& context) {
          that the side of the hand has the highest card in the
          next round playing this suit. */
 
-      int thirdBestHand = context.thrp_rel[aggr].absRank[3][context.suit].hand;
+      int thirdBestHand = abs_rank(context.holders, aggr, 3, context.suit).hand;
 
       if ((context.tpos.secondBest[context.suit].hand == partner[context.leadHand]) &&
           (partner[context.leadHand] == thirdBestHand))
@@ -20,7 +20,7 @@ struct HeuristicContext {
     const pos& tpos;
     const moveType& bestMove;
     const moveType& bestMoveTT;
-    const relRanksType* thrp_rel;
+    const cardHoldersType& holders;
     moveType* mply;
     int numMoves;
     int lastNumMoves;
@@ -0,0 +1,65 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_LOOKUP_TABLES_CARDHOLDERS_H
+#define DDS_LOOKUP_TABLES_CARDHOLDERS_H
+
+#include <api/dds.h>
+#include <lookup_tables/LookupTables.hpp>
+#include <utility/Constants.h>
+
+#if defined(__BMI2__)
+  #include <immintrin.h>
+#endif
+
+/**
+ * \brief Absolute rank (2..14) of the k-th highest card in aggr.
+ *
+ * Returns 0 if aggr has fewer than k cards. With BMI2 the card is
+ * deposited directly into aggr; otherwise the higher cards are
+ * stripped one at a time, which is cheap for the k <= 3 that the
+ * search asks for.
+ */
+inline auto kth_highest_rank(
+  const unsigned aggr,
+  const int k) -> int
+{
+#if defined(__BMI2__)
+  const int n = count_table[aggr];
+  if (n < k)
+    return 0;
+  return 2 + __builtin_ctz(_pdep_u32(1u << (n - k), aggr));
+#else
+  unsigned rest = aggr;
+  for (int c = 1; c < k; c++)
+    rest ^= bitMapRank[ highest_rank[rest] ];
+  return highest_rank[rest];
+#endif
+}
+
+/**
+ * \brief The k-th highest card in aggr and its holder.
+ *
+ * This is what rel[aggr].absRank[k][suit] used to hold: the hand is
+ * -1 and the rank 0 if aggr has fewer than k cards.
+ */
+inline auto abs_rank(
+  const cardHoldersType& holders,
+  const unsigned aggr,
+  const int k,
+  const int suit) -> absRankType
+{
+  const int rank = kth_highest_rank(aggr, k);
+  absRankType ar;
+  ar.rank = static_cast<char>(rank);
+  ar.hand = holders.hand[suit][rank];
+  return ar;
+}
+
+#endif
@@ -8,47 +8,74 @@
 */
 
 #include <lookup_tables/LookupTables.hpp>
-#include <utility/Constants.h>
-#include <cstring>
-#include <mutex>
+
+// All tables are generated by the compiler. They are constant, so they
+// live in read-only data: nothing runs at startup, and processes that
+// load the same library share the pages.
+//
+// Each table is its own constant expression, which keeps every one
+// well inside the compilers' constexpr evaluation limits. Most tables
+// are built from the entry without the top card, aggr ^ top bit,
+// which always comes earlier.
 
 namespace {
-  // Underlying storage (internal linkage)
-  static int dds_lut_highestRank_storage[8192];
-  static int dds_lut_lowestRank_storage[8192];
-  static int dds_lut_counttable_storage[8192];
-  static char dds_lut_relRank_storage[8192][15];
-  static unsigned short dds_lut_winRanks_storage[8192][14];
-  static MoveGroupType dds_lut_groupData_storage[8192];
-
-  static std::once_flag dds_lut_once_flag;
-}
+  // Bit 0 of an aggregate is the deuce, as in bitMapRank.
+  constexpr auto rank_bit(const int rank) -> int
+  {
+    return 1 << (rank - 2);
+  }
+
+  // Absolute rank (2 .. 14) of the top card of a non-empty aggregate.
+  constexpr auto top_rank(const int aggr) -> int
+  {
+    int r = 14;
+    while ((aggr & rank_bit(r)) == 0)
+      r--;
+    return r;
+  }
+
+  struct RankTable
+  {
+    int v[8192];
+  };
+
+  struct RelRankTable
+  {
+    char v[8192][15];
+  };
+
+  struct WinRanksTable
+  {
+    unsigned short v[8192][14];
+  };
+
+  struct GroupTable
+  {
+    MoveGroupType v[8192];
+  };
 
-static auto dds_lut_init_impl() -> void
-{
   // highestRank[aggr] is the highest absolute rank in the
   // suit represented by aggr. The absolute rank is 2 .. 14.
   // Similarly for lowestRank.
-  dds_lut_highestRank_storage[0] = 0;
-  dds_lut_lowestRank_storage[0] = 0;
-  for (int aggr = 1; aggr < 8192; aggr++)
+  constexpr auto make_highest_rank() -> RankTable
   {
-    for (int r = 14; r >= 2; r--)
-    {
-      if (aggr & bitMapRank[r])
-      {
-        dds_lut_highestRank_storage[aggr] = r;
-        break;
-      }
-    }
-    for (int r = 2; r <= 14; r++)
+    RankTable t{};
+    for (int aggr = 1; aggr < 8192; aggr++)
+      t.v[aggr] = top_rank(aggr);
+    return t;
+  }
+
+  constexpr auto make_lowest_rank() -> RankTable
+  {
+    RankTable t{};
+    for (int aggr = 1; aggr < 8192; aggr++)
     {
-      if (aggr & bitMapRank[r])
-      {
-        dds_lut_lowestRank_storage[aggr] = r;
-        break;
-      }
+      int r = 2;
+      while ((aggr & rank_bit(r)) == 0)
+        r++;
+      t.v[aggr] = r;
     }
+    return t;
   }
 
   // The use of the counttable to give the number of bits set to
@@ -56,59 +83,49 @@ static auto dds_lut_init_impl() -> void
 
   // counttable[aggr] is the number of '1' bits (binary weight)
   // in aggr.
-  for (int aggr = 0; aggr < 8192; aggr++)
+  constexpr auto make_count_table() -> RankTable
   {
-    dds_lut_counttable_storage[aggr] = 0;
-    for (int r = 0; r < 13; r++)
-    {
-      if (aggr & (1 << r))
-      {
-        dds_lut_counttable_storage[aggr]++;
-      }
-    }
+    RankTable t{};
+    for (int aggr = 1; aggr < 8192; aggr++)
+      t.v[aggr] = t.v[aggr & (aggr - 1)] + 1;
+    return t;
   }
 
   // relRank[aggr][absolute rank] is the relative rank of
   // that absolute rank in the suit represented by aggr.
   // The relative rank is 2 .. 14.
-  memset(dds_lut_relRank_storage[0], 0, 15);
-  for (int aggr = 1; aggr < 8192; aggr++)
+  constexpr auto make_rel_rank() -> RelRankTable
   {
-    char ord = 0;
-    for (int r = 14; r >= 2; r--)
+    RelRankTable t{};
+    for (int aggr = 1; aggr < 8192; aggr++)
     {
-      if (aggr & bitMapRank[r])
+      // Every card below the top moves down one place.
+      const int top = top_rank(aggr);
+      const int rest = aggr ^ rank_bit(top);
+      for (int r = 2; r < top; r++)
       {
-        ord++;
-        dds_lut_relRank_storage[aggr][r] = ord;
+        if (rest & rank_bit(r))
+          t.v[aggr][r] = static_cast<char>(t.v[rest][r] + 1);
       }
+      t.v[aggr][top] = 1;
     }
+    return t;
   }
 
   // winRanks[aggr][leastWin] is the absolute suit represented
   // by aggr, but limited to its top "leastWin" bits.
-  for (int aggr = 0; aggr < 8192; aggr++)
+  constexpr auto make_win_ranks() -> WinRanksTable
   {
-    dds_lut_winRanks_storage[aggr][0] = 0;
-    for (int leastWin = 1; leastWin < 14; leastWin++)
+    WinRanksTable t{};
+    for (int aggr = 1; aggr < 8192; aggr++)
     {
-      int res = 0;
-      int nextBitNo = 1;
-      for (int r = 14; r >= 2; r--)
-      {
-        if (aggr & bitMapRank[r])
-        {
-          if (nextBitNo <= leastWin)
-          {
-            res |= bitMapRank[r];
-            nextBitNo++;
-          }
-          else
-            break;
-        }
-      }
-      dds_lut_winRanks_storage[aggr][leastWin] = static_cast<unsigned short>(res);
+      const int topBit = rank_bit(top_rank(aggr));
+      const int rest = aggr ^ topBit;
+      for (int leastWin = 1; leastWin < 14; leastWin++)
+        t.v[aggr][leastWin] =
+          static_cast<unsigned short>(topBit | t.v[rest][leastWin - 1]);
     }
+    return t;
   }
 
   // groupData[ris] is a representation of the suit (ris is
@@ -119,94 +136,96 @@ static auto dds_lut_init_impl() -> void
   // 1: 6 and 0x0000, gap 0x0008
   // 2: 9 and 0x0040, gap 0x0020
   // 3: 14 and 0x0c00, gap 0x0300
-
-  int topside[15] =
+  constexpr auto make_group_data() -> GroupTable
   {
-    0x0000, 0x0000, 0x0000, 0x0001, // 2, 3,
-    0x0003, 0x0007, 0x000f, 0x001f, // 4, 5, 6, 7,
-    0x003f, 0x007f, 0x00ff, 0x01ff, // 8, 9, T, J,
-    0x03ff, 0x07ff, 0x0fff          // Q, K, A
-  };
+    constexpr int topside[15] =
+    {
+      0x0000, 0x0000, 0x0000, 0x0001, // 2, 3,
+      0x0003, 0x0007, 0x000f, 0x001f, // 4, 5, 6, 7,
+      0x003f, 0x007f, 0x00ff, 0x01ff, // 8, 9, T, J,
+      0x03ff, 0x07ff, 0x0fff          // Q, K, A
+    };
 
-  int botside[15] =
-  {
-    0xffff, 0xffff, 0x1ffe, 0x1ffc, // 2, 3,
-    0x1ff8, 0x1ff0, 0x1fe0, 0x1fc0, // 4, 5, 6, 7,
-    0x1f80, 0x1f00, 0x1e00, 0x1c00, // 8, 9, T, J,
-    0x1800, 0x1000, 0x0000          // Q, K, A
-  };
+    constexpr int botside[15] =
+    {
+      0xffff, 0xffff, 0x1ffe, 0x1ffc, // 2, 3,
+      0x1ff8, 0x1ff0, 0x1fe0, 0x1fc0, // 4, 5, 6, 7,
+      0x1f80, 0x1f00, 0x1e00, 0x1c00, // 8, 9, T, J,
+      0x1800, 0x1000, 0x0000          // Q, K, A
+    };
 
-  // So the bit vector in the gap between a top card of K
-  // and a bottom card of T is
-  // topside[K] = 0x07ff &
-  // botside[T] = 0x1e00
-  // which is 0x0600, the binary code for QJ.
+    // So the bit vector in the gap between a top card of K
+    // and a bottom card of T is
+    // topside[K] = 0x07ff &
+    // botside[T] = 0x1e00
+    // which is 0x0600, the binary code for QJ.
 
-  dds_lut_groupData_storage[0].last_group_ = -1;
+    GroupTable t{};
 
-  dds_lut_groupData_storage[1].last_group_ = 0;
-  dds_lut_groupData_storage[1].rank_[0] = 2;
-  dds_lut_groupData_storage[1].sequence_[0] = 0;
-  dds_lut_groupData_storage[1].fullseq_[0] = 1;
-  dds_lut_groupData_storage[1].gap_[0] = 0;
+    t.v[0].last_group_ = -1;
 
-  int topBitRank = 1;
-  int nextBitRank = 0;
-  int topBitNo = 2;
-  int g;
+    t.v[1].last_group_ = 0;
+    t.v[1].rank_[0] = 2;
+    t.v[1].sequence_[0] = 0;
+    t.v[1].fullseq_[0] = 1;
+    t.v[1].gap_[0] = 0;
 
-  for (int ris = 2; ris < 8192; ris++)
-  {
-    if (ris >= (topBitRank << 1))
+    int topBitRank = 1;
+    int nextBitRank = 0;
+    int topBitNo = 2;
+
+    for (int ris = 2; ris < 8192; ris++)
     {
-      // Next top bit
-      nextBitRank = topBitRank;
-      topBitRank <<= 1;
-      topBitNo++;
-    }
+      if (ris >= (topBitRank << 1))
+      {
+        // Next top bit
+        nextBitRank = topBitRank;
+        topBitRank <<= 1;
+        topBitNo++;
+      }
 
-    dds_lut_groupData_storage[ris] = dds_lut_groupData_storage[ris ^ topBitRank];
+      MoveGroupType& gd = t.v[ris];
+      gd = t.v[ris ^ topBitRank];
 
-    if (ris & nextBitRank) // 11... Extend group
-    {
-      g = dds_lut_groupData_storage[ris].last_group_;
-      dds_lut_groupData_storage[ris].rank_[g]++;
-      dds_lut_groupData_storage[ris].sequence_[g] |= nextBitRank;
-      dds_lut_groupData_storage[ris].fullseq_[g] |= topBitRank;
-    }
-    else // 10... New group
-    {
-      g = ++dds_lut_groupData_storage[ris].last_group_;
-      dds_lut_groupData_storage[ris].rank_[g] = topBitNo;
-      dds_lut_groupData_storage[ris].sequence_[g] = 0;
-      dds_lut_groupData_storage[ris].fullseq_[g] = topBitRank;
-      dds_lut_groupData_storage[ris].gap_[g] =
-        topside[topBitNo] & botside[ dds_lut_groupData_storage[ris].rank_[g - 1] ];
+      if (ris & nextBitRank) // 11... Extend group
+      {
+        const int g = gd.last_group_;
+        gd.rank_[g]++;
+        gd.sequence_[g] |= nextBitRank;
+        gd.fullseq_[g] |= topBitRank;
+      }
+      else // 10... New group
+      {
+        const int g = ++gd.last_group_;
+        gd.rank_[g] = topBitNo;
+        gd.sequence_[g] = 0;
+        gd.fullseq_[g] = topBitRank;
+        // The lowest gap is unused. It is kept at what the runtime
+        // generator stored, which read last_group_ (0) as rank_[-1].
+        const int below = (g == 0 ? 0 : gd.rank_[g - 1]);
+        gd.gap_[g] = topside[topBitNo] & botside[below];
+      }
     }
+    return t;
   }
+
+  constexpr RankTable dds_lut_highestRank = make_highest_rank();
+  constexpr RankTable dds_lut_lowestRank = make_lowest_rank();
+  constexpr RankTable dds_lut_counttable = make_count_table();
+  constexpr RelRankTable dds_lut_relRank = make_rel_rank();
+  constexpr WinRanksTable dds_lut_winRanks = make_win_ranks();
+  constexpr GroupTable dds_lut_groupData = make_group_data();
 }
 
 auto init_lookup_tables() -> void
 {
-  std::call_once(dds_lut_once_flag, dds_lut_init_impl);
-}
-
-// Eager initialization at program start (TU load) to avoid any cost on first use.
-namespace {
-  struct DdsLutInitGuard
-  {
-    DdsLutInitGuard() noexcept
-    {
-      init_lookup_tables();
-    }
-  };
-  static const DdsLutInitGuard dds_lut_init_guard;
+  // The tables are constant-initialized; nothing to do.
 }
 
-// Bind const references to internal storage for zero-overhead access
-const MoveGroupType (&group_data)[8192] = dds_lut_groupData_storage;
-const int (&highest_rank)[8192] = dds_lut_highestRank_storage;
-const int (&lowest_rank)[8192] = dds_lut_lowestRank_storage;
-const int (&count_table)[8192] = dds_lut_counttable_storage;
-const char (&rel_rank)[8192][15] = dds_lut_relRank_storage;
-const unsigned short (&win_ranks)[8192][14] = dds_lut_winRanks_storage;
+// Bind const references to the constant tables for zero-overhead access
+const MoveGroupType (&group_data)[8192] = dds_lut_groupData.v;
+const int (&highest_rank)[8192] = dds_lut_highestRank.v;
+const int (&lowest_rank)[8192] = dds_lut_lowestRank.v;
+const int (&count_table)[8192] = dds_lut_counttable.v;
+const char (&rel_rank)[8192][15] = dds_lut_relRank.v;
+const unsigned short (&win_ranks)[8192][14] = dds_lut_winRanks.v;
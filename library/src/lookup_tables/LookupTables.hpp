@@ -40,9 +40,8 @@ struct MoveGroupType
 /**
  * \brief Initialize the lookup tables.
  *
- * Safe to call multiple times. Internally guarded by std::call_once so
- * initialization happens at most once per process. Accessing any table via
- * the read-only proxies also triggers lazy initialization.
+ * The tables are generated at compile time and placed in read-only data,
+ * so this does nothing. It is kept for callers that still call it first.
  */
 auto init_lookup_tables() -> void;
 
@@ -51,7 +50,8 @@ auto init_lookup_tables() -> void;
  *
  * These are exposed as const references to fixed-size arrays to provide
  * zero-overhead indexing (e.g., highest_rank[i], rel_rank[i][j]). The
- * underlying storage is initialized once via init_lookup_tables().
+ * underlying storage is constant-initialized, so the tables can be used
+ * from any static initializer.
  */
 
 /** \brief Read-only table: highest absolute rank per aggregate. */
@@ -41,6 +41,10 @@
   #define MG_REGISTER(a, b) 1;
 #endif
 
+// The weights for the second to fourth hand never look at who holds
+// the lower cards, so MoveGen123 passes these instead of the deal's.
+static const cardHoldersType noHolders = {};
+
 
 Moves::Moves()
 {
@@ -147,7 +151,7 @@ int Moves::MoveGen0(
   const pos& tpos,
   const moveType& bestMove,
   const moveType& bestMoveTT,
-  const relRanksType thrp_rel[])
+  const cardHoldersType& holders)
 {
   trackp = &track[tricks];
   leadHand = trackp->leadHand;
@@ -189,7 +193,7 @@ int Moves::MoveGen0(
       g--;
     }
 
-    Moves::CallHeuristic(tpos, bestMove, bestMoveTT, thrp_rel);
+    Moves::CallHeuristic(tpos, bestMove, bestMoveTT, holders);
   }
 
 #ifdef DDS_MOVES
@@ -274,7 +278,7 @@ int Moves::MoveGen123(
 #ifdef DDS_SKIP_HEURISTIC
   return numMoves;
 #endif
-      Moves::CallHeuristic(tpos, moveType{}, moveType{}, nullptr);
+      Moves::CallHeuristic(tpos, moveType{}, moveType{}, noHolders);
 
     Moves::MergeSort();
     return numMoves;
@@ -312,7 +316,7 @@ int Moves::MoveGen123(
       g--;
     }
 
-    Moves::CallHeuristic(tpos, moveType{}, moveType{}, nullptr);
+    Moves::CallHeuristic(tpos, moveType{}, moveType{}, noHolders);
   }
 
   list.current = 0;
@@ -721,13 +725,13 @@ void Moves::CallHeuristic(
     const pos& tpos,
     const moveType& bestMove,
     const moveType& bestMoveTT,
-    const relRanksType thrp_rel[]) {
+    const cardHoldersType& holders) {
   // Construct context once here and call the context-taking overload.
   HeuristicContext context{
     tpos,
     bestMove,
     bestMoveTT,
-    thrp_rel,
+    holders,
     mply,
     numMoves,
     lastNumMoves,
@@ -113,7 +113,7 @@ class Moves
       const pos& tpos,
       const moveType& bestMove,
       const moveType& bestMoveTT,
-      const relRanksType thrp_rel[]);
+      const cardHoldersType& holders);
 
   // (logging accessors removed)
 
@@ -163,7 +163,7 @@ class Moves
       const pos& tpos,
       const moveType& bestMove,
       const moveType& bestMoveTT,
-      const relRanksType thrp_rel[]);
+      const cardHoldersType& holders);
 
     int MoveGen123(
       const int tricks,
@@ -0,0 +1,65 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Thread-indexed pool of long-lived SolverContext instances.
+*/
+
+#include "ContextPool.hpp"
+
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+void ContextPool::Resize(
+  const unsigned n,
+  const TTKind kind,
+  const int memDefault_MB,
+  const int memMaximum_MB) // NOLINT(bugprone-easily-swappable-parameters)
+{
+  const unsigned oldSize = static_cast<unsigned>(contexts.size());
+  if (n <= oldSize)
+  {
+    contexts.resize(n);
+    return;
+  }
+
+  SolverConfig cfg;
+  cfg.ttKind = kind;
+  cfg.ttMemDefaultMB = memDefault_MB;
+  cfg.ttMemMaximumMB = memMaximum_MB;
+
+  contexts.reserve(n);
+  for (unsigned i = oldSize; i < n; i++)
+    contexts.push_back(std::make_unique<SolverContext>(cfg));
+}
+
+
+unsigned ContextPool::NumThreads() const
+{
+  return static_cast<unsigned>(contexts.size());
+}
+
+
+SolverContext& ContextPool::Get(const unsigned thrId)
+{
+  return * contexts[thrId];
+}
+
+
+void ContextPool::ReturnThread(const unsigned thrId)
+{
+  if (thrId < contexts.size())
+    contexts[thrId]->ClearTT();
+}
+
+
+
+void ContextPool::SwitchKind(
+  const TTKind from,
+  const TTKind to)
+{
+  for (auto& ctx: contexts)
+  {
+    const SolverConfig& cfg = ctx->config();
+    if (cfg.ttKind == from)
+      ctx->ConfigureTT(to, cfg.ttMemDefaultMB, cfg.ttMemMaximumMB);
+  }
+}
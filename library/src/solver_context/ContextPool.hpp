@@ -0,0 +1,68 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Thread-indexed pool of long-lived SolverContext instances.
+*/
+
+#ifndef DDS_SOLVER_CONTEXT_CONTEXTPOOL_H
+#define DDS_SOLVER_CONTEXT_CONTEXTPOOL_H
+
+#include <vector>
+#include <memory>
+
+#include "SolverContext.hpp"
+
+
+/**
+ * @brief Per-thread SolverContext storage behind the thrId-based API.
+ *
+ * The legacy entry points (SolveBoard(..., thrId) and the batch workers)
+ * identify a solver thread by index. ContextPool keeps one SolverContext
+ * per index alive between calls, so that consecutive calls on the same
+ * thread see warm ThreadData and a warm transposition table. Sizing
+ * follows Memory::Resize and is driven by SetResources.
+ *
+ * A pooled context must only be used by one caller at a time; as with the
+ * original DDS thread memory, concurrent calls must use distinct thrId's.
+ */
+class ContextPool
+{
+  private:
+
+    std::vector<std::unique_ptr<SolverContext>> contexts;
+
+  public:
+
+    ContextPool() = default;
+    ~ContextPool() = default;
+    ContextPool(const ContextPool&) = delete;
+    ContextPool& operator=(const ContextPool&) = delete;
+
+    /**
+     * @brief Grow or shrink the pool to n contexts.
+     *
+     * Existing contexts below n are kept as they are. New contexts are
+     * created with the given TT kind and memory limits.
+     */
+    void Resize(
+      const unsigned n,
+      const TTKind kind,
+      const int memDefault_MB,
+      const int memMaximum_MB); // NOLINT(bugprone-easily-swappable-parameters)
+
+    unsigned NumThreads() const;
+
+    SolverContext& Get(const unsigned thrId);
+
+    // Return the transposition table memory held by one context. The
+    // context itself stays in the pool and recreates its TT lazily.
+    void ReturnThread(const unsigned thrId);
+
+    // Move the contexts with one TT kind to another, keeping their
+    // memory limits. Used to turn the shared TT on and off.
+    void SwitchKind(
+      const TTKind from,
+      const TTKind to);
+};
+
+#endif
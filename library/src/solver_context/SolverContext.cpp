@@ -5,6 +5,7 @@
 #include <trans_table/TransTable.hpp>
 #include <trans_table/TransTableS.hpp>
 #include <trans_table/TransTableL.hpp>
+#include <trans_table/TransTableShared.hpp>
 #include <memory>
 #include <cstdlib>
 #include <iostream>
@@ -33,11 +34,30 @@ TransTable* SolverContext::transTable() const
   return const_cast<SolverContext*>(this)->search_.transTable();
 }
 
+void SolverContext::ArmSearchLimits() const
+{
+  // Without limits the search never reaches limitCheck. With them, the
+  // first completed trick already looks, so a batch whose deadline has
+  // passed skips its remaining boards almost at once.
+  thr_->limits = &limits_;
+  thr_->limitCheck = (limits_.active() ? 0 : INT_MAX);
+  thr_->stopReason = RETURN_NO_FAULT;
+}
+
 // --- SearchContext disposal helper ---
 void SolverContext::SearchContext::disposeTransTable()
 {
   // Simply reset the unique_ptr; logging/stats are handled by caller.
   tt_.reset();
+  // A new TT only learns the cards in SetDealTables, so make the next
+  // solve see a new deal and strain.
+  if (thr_)
+  {
+    for (int h = 0; h < DDS_HANDS; h++)
+      for (int s = 0; s < DDS_SUITS; s++)
+        thr_->suit[h][s] = 0;
+    thr_->trump = -1;
+  }
 }
 
 // --- SearchContext out-of-line definitions ---
@@ -120,6 +140,8 @@ TransTable* SolverContext::SearchContext::transTable() {
   // Create appropriate concrete table
   if (kind == TTKind::Small)
     tt_ = std::unique_ptr<TransTable>(new TransTableS());
+  else if (kind == TTKind::Shared)
+    tt_ = std::unique_ptr<TransTable>(new TransTableShared());
   else
     tt_ = std::unique_ptr<TransTable>(new TransTableL());
 
@@ -129,7 +151,8 @@ TransTable* SolverContext::SearchContext::transTable() {
 
 #ifdef DDS_UTILITIES_LOG
   {
-    const char kch = (kind == TTKind::Small ? 'S' : 'L');
+    const char kch = (kind == TTKind::Small ? 'S' :
+                      kind == TTKind::Shared ? 'H' : 'L');
     char buf[96];
     std::snprintf(buf, sizeof(buf), "tt:create|%c|%d|%d", kch, defMB, maxMB);
     if (owner_) owner_->utilities().logAppend(std::string(buf));
@@ -144,7 +167,8 @@ TransTable* SolverContext::SearchContext::transTable() {
   if (const char* dbg = std::getenv("DDS_DEBUG_TT_CREATE")) {
     if (*dbg) {
       std::cerr << "[DDS] TT create: kind="
-                << (kind == TTKind::Small ? 'S' : 'L')
+                << (kind == TTKind::Small ? 'S' :
+                    kind == TTKind::Shared ? 'H' : 'L')
                 << " defMB=" << defMB
                 << " maxMB=" << maxMB
                 << std::endl;
@@ -218,6 +242,9 @@ void SolverContext::ClearTT() const
 #endif
   if (auto* tt = search_.maybeTransTable())
     tt->return_all_memory();
+  // The emptied table has no roots left. Drop it so that it is
+  // recreated and set up for the next deal.
+  const_cast<SolverContext*>(this)->search_.disposeTransTable();
 }
 
 void SolverContext::ResizeTT(int defMB, int maxMB) const
@@ -255,8 +282,11 @@ void SolverContext::ConfigureTT(TTKind kind, int defMB, int maxMB)
   if (!tt) return; // Nothing to apply now; will take effect on lazy creation.
 
   // If kind changes, dispose and recreate now to ensure effect is applied.
-  bool is_small = (dynamic_cast<TransTableS*>(tt) != nullptr);
-  TTKind current_kind = is_small ? TTKind::Small : TTKind::Large;
+  TTKind current_kind = TTKind::Large;
+  if (dynamic_cast<TransTableS*>(tt) != nullptr)
+    current_kind = TTKind::Small;
+  else if (dynamic_cast<TransTableShared*>(tt) != nullptr)
+    current_kind = TTKind::Shared;
   if (current_kind != kind) {
     DisposeTransTable();
     // Force immediate creation with new config to keep behavior explicit.
@@ -294,7 +324,7 @@ double ThreadMemoryUsed()
 {
   // TODO:  Only needed because SolverIF wants to set it. Avoid?
   double memUsed =
-    8192 * sizeof(relRanksType)
+    sizeof(cardHoldersType)
     / static_cast<double>(1024.);
 
   return memUsed;
@@ -308,9 +338,9 @@ int SolverContext::MoveGenContext::MoveGen0(
   const pos& tpos,
   const moveType& bestMove,
   const moveType& bestMoveTT,
-  const relRanksType thrp_rel[])
+  const cardHoldersType& holders)
 {
-  auto rc = thr_->moves.MoveGen0(tricks, tpos, bestMove, bestMoveTT, thrp_rel);
+  auto rc = moves_->MoveGen0(tricks, tpos, bestMove, bestMoveTT, holders);
   return rc;
 }
 
@@ -319,7 +349,7 @@ int SolverContext::MoveGenContext::MoveGen123(
   const int relHand,
   const pos& tpos)
 {
-  auto rc = thr_->moves.MoveGen123(tricks, relHand, tpos);
+  auto rc = moves_->MoveGen123(tricks, relHand, tpos);
   return rc;
 }
 
@@ -328,7 +358,7 @@ void SolverContext::MoveGenContext::Purge(
   const int relHand,
   const moveType forbiddenMoves[])
 {
-  thr_->moves.Purge(tricks, relHand, forbiddenMoves);
+  moves_->Purge(tricks, relHand, forbiddenMoves);
 }
 
 const moveType* SolverContext::MoveGenContext::MakeNext(
@@ -336,40 +366,40 @@ const moveType* SolverContext::MoveGenContext::MakeNext(
   const int relHand,
   const unsigned short winRanks[])
 {
-  return thr_->moves.MakeNext(trick, relHand, winRanks);
+  return moves_->MakeNext(trick, relHand, winRanks);
 }
 
 const moveType* SolverContext::MoveGenContext::MakeNextSimple(
   const int trick,
   const int relHand)
 {
-  return thr_->moves.MakeNextSimple(trick, relHand);
+  return moves_->MakeNextSimple(trick, relHand);
 }
 
 int SolverContext::MoveGenContext::GetLength(
   const int trick,
   const int relHand) const
 {
-  return thr_->moves.GetLength(trick, relHand);
+  return moves_->GetLength(trick, relHand);
 }
 
 void SolverContext::MoveGenContext::Rewind(
   const int tricks,
   const int relHand)
 {
-  thr_->moves.Rewind(tricks, relHand);
+  moves_->Rewind(tricks, relHand);
 }
 
 void SolverContext::MoveGenContext::RegisterHit(
   const int tricks,
   const int relHand)
 {
-  thr_->moves.RegisterHit(tricks, relHand);
+  moves_->RegisterHit(tricks, relHand);
 }
 
 const trickDataType& SolverContext::MoveGenContext::GetTrickData(const int tricks)
 {
-  return thr_->moves.GetTrickData(tricks);
+  return moves_->GetTrickData(tricks);
 }
 
 void SolverContext::MoveGenContext::MakeSpecific(
@@ -377,19 +407,19 @@ void SolverContext::MoveGenContext::MakeSpecific(
   const int trick,
   const int relHand)
 {
-  thr_->moves.MakeSpecific(mply, trick, relHand);
+  moves_->MakeSpecific(mply, trick, relHand);
 }
 
 std::string SolverContext::MoveGenContext::TrickToText(const int trick) const
 {
-  return thr_->moves.TrickToText(trick);
+  return moves_->TrickToText(trick);
 }
 
 void SolverContext::MoveGenContext::Reinit(
   const int tricks,
   const int leadHand)
 {
-  thr_->moves.Reinit(tricks, leadHand);
+  moves_->Reinit(tricks, leadHand);
 }
 
 void SolverContext::MoveGenContext::Init(
@@ -401,21 +431,21 @@ void SolverContext::MoveGenContext::Init(
   const int trump,
   const int leadHand)
 {
-  thr_->moves.Init(tricks, relStartHand, initialRanks, initialSuits,
+  moves_->Init(tricks, relStartHand, initialRanks, initialSuits,
                    rankInSuit, trump, leadHand);
 }
 
 void SolverContext::MoveGenContext::PrintTrickStats(std::ofstream& fout) const
 {
-  thr_->moves.PrintTrickStats(fout);
+  moves_->PrintTrickStats(fout);
 }
 
 void SolverContext::MoveGenContext::PrintFunctionStats(std::ofstream& fout) const
 {
-  thr_->moves.PrintFunctionStats(fout);
+  moves_->PrintFunctionStats(fout);
 }
 
 void SolverContext::MoveGenContext::PrintTrickDetails(std::ofstream& fout) const
 {
-  thr_->moves.PrintTrickDetails(fout);
+  moves_->PrintTrickDetails(fout);
 }
@@ -12,15 +12,20 @@
 #include <system/ThreadData.hpp>
 #include <system/util/Utilities.hpp>
 #include <trans_table/TransTable.hpp>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <random>
 #include <cstddef>
 #include <memory>
+#include <type_traits>
 
 // Minimal configuration scaffold for future expansion.
 // TT configuration without depending on Memory headers.
-enum class TTKind { Small, Large };
+// Shared is a Large table that also looks up and stores exact
+// positions in a process-wide table used by all Shared contexts.
+enum class TTKind { Small, Large, Shared };
 
 struct SolverConfig
 {
@@ -31,8 +36,75 @@ struct SolverConfig
   unsigned long long rngSeed = 0ULL;
   // Optional arena capacity (bytes). 0 disables arena.
   std::size_t arenaCapacityBytes = 0ULL;
+  // Look up and store results in the process-wide result cache once
+  // it is turned on. It is off (size 0) until SetResultCacheSize.
+  bool useResultCache = true;
+  // Start the root searches from an estimate of the tricks rather
+  // than a fixed 7 or 6, for solutions 1 and 2. The results are the
+  // same either way.
+  bool useTrickEstimate = true;
 };
 
+// Limits on the solves of a context. A solve that runs past the
+// deadline, or finds the cancel flag set, stops and returns
+// RETURN_TIMEOUT or RETURN_CANCELLED instead of a result.
+struct SearchLimits
+{
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::time_point::max();
+  // Set from any thread to stop the solves that share it.
+  std::shared_ptr<std::atomic<bool>> cancel;
+
+  bool active() const
+  {
+    return cancel != nullptr ||
+      deadline != std::chrono::steady_clock::time_point::max();
+  }
+
+  // RETURN_CANCELLED or RETURN_TIMEOUT once the limits are hit,
+  // otherwise RETURN_NO_FAULT.
+  int reached() const
+  {
+    if (cancel && cancel->load(std::memory_order_relaxed))
+      return RETURN_CANCELLED;
+    if (deadline != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= deadline)
+      return RETURN_TIMEOUT;
+    return RETURN_NO_FAULT;
+  }
+};
+
+// The tricks the side to play was proven to take, lower <= score <=
+// upper, when a solve stopped at its limits.
+struct TrickBounds
+{
+  int lower = 0;
+  int upper = 13;
+};
+
+// --- Hot-path view for the search kernels ---
+// Non-owning and trivially copyable. It points into the ThreadData and
+// TT that a SolverContext owns, so passing it down the recursion costs
+// no reference counting. Take it from SolverContext::searchView() when
+// a search starts; it is invalid once the context is destroyed or its
+// TT is disposed or recreated.
+class SearchView
+{
+public:
+  SearchView(ThreadData& thr, TransTable& tt)
+  : thr_(&thr), tt_(&tt) {}
+
+  ThreadData* thread() const { return thr_; }
+  TransTable* transTable() const { return tt_; }
+  Moves& moves() const { return thr_->moves; }
+
+private:
+  ThreadData* thr_;
+  TransTable* tt_;
+};
+
+static_assert(std::is_trivially_copyable_v<SearchView>);
+
 class SolverContext
 {
 public:
@@ -63,6 +135,23 @@ public:
   std::shared_ptr<ThreadData> thread() const { return thr_; }
   const SolverConfig& config() const { return cfg_; }
 
+  // --- Deadline and cancellation ---
+  // The limits apply to every later solve on this context, until they
+  // are replaced. The search checks them about once a millisecond, so
+  // a solve stops soon after hitting them. After a stopped solve,
+  // stoppedBounds() holds what it had proven so far.
+  void SetSearchLimits(const SearchLimits& limits) { limits_ = limits; }
+  const SearchLimits& searchLimits() const { return limits_; }
+  const TrickBounds& stoppedBounds() const { return stopped_; }
+
+  // Used by the solver: arm the limits when a search starts, and
+  // record the bounds when it stopped.
+  void ArmSearchLimits() const;
+  void SetStoppedBounds(const TrickBounds& bounds) { stopped_ = bounds; }
+
+  // View for the search kernels. Creates the TT if needed.
+  SearchView searchView() const { return SearchView(*thr_, *transTable()); }
+
   // --- Utilities facade ---
   class UtilitiesContext {
   public:
@@ -185,15 +274,16 @@ public:
   // --- Move generation facade ---
   class MoveGenContext {
   public:
-    explicit MoveGenContext(std::shared_ptr<ThreadData> thr)
-      : thr_(std::move(thr)) {}
+    // Non-owning, like SearchView: building one per call is free.
+    explicit MoveGenContext(Moves& moves)
+      : moves_(&moves) {}
 
     int MoveGen0(
       const int tricks,
       const pos& tpos,
       const moveType& bestMove,
       const moveType& bestMoveTT,
-      const relRanksType thrp_rel[]);
+      const cardHoldersType& holders);
 
     int MoveGen123(
       const int tricks,
@@ -261,10 +351,10 @@ public:
       const int relHand);
 
   private:
-    std::shared_ptr<ThreadData> thr_;
+    Moves* moves_;
   };
 
-  inline MoveGenContext moveGen() const { return MoveGenContext(thr_); }
+  inline MoveGenContext moveGen() const { return MoveGenContext(thr_->moves); }
 
 private:
   // Shared ownership of per-context ThreadData. Callers can construct
@@ -276,6 +366,8 @@ private:
   SearchContext search_;
   SolverConfig cfg_{};
   mutable ::dds::Utilities utils_{};
+  SearchLimits limits_{};
+  TrickBounds stopped_{};
   // Arena removed.
   // NOTE: `owned_thr_` removed; `thr_` now represents the shared ownership
   // (if any) for this context.
@@ -0,0 +1,79 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "DealFingerprint.hpp"
+
+
+static uint64_t Mix(uint64_t x)
+{
+  // The splitmix64 finalizer.
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+
+static void Add(
+  dealFingerprint& fp,
+  const uint64_t word)
+{
+  fp.lo = Mix(fp.lo + word);
+  fp.hi = Mix(fp.hi ^ (word * 0x9e3779b97f4a7c15ULL));
+}
+
+
+static uint64_t Pack(
+  const unsigned a,
+  const unsigned b)
+{
+  return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+}
+
+
+static uint64_t Pack(
+  const int a,
+  const int b)
+{
+  return Pack(static_cast<unsigned>(a), static_cast<unsigned>(b));
+}
+
+
+dealFingerprint DealFingerprint(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode)
+{
+  dealFingerprint fp;
+  fp.lo = 0x6a09e667f3bcc908ULL;
+  fp.hi = 0xbb67ae8584caa73bULL;
+
+  // Every field goes in at its full 32 bits, so two requests that
+  // differ anywhere, including in out-of-range values, feed different
+  // words into the mix.
+
+  for (int s = 0; s < DDS_SUITS; s++)
+  {
+    Add(fp, Pack(dl.remainCards[0][s], dl.remainCards[1][s]));
+    Add(fp, Pack(dl.remainCards[2][s], dl.remainCards[3][s]));
+  }
+
+  for (int k = 0; k < 3; k++)
+    Add(fp, Pack(dl.currentTrickSuit[k], dl.currentTrickRank[k]));
+
+  Add(fp, Pack(dl.trump, dl.first));
+  Add(fp, Pack(target, solutions));
+  Add(fp, static_cast<uint32_t>(mode));
+
+  return fp;
+}
@@ -0,0 +1,62 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_DEALFINGERPRINT_H
+#define DDS_DEALFINGERPRINT_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include <api/dll.h>
+
+using namespace std;
+
+
+/**
+ * @brief 128-bit fingerprint of a solve request.
+ *
+ * Covers everything that determines the result of SolveBoard: the
+ * remaining cards, trump, leader, the cards already on the current
+ * trick and target/solutions/mode. Two independently mixed 64-bit
+ * halves make accidental collisions negligible for any realistic
+ * session, so the fingerprint can stand in for the deal as a key.
+ */
+struct dealFingerprint
+{
+  uint64_t lo;
+  uint64_t hi;
+
+  bool operator==(const dealFingerprint& other) const
+  {
+    return lo == other.lo && hi == other.hi;
+  }
+
+  bool operator!=(const dealFingerprint& other) const
+  {
+    return ! (* this == other);
+  }
+};
+
+
+struct dealFingerprintHash
+{
+  size_t operator()(const dealFingerprint& fp) const
+  {
+    return static_cast<size_t>(fp.lo ^ (fp.hi >> 1));
+  }
+};
+
+
+dealFingerprint DealFingerprint(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const int mode);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include <algorithm>
+#include <cstdint>
+
+#include "DealSymmetry.hpp"
+
+
+static uint64_t SuitWord(
+  const deal& dl,
+  const int suit,
+  const int rotation)
+{
+  // The four holdings of one suit in canonical hand order.
+  uint64_t word = 0;
+  for (int hc = 0; hc < DDS_HANDS; hc++)
+  {
+    const int h = (hc + DDS_HANDS - rotation) % DDS_HANDS;
+    word = (word << 16) | static_cast<uint64_t>(dl.remainCards[h][suit]);
+  }
+  return word;
+}
+
+
+void CanonicalDeal(
+  const deal& dl,
+  deal& canon,
+  dealSymmetry& sym)
+{
+  canon = dl;
+  sym.rotation = 0;
+  for (int s = 0; s < DDS_SUITS; s++)
+    sym.suit[s] = s;
+
+  if (dl.currentTrickRank[0] || dl.currentTrickRank[1] ||
+      dl.currentTrickRank[2])
+    return;
+
+  // For each rotation the suits are ordered by their holdings, which
+  // gives the smallest form for that rotation. The smallest of the
+  // four rotations wins.
+
+  const bool hasTrump = (dl.trump >= 0 && dl.trump < DDS_SUITS);
+  const int firstFree = (hasTrump ? 1 : 0);
+
+  uint64_t bestKey[DDS_SUITS] = {0, 0, 0, 0};
+  int bestOrder[DDS_SUITS] = {0, 1, 2, 3};
+
+  for (int r = 0; r < DDS_HANDS; r++)
+  {
+    uint64_t word[DDS_SUITS];
+    for (int s = 0; s < DDS_SUITS; s++)
+      word[s] = SuitWord(dl, s, r);
+
+    // order[k] is the original suit that becomes canonical suit k.
+    int order[DDS_SUITS];
+    int k = 0;
+    if (hasTrump)
+      order[k++] = dl.trump;
+    for (int s = 0; s < DDS_SUITS; s++)
+      if (! hasTrump || s != dl.trump)
+        order[k++] = s;
+
+    sort(order + firstFree, order + DDS_SUITS,
+      [&word](const int a, const int b)
+    {
+      return word[a] < word[b] || (word[a] == word[b] && a < b);
+    });
+
+    uint64_t key[DDS_SUITS];
+    for (k = 0; k < DDS_SUITS; k++)
+      key[k] = word[order[k]];
+
+    if (r == 0 || lexicographical_compare(key, key + DDS_SUITS,
+        bestKey, bestKey + DDS_SUITS))
+    {
+      sym.rotation = r;
+      for (k = 0; k < DDS_SUITS; k++)
+      {
+        bestKey[k] = key[k];
+        bestOrder[k] = order[k];
+      }
+    }
+  }
+
+  for (int k = 0; k < DDS_SUITS; k++)
+    sym.suit[bestOrder[k]] = k;
+
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      canon.remainCards[(h + sym.rotation) % DDS_HANDS][sym.suit[s]] =
+        dl.remainCards[h][s];
+
+  if (hasTrump)
+    canon.trump = 0;
+  if (dl.first >= 0 && dl.first < DDS_HANDS)
+    canon.first = (dl.first + sym.rotation) % DDS_HANDS;
+}
+
+
+bool SameCardsAndStrain(
+  const deal& dl1,
+  const deal& dl2)
+{
+  if (dl1.trump != dl2.trump)
+    return false;
+
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      if (dl1.remainCards[h][s] != dl2.remainCards[h][s])
+        return false;
+
+  return true;
+}
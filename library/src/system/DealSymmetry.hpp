@@ -0,0 +1,60 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_DEALSYMMETRY_H
+#define DDS_DEALSYMMETRY_H
+
+#include <api/dll.h>
+
+using namespace std;
+
+
+/**
+ * @brief How a deal was mapped onto its canonical form.
+ *
+ * Hand h of the original deal is hand (h + rotation) % DDS_HANDS of
+ * the canonical deal, and suit s is suit suit[s].
+ */
+struct dealSymmetry
+{
+  int rotation;
+  int suit[DDS_SUITS];
+};
+
+
+/**
+ * @brief Map a deal onto a canonical representative of its class.
+ *
+ * The number of tricks each side takes does not change when the seats
+ * are rotated or when the suits other than trumps are relabelled. All
+ * deals in such a class map onto the same canonical deal: trumps (if
+ * any) become suit 0, and the rotation and the order of the other
+ * suits are chosen to make the holdings smallest. The canonical deal
+ * keeps the leader, rotated along with the hands.
+ *
+ * Deals with cards on the current trick are returned unchanged with
+ * the identity mapping.
+ *
+ * @param dl Original deal.
+ * @param canon Output canonical deal.
+ * @param sym Output mapping from dl to canon.
+ */
+void CanonicalDeal(
+  const deal& dl,
+  deal& canon,
+  dealSymmetry& sym);
+
+/**
+ * @brief True if two deals have the same cards in the same strain.
+ */
+bool SameCardsAndStrain(
+  const deal& dl1,
+  const deal& dl2);
+
+#endif
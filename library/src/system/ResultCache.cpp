@@ -0,0 +1,164 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "ResultCache.hpp"
+
+
+ResultCache::ResultCache()
+{
+  shards = vector<shardType>(DDS_RESULT_CACHE_SHARDS);
+  for (auto& sh: shards)
+  {
+    sh.hits = 0;
+    sh.misses = 0;
+    sh.evictions = 0;
+  }
+
+  // Off until SetResultCacheSize turns it on.
+  ResultCache::SetCapacity(0);
+}
+
+
+ResultCache::~ResultCache()
+{
+}
+
+
+ResultCache::shardType& ResultCache::Shard(const dealFingerprint& fp)
+{
+  // The low half feeds the hash map within the shard.
+  return shards[static_cast<unsigned>(fp.hi >> 60) % shards.size()];
+}
+
+
+void ResultCache::SetCapacity(const size_t maxEntries)
+{
+  capacity = maxEntries;
+
+  // The first maxEntries % ns shards take one entry more, so that
+  // the shards add up to maxEntries.
+  const size_t ns = shards.size();
+  for (size_t i = 0; i < ns; i++)
+  {
+    shardType& sh = shards[i];
+    lock_guard<mutex> lk(sh.mtx);
+    sh.capacity = maxEntries / ns + (i < maxEntries % ns ? 1 : 0);
+    while (sh.lru.size() > sh.capacity)
+    {
+      sh.index.erase(sh.lru.back().fp);
+      sh.lru.pop_back();
+      sh.evictions++;
+    }
+  }
+}
+
+
+size_t ResultCache::Capacity() const
+{
+  return capacity;
+}
+
+
+bool ResultCache::Lookup(
+  const dealFingerprint& fp,
+  futureTricks& fut)
+{
+  shardType& sh = ResultCache::Shard(fp);
+  lock_guard<mutex> lk(sh.mtx);
+  if (sh.capacity == 0)
+    return false;
+
+  auto it = sh.index.find(fp);
+  if (it == sh.index.end())
+  {
+    sh.misses++;
+    return false;
+  }
+
+  sh.hits++;
+  sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+  fut = it->second->fut;
+  return true;
+}
+
+
+void ResultCache::Store(
+  const dealFingerprint& fp,
+  const futureTricks& fut)
+{
+  shardType& sh = ResultCache::Shard(fp);
+  lock_guard<mutex> lk(sh.mtx);
+  if (sh.capacity == 0)
+    return;
+
+  auto it = sh.index.find(fp);
+  if (it != sh.index.end())
+  {
+    // Another thread got there first.
+    it->second->fut = fut;
+    sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+    return;
+  }
+
+  if (sh.lru.size() >= sh.capacity)
+  {
+    sh.index.erase(sh.lru.back().fp);
+    sh.lru.pop_back();
+    sh.evictions++;
+  }
+
+  sh.lru.push_front({fp, fut});
+  sh.index[fp] = sh.lru.begin();
+}
+
+
+void ResultCache::Clear()
+{
+  for (auto& sh: shards)
+  {
+    lock_guard<mutex> lk(sh.mtx);
+    sh.lru.clear();
+    sh.index.clear();
+    sh.hits = 0;
+    sh.misses = 0;
+    sh.evictions = 0;
+  }
+}
+
+
+size_t ResultCache::Size()
+{
+  size_t n = 0;
+  for (auto& sh: shards)
+  {
+    lock_guard<mutex> lk(sh.mtx);
+    n += sh.lru.size();
+  }
+  return n;
+}
+
+
+void ResultCache::GetStats(resultCacheStats& stats)
+{
+  stats.hits = 0;
+  stats.misses = 0;
+  stats.evictions = 0;
+  stats.entries = 0;
+
+  for (auto& sh: shards)
+  {
+    lock_guard<mutex> lk(sh.mtx);
+    stats.hits += static_cast<long long>(sh.hits);
+    stats.misses += static_cast<long long>(sh.misses);
+    stats.evictions += static_cast<long long>(sh.evictions);
+    stats.entries += static_cast<int>(sh.lru.size());
+  }
+  stats.capacity = static_cast<int>(capacity);
+}
@@ -0,0 +1,94 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_RESULTCACHE_H
+#define DDS_RESULTCACHE_H
+
+#include <atomic>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <api/dll.h>
+#include "DealFingerprint.hpp"
+
+using namespace std;
+
+#define DDS_RESULT_CACHE_SHARDS 16
+
+
+/**
+ * @brief Process-wide cache of solved results keyed by deal fingerprint.
+ *
+ * Lets the solvers answer a deal that was already solved in the same
+ * process without searching it again. The entries are split over
+ * shards by fingerprint, each with its own lock and its own LRU list,
+ * so that threads rarely wait for each other. When a shard is full,
+ * its least recently used entry is evicted. The capacity is 0, so
+ * the cache is off, until it is set. ResultCache is an internal
+ * component and not part of the public API.
+ */
+class ResultCache
+{
+  private:
+
+    struct entryType
+    {
+      dealFingerprint fp;
+      futureTricks fut;
+    };
+
+    struct shardType
+    {
+      mutex mtx;
+      list<entryType> lru; // Most recently used first
+      unordered_map<dealFingerprint, list<entryType>::iterator,
+        dealFingerprintHash> index;
+      size_t capacity;
+
+      unsigned long long hits;
+      unsigned long long misses;
+      unsigned long long evictions;
+    };
+
+    vector<shardType> shards;
+
+    atomic<size_t> capacity;
+
+    shardType& Shard(const dealFingerprint& fp);
+
+  public:
+
+    ResultCache();
+
+    ~ResultCache();
+
+    // Total number of entries over all shards. 0 turns the cache off.
+    void SetCapacity(const size_t maxEntries);
+
+    size_t Capacity() const;
+
+    bool Lookup(
+      const dealFingerprint& fp,
+      futureTricks& fut);
+
+    void Store(
+      const dealFingerprint& fp,
+      const futureTricks& fut);
+
+    // Drops the entries and resets the counters.
+    void Clear();
+
+    size_t Size();
+
+    void GetStats(resultCacheStats& stats);
+};
+
+#endif
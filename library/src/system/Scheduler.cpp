@@ -11,6 +11,7 @@
 #include <iostream>
 
 #include "Scheduler.hpp"
+#include "DealSymmetry.hpp"
 #include <fstream>
 #include <iomanip>
 #include <lookup_tables/LookupTables.hpp>
@@ -105,8 +106,15 @@ void Scheduler::InitTimes()
   timeGroupPredStrain.Init("Group predicted suit/NT", 2);
   timeGroupDiffStrain.Init("Group diff suit/NT", 2);
 
+  timeMax = 0;
   blockMax = 0;
   timeBlock = 0;
+
+  threadIdle.assign(static_cast<unsigned>(numThreads), 0);
+  makespan = 0;
+  makespanMax = 0;
+  numBlocks = 0;
+  numSteals = 0;
 }
 #endif
 
@@ -149,9 +157,12 @@ void Scheduler::Reset()
   {
     threadGroup[t] = -1;
     threadCurrGroup[t] = -1;
+    threadQueue[t].groups.clear();
+    threadQueue[t].pred = 0;
+#ifdef DDS_SCHEDULER
+    threadFinished[t] = 0;
+#endif
   }
-
-  currGroup = -1;
 }
 
 
@@ -166,10 +177,14 @@ void Scheduler::RegisterThreads(
   threadGroup.resize(nu);
   threadCurrGroup.resize(nu);
   threadToHand.resize(nu);
+  threadQueue = vector<queueType>(nu);
 
 #ifdef DDS_SCHEDULER
   timeThread.Init("Threads", numThreads);
   timersThread.resize(numThreads);
+  threadDone.resize(nu);
+  threadFinished.resize(nu);
+  threadIdle.assign(nu, 0);
 #endif
 }
 
@@ -197,7 +212,7 @@ void Scheduler::RegisterRun(
   // First split the hands according to strain and hash key.
   // This will lead to a few random collisions as well.
 
-  Scheduler::MakeGroups(bds);
+  Scheduler::MakeGroups(mode, bds);
 
   // Then check whether groups with at least two elements are
   // homogeneous or whether they need to be split.
@@ -205,6 +220,8 @@ void Scheduler::RegisterRun(
   Scheduler::FinetuneGroups();
 
   Scheduler::SortHands(mode);
+
+  Scheduler::DistributeGroups();
 }
 
 
@@ -221,14 +238,31 @@ void Scheduler::SortHands(const enum RunMode mode)
 }
 
 
-void Scheduler::MakeGroups(const boards& bds)
+void Scheduler::MakeGroups(
+  const enum RunMode mode,
+  const boards& bds)
 {
   deal const * dl;
+  deal canon;
   listType * lp;
 
   for (int b = 0; b < numHands; b++)
   {
-    dl = &bds.deals[b];
+    // A calc run solves all four declarers, so deals that only differ
+    // by a rotation of the seats or by the names of the non-trump
+    // suits are grouped, as repeats, on their canonical form.
+    if (mode == DDS_RUN_CALC)
+    {
+      dealSymmetry sym;
+      CanonicalDeal(bds.deals[b], canon, sym);
+      hands[b].rotation = sym.rotation;
+      dl = &canon;
+    }
+    else
+    {
+      hands[b].rotation = 0;
+      dl = &bds.deals[b];
+    }
 
     int strain = dl->trump;
 
@@ -760,6 +794,83 @@ int Scheduler::Fanout(const deal& dl) const
 }
 
 
+void Scheduler::DistributeGroups()
+{
+  // The groups are sorted by decreasing predicted time. Deal them
+  // out greedily, each to the thread with the least predicted work
+  // so far. With one thread this is just the sorted order.
+
+  const unsigned nu = static_cast<unsigned>(numThreads);
+  for (int g = 0; g < numGroups; g++)
+  {
+    unsigned best = 0;
+    for (unsigned t = 1; t < nu; t++)
+      if (threadQueue[t].pred < threadQueue[best].pred)
+        best = t;
+
+    threadQueue[best].groups.push_back(g);
+    threadQueue[best].pred += group[g].pred;
+  }
+}
+
+
+int Scheduler::NextGroup(const unsigned tu)
+{
+  {
+    queueType& own = threadQueue[tu];
+    lock_guard<mutex> lk(own.mtx);
+    if (! own.groups.empty())
+    {
+      const int g = own.groups.front();
+      own.groups.pop_front();
+      own.pred -= group[g].pred;
+      return g;
+    }
+  }
+
+  // Own queue is empty, so steal from the thread that has the most
+  // predicted work waiting. Its owner is busy with a group of its
+  // own, so the front (largest) group is the one that would
+  // otherwise end up in the tail of the batch.
+
+  const unsigned nu = static_cast<unsigned>(numThreads);
+  while (true)
+  {
+    unsigned victim = nu;
+    long long most = -1;
+    for (unsigned t = 0; t < nu; t++)
+    {
+      if (t == tu)
+        continue;
+
+      queueType& q = threadQueue[t];
+      lock_guard<mutex> lk(q.mtx);
+      if (! q.groups.empty() && q.pred > most)
+      {
+        most = q.pred;
+        victim = t;
+      }
+    }
+
+    if (victim == nu)
+      return -1;
+
+    queueType& q = threadQueue[victim];
+    lock_guard<mutex> lk(q.mtx);
+    if (q.groups.empty())
+      continue; // Someone else got there first.
+
+    const int g = q.groups.front();
+    q.groups.pop_front();
+    q.pred -= group[g].pred;
+#ifdef DDS_SCHEDULER
+    numSteals++;
+#endif
+    return g;
+  }
+}
+
+
 schedType Scheduler::GetNumber(const int thrId)
 {
   const unsigned tu = static_cast<unsigned>(thrId);
@@ -771,22 +882,18 @@ schedType Scheduler::GetNumber(const int thrId)
   {
     // Find a new group
 
-    if (currGroup >= numGroups - 1)
-    {
-      // Out of groups. Just an optimization not to touch the
-      // shared variable unnecessarily.
-      st.number = -1;
-      return st;
-    }
+    g = Scheduler::NextGroup(tu);
 
-    // Atomic.
-    g = ++currGroup;
-
-    if (g >= numGroups)
+    if (g == -1)
     {
-      // Out of groups. currGroup could have changed in the
-      // meantime in another thread, so test again.
-
+      // Out of groups, both our own and everybody else's.
+#ifdef DDS_SCHEDULER
+      if (! threadFinished[tu])
+      {
+        threadFinished[tu] = 1;
+        threadDone[tu] = chrono::steady_clock::now();
+      }
+#endif
       st.number = -1;
       return st;
     }
@@ -842,6 +949,12 @@ schedType Scheduler::GetNumber(const int thrId)
 }
 
 
+int Scheduler::Rotation(const int hno) const
+{
+  return hands[hno].rotation;
+}
+
+
 int Scheduler::NumGroups() const
 {
   return numGroups;
@@ -872,6 +985,7 @@ void Scheduler::StartBlockTimer()
 {
   timerBlock.Reset();
   timerBlock.Start();
+  blockStart = chrono::steady_clock::now();
 }
 
 
@@ -885,7 +999,8 @@ void Scheduler::EndBlockTimer()
   {
     hp = &hands[b];
     int timeUser = hp->time;
-    double timesq = (double) timeUser * (double) timeUser;
+    double timesq = static_cast<double>(timeUser) *
+      static_cast<double>(timeUser);
 
     if (hp->selectFlag)
     {
@@ -936,6 +1051,35 @@ void Scheduler::EndBlockTimer()
   timeBlock += timeUserBlock;
   timeMax += blockMax;
   blockMax = 0;
+
+  // Makespan is the wall time until the last thread ran out of work.
+  // A thread is idle from the moment it ran out until then. Threads
+  // that never asked for work (e.g. single-board runs) are idle for
+  // the whole block.
+
+  const auto blockEnd = chrono::steady_clock::now();
+  auto lastDone = blockStart;
+  for (unsigned t = 0; t < static_cast<unsigned>(numThreads); t++)
+    if (threadFinished[t] && threadDone[t] > lastDone)
+      lastDone = threadDone[t];
+  if (lastDone == blockStart)
+    lastDone = blockEnd;
+
+  const long long span = chrono::duration_cast<chrono::microseconds>(
+    lastDone - blockStart).count();
+  makespan += span;
+  if (span > makespanMax)
+    makespanMax = span;
+  numBlocks++;
+
+  for (unsigned t = 0; t < static_cast<unsigned>(numThreads); t++)
+  {
+    if (threadFinished[t])
+      threadIdle[t] += chrono::duration_cast<chrono::microseconds>(
+        lastDone - threadDone[t]).count();
+    else
+      threadIdle[t] += span;
+  }
 }
 
 
@@ -975,12 +1119,35 @@ void Scheduler::PrintTiming() const
   if (timeBlock == 0)
     return;
 
-  const double avg = 100. * (double) timeMax / (double) timeBlock;
+  const double avg = 100. * static_cast<double>(timeMax) /
+    static_cast<double>(timeBlock);
   fout << "Largest hand" <<
     setw(13) << timeMax << 
     setw(13) << timeBlock <<
     setw(6) << setprecision(2) << fixed << avg << "%\n\n";
 
+  fout << "Batch makespan (wall, us)\n";
+  fout << left << setw(12) << "Blocks" << right << setw(14) << 
+    numBlocks << "\n";
+  fout << left << setw(12) << "Total" << right << setw(14) << 
+    makespan << "\n";
+  fout << left << setw(12) << "Largest" << right << setw(14) << 
+    makespanMax << "\n";
+  fout << left << setw(12) << "Steals" << right << setw(14) << 
+    numSteals.load() << "\n\n";
+
+  fout << setw(6) << "Thread" << setw(14) << "Idle (us)" << 
+    setw(8) << "Idle" << "\n";
+  for (unsigned t = 0; t < threadIdle.size(); t++)
+  {
+    const double pct = (makespan == 0 ? 0. :
+      100. * static_cast<double>(threadIdle[t]) /
+        static_cast<double>(makespan));
+    fout << setw(6) << t << setw(14) << threadIdle[t] <<
+      setw(7) << setprecision(2) << fixed << pct << "%\n";
+  }
+  fout << "\n";
+
   fout.close();
 }
 
@@ -12,6 +12,9 @@
 
 #include <atomic>
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <chrono>
 
 #include <api/dds.h>
 #include "Timer.hpp"
@@ -88,6 +91,7 @@ class Scheduler
       int NTflag;
       int first;
       int strain;
+      int rotation;
       int repeatNo;
       int depth;
       int strength;
@@ -103,7 +107,22 @@ class Scheduler
     int numGroups;
     int extraGroups;
 
-    atomic<int> currGroup;
+    // Groups waiting to be solved, per thread. A thread takes groups
+    // from the front of its own queue and, once that is empty, steals
+    // the front group of the queue with the most predicted work left.
+    // Groups are never split, so repeat detection within a group holds.
+    struct queueType
+    {
+      mutex mtx;
+      deque<int> groups;
+      long long pred;
+    };
+
+    vector<queueType> threadQueue;
+
+    void DistributeGroups();
+
+    int NextGroup(const unsigned tu);
 
     listType list[DDS_SUITS + 2][HASH_MAX];
 
@@ -131,7 +150,9 @@ class Scheduler
     vector<Timer> timersThread;
     Timer timerBlock;
 
-    void MakeGroups(const boards& bds);
+    void MakeGroups(
+      const enum RunMode mode,
+      const boards& bds);
 
     void FinetuneGroups();
 
@@ -163,6 +184,16 @@ class Scheduler
     long long blockMax;
     long long timeBlock;
 
+    // Wall-clock batch statistics for the work distribution.
+    chrono::steady_clock::time_point blockStart;
+    vector<chrono::steady_clock::time_point> threadDone;
+    vector<char> threadFinished;
+    vector<long long> threadIdle;
+    long long makespan;
+    long long makespanMax;
+    int numBlocks;
+    atomic<int> numSteals;
+
     void InitTimes();
 #endif
 
@@ -207,6 +238,11 @@ class Scheduler
 
     schedType GetNumber(const int thrId);
 
+    // Seat rotation of a hand onto the canonical deal that its group
+    // shares. Only calc runs group by canonical deals, see
+    // CanonicalDeal; otherwise it is 0.
+    int Rotation(const int hno) const;
+
     int NumGroups() const;
 
   /**
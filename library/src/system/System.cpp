@@ -12,12 +12,11 @@
 #include <iomanip>
 #include <sstream>
 #include <cstring>
+#include <functional>
 
 #include "System.hpp"
 #include "Scheduler.hpp"
 
-extern Scheduler scheduler;
-
 // Boost: Disable some header warnings.
 
 #ifdef DDS_THREADS_BOOST
@@ -172,6 +171,8 @@ System::System(
   CallbackCopyList[DDS_RUN_SOLVE] = copy_solve_single;
   CallbackCopyList[DDS_RUN_CALC] = copy_calc_single;
   CallbackCopyList[DDS_RUN_TRACE] = copy_play_single;
+
+  owner = nullptr;
   System::Reset();
 }
 
@@ -296,6 +297,12 @@ void System::GetHardware(
 }
 
 
+void System::SetOwner(EngineState& eng)
+{
+  owner = &eng;
+}
+
+
 int System::RegisterParams(
   const int nThreads,
   const int mem_usable_MB)
@@ -310,6 +317,21 @@ int System::RegisterParams(
 }
 
 
+void System::StartThreads()
+{
+#ifdef DDS_THREADS_STL
+  if (preferredSystem == DDS_SYSTEM_THREAD_STL)
+    pool.Start(static_cast<unsigned>(numThreads));
+#endif
+}
+
+
+void System::StopThreads()
+{
+  pool.Stop();
+}
+
+
 int System::RegisterRun(
   const RunMode mode,
   const boards& bdsIn)
@@ -335,6 +357,16 @@ bool System::IsIMPL() const
 }
 
 
+bool System::IsProcessWide(const unsigned code) const
+{
+  return (code == DDS_SYSTEM_THREAD_WINAPI ||
+    code == DDS_SYSTEM_THREAD_OPENMP ||
+    code == DDS_SYSTEM_THREAD_GCD ||
+    code == DDS_SYSTEM_THREAD_STLIMPL ||
+    code == DDS_SYSTEM_THREAD_PPLIMPL);
+}
+
+
 bool System::ThreadOK(const int thrId) const
 {
   return (thrId >= 0 && thrId < numThreads);
@@ -349,6 +381,9 @@ int System::PreferThreading(const unsigned code)
   if (! availableSystem[code])
     return RETURN_THREAD_MISSING;
 
+  if (code != DDS_SYSTEM_THREAD_STL)
+    pool.Stop();
+
   preferredSystem = code;
   return RETURN_NO_FAULT;
 }
@@ -360,7 +395,7 @@ int System::PreferThreading(const unsigned code)
 
 int System::RunThreadsBasic()
 {
-  (*fptr)(0);
+  (*fptr)(* owner, 0);
   return RETURN_NO_FAULT;
 }
 
@@ -374,6 +409,7 @@ struct WinWrapType
 {
   int thrId;
   fptrType fptr;
+  EngineState * eng;
   HANDLE *waitPtr;
 };
 
@@ -382,7 +418,7 @@ DWORD CALLBACK WinCallback(void * p);
 DWORD CALLBACK WinCallback(void * p)
 {
   WinWrapType * winWrap = static_cast<WinWrapType *>(p);
-  (*(winWrap->fptr))(winWrap->thrId);
+  (*(winWrap->fptr))(* winWrap->eng, winWrap->thrId);
 
   if (SetEvent(winWrap->waitPtr[winWrap->thrId]) == 0)
     return 0;
@@ -413,6 +449,7 @@ int System::RunThreadsWinAPI()
   {
     winWrap[k].thrId = static_cast<int>(k);
     winWrap[k].fptr = fptr;
+    winWrap[k].eng = owner;
     winWrap[k].waitPtr = solveAllEvents;
 
     int res = QueueUserWorkItem(WinCallback,
@@ -457,7 +494,7 @@ int System::RunThreadsOpenMP()
     for (int k = 0; k < numThreads; k++)
     {
       int thrId = omp_get_thread_num();
-      (*fptr)(thrId);
+      (*fptr)(* owner, thrId);
     }
   }
 #endif
@@ -478,7 +515,7 @@ int System::RunThreadsGCD()
     ^(size_t t)
   {
     int thrId = static_cast<int>(t);
-    (*fptr)(thrId);
+    (*fptr)(* owner, thrId);
   });
 #endif
 
@@ -499,7 +536,7 @@ int System::RunThreadsBoost()
   threads.resize(nu);
 
   for (unsigned k = 0; k < nu; k++)
-    threads[k] = new boost::thread(fptr, k);
+    threads[k] = new boost::thread(fptr, std::ref(* owner), k);
 
   for (unsigned k = 0; k < nu; k++)
   {
@@ -519,23 +556,12 @@ int System::RunThreadsBoost()
 int System::RunThreadsSTL()
 {
 #ifdef DDS_THREADS_STL
-  vector<thread *> threads;
-
-  vector<int> uniques;
-  vector<int> crossrefs;
-  (* CallbackDuplList[runCat])(* bop, uniques, crossrefs);
-
-  const unsigned nu = static_cast<unsigned>(numThreads);
-  threads.resize(nu);
-
-  for (unsigned k = 0; k < nu; k++)
-    threads[k] = new thread(fptr, k);
-
-  for (unsigned k = 0; k < nu; k++)
-  {
-    threads[k]->join();
-    delete threads[k];
-  }
+  // The workers pull their own boards from the scheduler, so there are
+  // no duplicates to find here, and RunThreads(f) needs no board list.
+  // The workers normally exist already (SetResources). Starting here
+  // covers a switch of backend or a run after FreeMemory.
+  pool.Start(static_cast<unsigned>(numThreads));
+  pool.Run([this](const int thrId) { (*fptr)(* owner, thrId); });
 #endif
 
   return RETURN_NO_FAULT;
@@ -547,7 +573,7 @@ int System::RunThreadsSTLIMPL()
 #ifdef DDS_THREADS_STLIMPL
   vector<int> uniques;
   vector<int> crossrefs;
-  (* CallbackDuplList[runCat])(* bop, uniques, crossrefs);
+  (* CallbackDuplList[runCat])(* owner, * bop, uniques, crossrefs);
 
   static atomic<int> thrIdNext = 0;
   bool err = false;
@@ -567,7 +593,7 @@ int System::RunThreadsSTLIMPL()
     if (realThrId == -1)
       err = true;
     else
-      (* CallbackSingleList[runCat])(realThrId, bno);
+      (* CallbackSingleList[runCat])(* owner, realThrId, bno);
 
     if (! ThreadMgr::instance()::instance().Release(thrId))
       err = true;
@@ -579,7 +605,7 @@ int System::RunThreadsSTLIMPL()
     return RETURN_THREAD_INDEX;
   }
 
-  (* CallbackCopyList[runCat])(crossrefs);
+  (* CallbackCopyList[runCat])(* owner, crossrefs);
 #endif
 
   return RETURN_NO_FAULT;
@@ -599,7 +625,7 @@ int System::RunThreadsTBB()
   threads.resize(nu);
 
   for (unsigned k = 0; k < nu; k++)
-    threads[k] = new tbb::tbb_thread(fptr, k);
+    threads[k] = new tbb::tbb_thread(fptr, std::ref(* owner), k);
 
   for (unsigned k = 0; k < nu; k++)
   {
@@ -622,7 +648,7 @@ int System::RunThreadsPPLIMPL()
 #ifdef DDS_THREADS_PPLIMPL
   vector<int> uniques;
   vector<int> crossrefs;
-  (* CallbackDuplList[runCat])(* bop, uniques, crossrefs);
+  (* CallbackDuplList[runCat])(* owner, * bop, uniques, crossrefs);
 
   static atomic<int> thrIdNext = 0;
   bool err = false, err2 = false;
@@ -642,7 +668,7 @@ int System::RunThreadsPPLIMPL()
     if (realThrId == -1)
       err = true;
     else
-      (* CallbackSingleList[runCat])(realThrId, bno);
+      (* CallbackSingleList[runCat])(* owner, realThrId, bno);
 
     if (! ThreadMgr::instance().Release(thrId))
       err2 = true;
@@ -659,7 +685,7 @@ int System::RunThreadsPPLIMPL()
     return RETURN_THREAD_INDEX;
   }
 
-  (* CallbackCopyList[runCat])(crossrefs);
+  (* CallbackCopyList[runCat])(* owner, crossrefs);
 #endif
 
   return RETURN_NO_FAULT;
@@ -675,6 +701,19 @@ int System::RunThreads()
 }
 
 
+int System::RunThreads(const fptrType f)
+{
+  fptr = f;
+
+  // The IMPL backends parallelize over the unique boards of a
+  // registered list, which a stream does not have.
+  if (System::IsIMPL())
+    return System::RunThreadsBasic();
+
+  return (this->*RunPtrList[preferredSystem])();
+}
+
+
 //////////////////////////////////////////////////////////////////////
 //                     Self-identification                          //
 //////////////////////////////////////////////////////////////////////
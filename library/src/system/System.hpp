@@ -19,14 +19,19 @@
 #include <array>
 
 #include <api/dds.h>
+#include "ThreadPool.hpp"
 
 using namespace std;
 
-typedef void (*fptrType)(const int thid);
-typedef void (*fduplType)(
+struct EngineState;
+
+// The callbacks run on the state of the engine that owns the System.
+typedef void (*fptrType)(EngineState& eng, const int thid);
+typedef void (*fduplType)(EngineState& eng,
   const boards& bds, vector<int>& uniques, vector<int>& crossrefs);
-typedef void (*fsingleType)(const int thid, const int bno);
-typedef void (*fcopyType)(const vector<int>& crossrefs);
+typedef void (*fsingleType)(EngineState& eng,
+  const int thid, const int bno);
+typedef void (*fcopyType)(EngineState& eng, const vector<int>& crossrefs);
 
 
 /**
@@ -63,6 +68,11 @@ class System
 
     boards const * bop;
 
+    EngineState * owner;
+
+    // Persistent workers for the STL backend.
+    ThreadPool pool;
+
     int RunThreadsBasic();
     int RunThreadsBoost();
     int RunThreadsOpenMP();
@@ -118,10 +128,20 @@ class System
 
     void Reset();
 
+    // The engine whose state is passed to the callbacks.
+    void SetOwner(EngineState& eng);
+
     int RegisterParams(
       const int nThreads,
       const int mem_usable_MB);
 
+    // Starts the persistent workers of the preferred backend, if it
+    // has any, for the registered number of threads.
+    void StartThreads();
+
+    // Stops the persistent workers. The next run starts them again.
+    void StopThreads();
+
     int RegisterRun(
       const RunMode r,
       const boards& bop);
@@ -130,6 +150,10 @@ class System
 
     bool IsIMPL() const;
 
+    // The backends that share thread pools, thread settings or the
+    // thread index map with the whole process.
+    bool IsProcessWide(const unsigned code) const;
+
     bool ThreadOK(const int thrId) const;
 
     void GetHardware(
@@ -139,6 +163,10 @@ class System
     int PreferThreading(const unsigned code);
 
     int RunThreads();
+
+    // Runs f once on each thread, without a registered board list.
+    // Used by the streaming API, where f pulls its own work.
+    int RunThreads(const fptrType f);
 };
 
 #endif
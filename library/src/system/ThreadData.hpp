@@ -3,6 +3,7 @@
 
 #include <api/dds.h>
 #include <moves/Moves.hpp>
+#include <climits>
 #include <string>
 
 
@@ -19,6 +20,8 @@ enum TTmemory
   DDS_TT_LARGE = 1
 };
 
+struct SearchLimits;
+
 struct WinnerEntryType
 {
   int suit;
@@ -56,9 +59,15 @@ struct ThreadData
   int nodes;
   int trickNodes;
 
+  // Limits of the running solve, armed by SolverContext. The search
+  // only looks at them once trickNodes reaches limitCheck, and sets
+  // stopReason to RETURN_TIMEOUT or RETURN_CANCELLED when they are hit.
+  const SearchLimits * limits = nullptr;
+  int limitCheck = INT_MAX;
+  int stopReason = RETURN_NO_FAULT;
+
   // Constant for a given hand.
-  // 960 KB
-  relRanksType rel[8192];
+  cardHoldersType holders;
 
   // Deferred TT configuration for context-owned construction
   // TransTable configuration moved to SolverContext::SolverConfig and
@@ -0,0 +1,104 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include "ThreadPool.hpp"
+
+
+ThreadPool::ThreadPool()
+  : job(nullptr), generation(0), busy(0), stopping(false)
+{
+}
+
+
+ThreadPool::~ThreadPool()
+{
+  ThreadPool::Stop();
+}
+
+
+void ThreadPool::Start(const unsigned n)
+{
+  if (workers.size() == n)
+    return;
+
+  ThreadPool::Stop();
+
+  unsigned seen;
+  {
+    lock_guard<mutex> lk(mtx);
+    stopping = false;
+    seen = generation;
+  }
+
+  workers.reserve(n);
+  for (unsigned k = 0; k < n; k++)
+    workers.emplace_back(&ThreadPool::Work, this, 
+      static_cast<int>(k), seen);
+}
+
+
+void ThreadPool::Stop()
+{
+  if (workers.empty())
+    return;
+
+  {
+    lock_guard<mutex> lk(mtx);
+    stopping = true;
+  }
+  cvWork.notify_all();
+
+  for (auto& w: workers)
+    w.join();
+  workers.clear();
+}
+
+
+unsigned ThreadPool::NumWorkers() const
+{
+  return static_cast<unsigned>(workers.size());
+}
+
+
+void ThreadPool::Run(const jobType& f)
+{
+  unique_lock<mutex> lk(mtx);
+  job = &f;
+  busy = static_cast<unsigned>(workers.size());
+  generation++;
+  cvWork.notify_all();
+
+  cvDone.wait(lk, [this]{ return busy == 0; });
+  job = nullptr;
+}
+
+
+void ThreadPool::Work(
+  const int thrId,
+  unsigned seen)
+{
+  unique_lock<mutex> lk(mtx);
+  while (true)
+  {
+    cvWork.wait(lk, [this, seen]{ return stopping || generation != seen; });
+    if (stopping)
+      return;
+
+    seen = generation;
+    jobType const * f = job;
+
+    lk.unlock();
+    (*f)(thrId);
+    lk.lock();
+
+    if (--busy == 0)
+      cvDone.notify_one();
+  }
+}
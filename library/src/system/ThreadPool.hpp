@@ -0,0 +1,78 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_THREADPOOL_H
+#define DDS_THREADPOOL_H
+
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+
+/**
+ * @brief Long-lived worker threads for the batch solvers.
+ *
+ * ThreadPool starts a fixed set of workers once and parks them on a
+ * condition variable between runs. Run() hands the same function to
+ * every worker and waits until all of them have returned. Worker k is
+ * always called with thread index k, so the per-thread solver state
+ * that belongs to that index stays with one OS thread across batches.
+ * The workers are not pinned to CPUs, as several engines may each run
+ * a pool of their own.
+ * ThreadPool is an internal component and not part of the public API.
+ */
+class ThreadPool
+{
+  private:
+
+    typedef function<void(const int thid)> jobType;
+
+    vector<thread> workers;
+
+    mutex mtx;
+    condition_variable cvWork;
+    condition_variable cvDone;
+
+    jobType const * job;
+    unsigned generation;
+    unsigned busy;
+    bool stopping;
+
+    void Work(
+      const int thrId,
+      unsigned seen);
+
+  public:
+
+    ThreadPool();
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Starts n workers. A running pool of a different size is stopped
+    // first; a running pool of the same size is left alone.
+    void Start(const unsigned n);
+
+    // Wakes and joins all workers. Safe to call on a stopped pool.
+    void Stop();
+
+    unsigned NumWorkers() const;
+
+    // Calls f(k) on worker k for every k and blocks until all
+    // calls have returned. Not reentrant.
+    void Run(const jobType& f);
+};
+
+#endif
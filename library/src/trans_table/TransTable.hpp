@@ -68,6 +68,15 @@ class TransTable
 
     // Pure-virtual modern API
     virtual void init(const int hand_lookup[][15]) = 0;
+    // As init(), for a deal in which suit s only ever has subsets of
+    // held[s] left. A table may then skip per-aggregate data that no
+    // lookup can reach; by default this is just init().
+    virtual void init_deal(
+      const int hand_lookup[][15],
+      const unsigned short /*held*/[])
+    {
+      init(hand_lookup);
+    }
     virtual void set_memory_default(int megabytes) = 0;
     virtual void set_memory_maximum(int megabytes) = 0;
     virtual void make_tt() = 0;
@@ -88,6 +97,9 @@ class TransTable
       const unsigned short win_ranks[],
       const NodeCards& first,
       bool flag) = 0;
+    // Strain of the positions that follow. Only a table that keeps
+    // entries across deals and strains needs it.
+    virtual void set_strain(int /*trump*/) {}
     virtual void print_suits(std::ofstream& fout, int trick, int hand) const = 0;
     virtual void print_all_suits(std::ofstream& fout) const = 0;
     virtual void print_suit_stats(std::ofstream& fout, int trick, int hand) const = 0;
@@ -82,9 +82,11 @@
 #include <iomanip>
 #include <cmath>
 #include <array>
+#include <bit>
 
 #include "TransTableL.hpp"
 #include <utility/Constants.h>
+#include <lookup_tables/LookupTables.hpp>
 
 // Local using-declarations for readability in this implementation file only.
 using std::ofstream;
@@ -99,6 +101,10 @@ using std::dec;
 using std::setprecision;
 using std::fixed;
 using std::to_string;
+using std::countl_zero;
+
+static_assert(static_cast<int>(BLOCKS_PER_ENTRY) <= static_cast<int>(SCAN_COLUMNS),
+  "The scan columns must hold a whole WinBlock");
 
 static auto TTLowestRankTable() -> const std::array<int, 8192>& {
   static const std::array<int, 8192> table = []{
@@ -174,6 +180,7 @@ TransTableL::TransTableL() {
   // zeroing via legacy construction paths. With newer creation flows
   // (via SolverContext), make the invariants explicit here.
   tt_in_use_ = 0;
+  scan_ = active_scan_function();
   mem_state_ = MemState::FROM_POOL;
   pages_default_ = 0;
   pages_current_ = 0;
@@ -206,14 +213,32 @@ TransTableL::~TransTableL() {
 
 
 auto TransTableL::init(const int handLookup[][15]) -> void {
+  // Without knowing which cards are out, every aggregate is reachable.
+  const unsigned short all[DDS_SUITS] = { 0x1fff, 0x1fff, 0x1fff, 0x1fff };
+  TransTableL::init_aggr(handLookup, all);
+}
+
+
+auto TransTableL::init_deal(
+  const int handLookup[][15],
+  const unsigned short held[]) -> void {
+  TransTableL::init_aggr(handLookup, held);
+}
+
+
+auto TransTableL::init_aggr(
+  const int handLookup[][15],
+  const unsigned short held[]) -> void {
   // This is very similar to SetConstants, except that it
   // happens with actual cards. It also makes sense to
   // keep a record of aggr_ranks_ for each suit. These are
   // only used later for xor_set_.
+  //
+  // The cards left in a suit are always a subset of the cards
+  // held when the deal was set up, so only those subsets are
+  // filled. For a partial deal that is far fewer than 8192.
 
-  unsigned int topBitRank = 1;
-  unsigned int topBitNo = 2;
-  Aggr * ap;
+  scan_ = active_scan_function();
 
   for (int s = 0; s < DDS_SUITS; s++) {
     aggr_[0].aggr_ranks_[s] = 0;
@@ -221,42 +246,25 @@ auto TransTableL::init(const int handLookup[][15]) -> void {
     aggr_[0].aggr_bytes_[s][1] = 0;
     aggr_[0].aggr_bytes_[s][2] = 0;
     aggr_[0].aggr_bytes_[s][3] = 0;
-  }
-
-  for (unsigned ind = 1; ind < 8192; ind++) {
-    if (ind >= (topBitRank << 1)) {
-      /* Next top bit */
-      topBitRank <<= 1;
-      topBitNo++;
-    }
-
-    aggr_[ind] = aggr_[ind ^ topBitRank];
-    ap = &aggr_[ind];
 
-    for (int s = 0; s < DDS_SUITS; s++) {
-      ap->aggr_ranks_[s] = ap->aggr_ranks_[s] >> 2 |
-                          static_cast<unsigned>(handLookup[s][topBitNo] << 24);
+    const unsigned suitHeld = held[s] & 0x1fffu;
+
+    // Subsets in increasing order, so the subset without the
+    // top card is always filled before it is needed.
+    for (unsigned ind = suitHeld & (0u - suitHeld); ind != 0;
+         ind = (ind - suitHeld) & suitHeld) {
+      const int topBitNo = highest_rank[ind];
+      const unsigned ranks =
+        aggr_[ind ^ bitMapRank[topBitNo]].aggr_ranks_[s] >> 2 |
+        static_cast<unsigned>(handLookup[s][topBitNo] << 24);
+
+      // Byte b of suit s sits in byte (3 - s) of the word.
+      Aggr * ap = &aggr_[ind];
+      ap->aggr_ranks_[s] = ranks;
+      for (int b = 0; b < TT_BYTES; b++)
+        ap->aggr_bytes_[s][b] =
+          ((ranks << (6 + 8 * b)) & 0xff000000) >> (8 * s);
     }
-
-    ap->aggr_bytes_[0][0] = (ap->aggr_ranks_[0] << 6) & 0xff000000;
-    ap->aggr_bytes_[0][1] = (ap->aggr_ranks_[0] << 14) & 0xff000000;
-    ap->aggr_bytes_[0][2] = (ap->aggr_ranks_[0] << 22) & 0xff000000;
-    ap->aggr_bytes_[0][3] = (ap->aggr_ranks_[0] << 30) & 0xff000000;
-
-    ap->aggr_bytes_[1][0] = (ap->aggr_ranks_[1] >> 2) & 0x00ff0000;
-    ap->aggr_bytes_[1][1] = (ap->aggr_ranks_[1] << 6) & 0x00ff0000;
-    ap->aggr_bytes_[1][2] = (ap->aggr_ranks_[1] << 14) & 0x00ff0000;
-    ap->aggr_bytes_[1][3] = (ap->aggr_ranks_[1] << 22) & 0x00ff0000;
-
-    ap->aggr_bytes_[2][0] = (ap->aggr_ranks_[2] >> 10) & 0x0000ff00;
-    ap->aggr_bytes_[2][1] = (ap->aggr_ranks_[2] >> 2) & 0x0000ff00;
-    ap->aggr_bytes_[2][2] = (ap->aggr_ranks_[2] << 6) & 0x0000ff00;
-    ap->aggr_bytes_[2][3] = (ap->aggr_ranks_[2] << 14) & 0x0000ff00;
-
-    ap->aggr_bytes_[3][0] = (ap->aggr_ranks_[3] >> 18) & 0x000000ff;
-    ap->aggr_bytes_[3][1] = (ap->aggr_ranks_[3] >> 10) & 0x000000ff;
-    ap->aggr_bytes_[3][2] = (ap->aggr_ranks_[3] >> 2) & 0x000000ff;
-    ap->aggr_bytes_[3][3] = (ap->aggr_ranks_[3] << 6) & 0x000000ff;
   }
 }
 
@@ -467,8 +475,10 @@ auto TransTableL::get_next_card_block() -> TransTableL::WinBlock * {
     if (pool_ == nullptr)
       exit(1);
 
+    // Zeroed, as the scan kernels read whole vectors past the
+    // last entry of a block.
     pool_->list_ = static_cast<WinBlock *>
-                  (malloc(BLOCKS_PER_PAGE * sizeof(WinBlock)));
+                  (calloc(BLOCKS_PER_PAGE, sizeof(WinBlock)));
 
     if (! pool_->list_)
       exit(1);
@@ -540,7 +550,7 @@ auto TransTableL::get_next_card_block() -> TransTableL::WinBlock * {
       }
 
       newpoolp->list_ = static_cast<WinBlock *>
-        (malloc(BLOCKS_PER_PAGE * sizeof(WinBlock)));
+        (calloc(BLOCKS_PER_PAGE, sizeof(WinBlock)));
 
       if (! newpoolp->list_) {
         if (! TransTableL::harvest()) {
@@ -764,33 +774,42 @@ auto TransTableL::lookup_suit(
 }
 
 
+// The highest set bit of bits at or below no, or -1.
+static auto highest_match(
+  const uint64_t bits[SCAN_WORDS],
+  const int no) -> int {
+  if (no < 0)
+    return -1;
+
+  int w = no >> 6;
+  uint64_t word = bits[w] & (~uint64_t{0} >> (63 - (no & 63)));
+  while (word == 0) {
+    if (--w < 0)
+      return -1;
+    word = bits[w];
+  }
+  return 64 * w + 63 - countl_zero(word);
+}
+
+
 auto TransTableL::lookup_cards(
   const WinMatch& search,
   WinBlock * bp,
   const int limit,
   bool& lowerFlag) -> NodeCards * {
-  const int n = bp->next_write_no_ - 1;
-  WinMatch * wp = &bp->list_[n];
-
-  // It may be a bit silly to duplicate the code like this.
-  // It could be combined to one loop with a slight overhead.
-
-  for (int i = n; i >= 0; i--, wp--) {
-    if ((wp->top_set1_ ^ search.top_set1_) & wp->top_mask1_)
-      continue;
+  // All card matches at once. The bounds are then checked from the
+  // newest entry backwards, as the ring buffer wraps at next_write_no_.
+  const unsigned searchSet[3] =
+    { search.top_set1_, search.top_set2_, search.top_set3_ };
+  uint64_t bits[SCAN_WORDS];
+  (*scan_)(bp->cols_, bp->next_match_no_, searchSet, bits);
 
-    if (wp->last_mask_no_ != 1) {
-      if ((wp->top_set2_ ^ search.top_set2_) & wp->top_mask2_)
-        continue;
-
-      if (wp->last_mask_no_ != 2) {
-        if ((wp->top_set3_ ^ search.top_set3_) & wp->top_mask3_)
-          continue;
-      }
-    }
+  const int n = bp->next_write_no_ - 1;
+  const int n2 = bp->next_match_no_ - 1;
 
-    // Check bounds.
-    NodeCards * nodep = &wp->first_;
+  for (int i = highest_match(bits, n); i >= 0;
+      i = highest_match(bits, i - 1)) {
+    NodeCards * nodep = &bp->first_[i];
     if (nodep->lower_bound > limit) {
       bp->timestamp_read_ = ++timestamp_;
       lowerFlag = true;
@@ -803,24 +822,9 @@ auto TransTableL::lookup_cards(
     }
   }
 
-  const int n2 = bp->next_match_no_ - 1;
-  wp = &bp->list_[n2];
-
-  for (int i = n2; i > n; i--, wp--) {
-    if ((wp->top_set1_ ^ search.top_set1_) & wp->top_mask1_)
-      continue;
-
-    if (wp->last_mask_no_ != 1) {
-      if ((wp->top_set2_ ^ search.top_set2_) & wp->top_mask2_)
-        continue;
-
-      if (wp->last_mask_no_ != 2) {
-        if ((wp->top_set3_ ^ search.top_set3_) & wp->top_mask3_)
-          continue;
-      }
-    }
-
-    NodeCards * nodep = &wp->first_;
+  for (int i = highest_match(bits, n2); i > n;
+      i = highest_match(bits, i - 1)) {
+    NodeCards * nodep = &bp->first_[i];
     if (nodep->lower_bound > limit) {
       lowerFlag = true;
       bp->timestamp_read_ = ++timestamp_;
@@ -837,6 +841,43 @@ auto TransTableL::lookup_cards(
 }
 
 
+auto TransTableL::get_match(
+  WinBlock const * bp,
+  const int no) const -> WinMatch {
+  WinMatch match;
+  match.xor_set_ = bp->xor_set_[no];
+  match.top_set1_ = bp->cols_.top_set_[0][no];
+  match.top_set2_ = bp->cols_.top_set_[1][no];
+  match.top_set3_ = bp->cols_.top_set_[2][no];
+  match.top_set4_ = bp->top_set4_[no];
+  match.top_mask1_ = bp->cols_.top_mask_[0][no];
+  match.top_mask2_ = bp->cols_.top_mask_[1][no];
+  match.top_mask3_ = bp->cols_.top_mask_[2][no];
+  match.top_mask4_ = bp->top_mask4_[no];
+  match.mask_index_ = bp->mask_index_[no];
+  match.first_ = bp->first_[no];
+  return match;
+}
+
+
+auto TransTableL::put_match(
+  WinBlock * bp,
+  const int no,
+  const WinMatch& match) -> void {
+  bp->xor_set_[no] = match.xor_set_;
+  bp->cols_.top_set_[0][no] = match.top_set1_;
+  bp->cols_.top_set_[1][no] = match.top_set2_;
+  bp->cols_.top_set_[2][no] = match.top_set3_;
+  bp->top_set4_[no] = match.top_set4_;
+  bp->cols_.top_mask_[0][no] = match.top_mask1_;
+  bp->cols_.top_mask_[1][no] = match.top_mask2_;
+  bp->cols_.top_mask_[2][no] = match.top_mask3_;
+  bp->top_mask4_[no] = match.top_mask4_;
+  bp->mask_index_[no] = match.mask_index_;
+  bp->first_[no] = match.first_;
+}
+
+
 auto TransTableL::create_or_update(
   WinBlock * bp,
   const WinMatch& search,
@@ -846,17 +887,16 @@ auto TransTableL::create_or_update(
   // is not already full, or the oldest one in the list_ is
   // overwritten.
 
-  WinMatch * wp = bp->list_;
   int n = bp->next_match_no_;
 
-  for (int i = 0; i < n; i++, wp++) {
-    if (wp->xor_set_ != search.xor_set_ ) continue;
-    if (wp->mask_index_ != search.mask_index_) continue;
-    if (wp->top_set1_ != search.top_set1_ ) continue;
-    if (wp->top_set2_ != search.top_set2_ ) continue;
-    if (wp->top_set3_ != search.top_set3_ ) continue;
+  for (int i = 0; i < n; i++) {
+    if (bp->xor_set_[i] != search.xor_set_ ) continue;
+    if (bp->mask_index_[i] != search.mask_index_) continue;
+    if (bp->cols_.top_set_[0][i] != search.top_set1_ ) continue;
+    if (bp->cols_.top_set_[1][i] != search.top_set2_ ) continue;
+    if (bp->cols_.top_set_[2][i] != search.top_set3_ ) continue;
 
-    NodeCards& node = wp->first_;
+    NodeCards& node = bp->first_[i];
     if (search.first_.lower_bound > node.lower_bound)
       node.lower_bound = search.first_.lower_bound;
     if (search.first_.upper_bound < node.upper_bound)
@@ -874,13 +914,12 @@ auto TransTableL::create_or_update(
   else
     bp->next_match_no_++;
 
-
-  wp = &bp->list_[ bp->next_write_no_++ ];
-  *wp = search;
+  const int no = bp->next_write_no_++;
+  TransTableL::put_match(bp, no, search);
 
   if (!flag) {
-    wp->first_.best_move_suit = 0;
-    wp->first_.best_move_rank = 0;
+    bp->first_[no].best_move_suit = 0;
+    bp->first_[no].best_move_rank = 0;
   }
 }
 
@@ -949,18 +988,11 @@ auto TransTableL::add(
   TTentry.top_mask3_ = mb[0][2] | mb[1][2] | mb[2][2] | mb[3][2];
   TTentry.top_mask4_ = mb[0][3] | mb[1][3] | mb[2][3] | mb[3][3];
 
+  // The masks run from the ace down, so when top_mask2_ is zero, so
+  // is top_mask3_. lookup_cards() relies on that instead of a count.
   TTentry.mask_index_ =
     (low[0] << 12) | (low[1] << 8) | (low[2] << 4) | low[3];
 
-  if (TTentry.top_mask2_ == 0)
-    TTentry.last_mask_no_ = 1;
-  else if (TTentry.top_mask3_ == 0)
-    TTentry.last_mask_no_ = 2;
-  else if (TTentry.top_mask4_ == 0)
-    TTentry.last_mask_no_ = 3;
-  else
-    TTentry.last_mask_no_ = 4;
-
   TransTableL::create_or_update(last_block_seen_[tricks][hand],
     TTentry, flag);
 }
@@ -1425,7 +1457,8 @@ auto TransTableL::print_entries_block(
     st = "Entry number " + to_string(j+1);
     fout << st << "\n";
     fout << string(st.size(), '-') << "\n\n";
-    TransTableL::print_match(fout, bp->list_[j], lengths);
+    TransTableL::print_match(fout,
+      TransTableL::get_match(bp, j), lengths);
   }
 }
 
@@ -1464,27 +1497,19 @@ auto TransTableL::print_entries_dist_and_cards(
   TTentry.top_set3_ = ab0[2] | ab1[2] | ab2[2] | ab3[2];
   TTentry.top_set4_ = ab0[3] | ab1[3] | ab2[3] | ab3[3];
 
+  const unsigned searchSet[3] =
+    { TTentry.top_set1_, TTentry.top_set2_, TTentry.top_set3_ };
+  uint64_t bits[SCAN_WORDS];
+  (*scan_)(bp->cols_, bp->next_match_no_, searchSet, bits);
+
   int matchNo = 1;
   int n = bp->next_match_no_ - 1;
-  WinMatch const * wp = &bp->list_[n];
-
-  for (int i = n; i >= 0; i--, wp--) {
-    if ((wp->top_set1_ ^ TTentry.top_set1_) & wp->top_mask1_)
-      continue;
-
-    if (wp->last_mask_no_ != 1) {
-      if ((wp->top_set2_ ^ TTentry.top_set2_) & wp->top_mask2_)
-        continue;
-
-      if (wp->last_mask_no_ != 2) {
-        if ((wp->top_set3_ ^ TTentry.top_set3_) & wp->top_mask3_)
-          continue;
-      }
-    }
 
+  for (int i = highest_match(bits, n); i >= 0;
+      i = highest_match(bits, i - 1)) {
     fout << "Match number " << matchNo++ << "\n";
     fout << string(15, '-') << "\n";
-    TransTableL::print_match(fout, bp->list_[i], len);
+    TransTableL::print_match(fout, TransTableL::get_match(bp, i), len);
   }
 
   if (matchNo == 1)
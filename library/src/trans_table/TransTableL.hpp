@@ -20,6 +20,7 @@
 #include <string>
 
 #include "TransTable.hpp"
+#include "WinMatchScan.hpp"
 
 
 enum {
@@ -42,22 +43,28 @@ class TransTableL: public TransTable
 {
   private:
 
-    struct WinMatch // 52 bytes
+    struct WinMatch // 48 bytes
     {
       unsigned xor_set_;
       unsigned top_set1_ , top_set2_ , top_set3_ , top_set4_ ;
       unsigned top_mask1_, top_mask2_, top_mask3_, top_mask4_;
       int mask_index_;
-      int last_mask_no_;
       NodeCards first_;
     };
 
-    struct WinBlock // 6508 bytes when BLOCKS_PER_ENTRY == 125
+    // The entries are stored as columns. lookup_cards() only reads
+    // cols_, which the scan kernels compare many entries at a time.
+    struct WinBlock // 6084 bytes when BLOCKS_PER_ENTRY == 125
     {
       int next_match_no_;
       int next_write_no_;
       int timestamp_read_;
-      WinMatch list_[BLOCKS_PER_ENTRY];
+      WinColumns cols_;
+      unsigned xor_set_[BLOCKS_PER_ENTRY];
+      unsigned top_set4_[BLOCKS_PER_ENTRY];
+      unsigned top_mask4_[BLOCKS_PER_ENTRY];
+      int mask_index_[BLOCKS_PER_ENTRY];
+      NodeCards first_[BLOCKS_PER_ENTRY];
     };
 
     struct PosSearch // 16 bytes (inefficiency, 12 bytes enough)
@@ -120,8 +127,9 @@ class TransTableL: public TransTable
 
     PageStats page_stats_;
 
-    // aggr is constant for a given hand.
-    Aggr aggr_[8192]; // 64 KB
+    // aggr is constant for a given hand. Only the entries for
+    // subsets of the cards held in a suit are filled for that suit.
+    Aggr aggr_[8192]; // 640 KB
 
     // This is the real transposition table.
     // The last index is the hash.
@@ -140,9 +148,15 @@ class TransTableL: public TransTable
     int timestamp_;
     int tt_in_use_;
 
+    ScanFunction scan_;
+
 
     auto init_tt() -> void;
 
+    auto init_aggr(
+      const int hand_lookup[][15],
+      const unsigned short held[]) -> void;
+
     auto release_tt() -> void;
 
   // Constants are provided via internal function-local static tables.
@@ -162,6 +176,15 @@ class TransTableL: public TransTable
       int limit,
       bool& lowerFlag) -> NodeCards *;
 
+    auto get_match(
+      WinBlock const * bp,
+      int no) const -> WinMatch;
+
+    auto put_match(
+      WinBlock * bp,
+      int no,
+      const WinMatch& match) -> void;
+
     auto create_or_update(
       WinBlock * bp,
       const WinMatch& search,
@@ -288,6 +311,9 @@ class TransTableL: public TransTable
 
     // Modern overrides (out-of-line implementations in .cpp)
     void init(const int hand_lookup[][15]) override;
+    void init_deal(
+      const int hand_lookup[][15],
+      const unsigned short held[]) override;
     void set_memory_default(int megabytes) override;
     void set_memory_maximum(int megabytes) override;
     void make_tt() override;
@@ -14,6 +14,8 @@
 #include <api/dds.h>
 
 #include "TransTableS.hpp"
+#include <utility/Constants.h>
+#include <lookup_tables/LookupTables.hpp>
 
 #define NSIZE 50000
 #define WSIZE 50000
@@ -78,33 +80,37 @@ TransTableS::~TransTableS()
 
 
 auto TransTableS::init(const int handLookup[][15]) -> void {
-  unsigned int topBitRank = 1;
-  unsigned int topBitNo = 2;
+  // Without knowing which cards are out, every aggregate is reachable.
+  const unsigned short all[DDS_SUITS] = { 0x1fff, 0x1fff, 0x1fff, 0x1fff };
+  TransTableS::init_deal(handLookup, all);
+}
+
+
+auto TransTableS::init_deal(
+  const int handLookup[][15],
+  const unsigned short held[]) -> void {
+  // Only subsets of the cards held in a suit are filled for that
+  // suit, in increasing order so that the subset without the top
+  // card is always ready.
 
   for (int s = 0; s < DDS_SUITS; s++)
   {
     aggp_[0].aggr_ranks_[s] = 0;
     aggp_[0].win_mask_[s] = 0;
-  }
 
-  for (unsigned int ind = 1; ind < 8192; ind++)
-  {
-    if (ind >= (topBitRank + topBitRank))
+    const unsigned suitHeld = held[s] & 0x1fffu;
+    for (unsigned ind = suitHeld & (0u - suitHeld); ind != 0;
+         ind = (ind - suitHeld) & suitHeld)
     {
-      /* Next top bit */
-      topBitRank <<= 1;
-      topBitNo++;
-    }
-    aggp_[ind] = aggp_[ind ^ topBitRank];
+      const int topBitNo = highest_rank[ind];
+      const unsigned rest = ind ^ bitMapRank[topBitNo];
 
-    for (int s = 0; s < 4; s++)
-    {
       aggp_[ind].aggr_ranks_[s] =
-        (aggp_[ind].aggr_ranks_[s] >> 2) |
+        (aggp_[rest].aggr_ranks_[s] >> 2) |
         (handLookup[s][topBitNo] << 24);
 
       aggp_[ind].win_mask_[s] =
-        (aggp_[ind].win_mask_[s] >> 2) | (3 << 24);
+        (aggp_[rest].win_mask_[s] >> 2) | (3 << 24);
     }
   }
 
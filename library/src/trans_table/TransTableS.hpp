@@ -162,6 +162,9 @@ class TransTableS: public TransTable
     ~TransTableS();
 
     void init(const int hand_lookup[][15]) override;
+    void init_deal(
+      const int hand_lookup[][15],
+      const unsigned short held[]) override;
     void set_memory_default(int megabytes) override;
     void set_memory_maximum(int megabytes) override;
     void make_tt() override;
@@ -0,0 +1,305 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include <cstdlib>
+#include <cstring>
+
+#include "TransTableShared.hpp"
+#include <lookup_tables/LookupTables.hpp>
+
+
+// The low bits of the check word hold the tricks left, which decides
+// which slot of a full bucket is replaced.
+static constexpr uint64_t CHECK_TRICKS_MASK = 0xf;
+
+// Positions with fewer tricks left are cheap to search again, and
+// publishing them costs more in cache misses than the hits save.
+static constexpr int SHARED_MIN_TRICKS = 8;
+
+
+static auto Mix(uint64_t x) -> uint64_t {
+  // The splitmix64 finalizer.
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+
+static auto ToWord(const NodeCards& node) -> uint64_t {
+  static_assert(sizeof(NodeCards) == sizeof(uint64_t),
+    "NodeCards must fit in one shared slot");
+  uint64_t word;
+  std::memcpy(&word, &node, sizeof(word));
+  return word;
+}
+
+
+static auto FromWord(const uint64_t word) -> NodeCards {
+  NodeCards node;
+  std::memcpy(&node, &word, sizeof(word));
+  return node;
+}
+
+
+/////////////////////////////////////////////////////////////
+//                                                         //
+// The shared store.                                       //
+//                                                         //
+/////////////////////////////////////////////////////////////
+
+SharedTTStore::SharedTTStore() {
+  mask_ = 0;
+
+  int megabytes = DDS_SHARED_TT_DEF_MB;
+  if (const char* s = std::getenv("DDS_SHARED_TT_MB")) {
+    int v = std::atoi(s);
+    if (v > 0) megabytes = v;
+  }
+  SharedTTStore::resize(megabytes);
+}
+
+
+auto SharedTTStore::instance() -> SharedTTStore& {
+  static SharedTTStore store;
+  return store;
+}
+
+
+auto SharedTTStore::resize(const int megabytes) -> void {
+  // A power of two buckets that fits in the given size.
+  const uint64_t bytes = (megabytes <= 0 ? 0 :
+    static_cast<uint64_t>(megabytes) << 20);
+
+  uint64_t n = 0;
+  if (bytes >= sizeof(bucketType)) {
+    n = 1;
+    while ((n << 1) * sizeof(bucketType) <= bytes)
+      n <<= 1;
+  }
+
+  buckets_ = std::vector<bucketType>(n);
+  mask_ = (n == 0 ? 0 : n - 1);
+}
+
+
+auto SharedTTStore::clear() -> void {
+  for (auto& bucket: buckets_) {
+    for (auto& slot: bucket.slots_) {
+      slot.check_.store(0, std::memory_order_relaxed);
+      slot.data_.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+
+auto SharedTTStore::memory_in_use() const -> double {
+  return buckets_.size() * sizeof(bucketType) / static_cast<double>(1024.);
+}
+
+
+auto SharedTTStore::probe(
+  const keyType& key,
+  NodeCards& node) const -> bool {
+  if (buckets_.empty())
+    return false;
+
+  const bucketType& bucket = buckets_[key.lo & mask_];
+  const uint64_t want = key.hi & ~CHECK_TRICKS_MASK;
+
+  for (const auto& slot: bucket.slots_) {
+    const uint64_t check = slot.check_.load(std::memory_order_relaxed);
+    const uint64_t data = slot.data_.load(std::memory_order_relaxed);
+    if (((check ^ data) & ~CHECK_TRICKS_MASK) == want) {
+      node = FromWord(data);
+      return true;
+    }
+  }
+  return false;
+}
+
+
+auto SharedTTStore::store(
+  const keyType& key,
+  const int tricks,
+  const NodeCards& node) -> void {
+  if (buckets_.empty())
+    return;
+
+  bucketType& bucket = buckets_[key.lo & mask_];
+  const uint64_t want = key.hi & ~CHECK_TRICKS_MASK;
+
+  // The same position if it is there, otherwise the slot with the
+  // fewest tricks left. Empty slots have zero tricks.
+  slotType * victim = &bucket.slots_[0];
+  uint64_t victimTricks = CHECK_TRICKS_MASK + 1;
+
+  for (auto& slot: bucket.slots_) {
+    const uint64_t check = slot.check_.load(std::memory_order_relaxed);
+    const uint64_t data = slot.data_.load(std::memory_order_relaxed);
+    if (((check ^ data) & ~CHECK_TRICKS_MASK) == want) {
+      victim = &slot;
+      break;
+    }
+    if ((check & CHECK_TRICKS_MASK) < victimTricks) {
+      victim = &slot;
+      victimTricks = check & CHECK_TRICKS_MASK;
+    }
+  }
+
+  const uint64_t data = ToWord(node);
+  victim->data_.store(data, std::memory_order_relaxed);
+  victim->check_.store(((key.hi ^ data) & ~CHECK_TRICKS_MASK) |
+    (static_cast<uint64_t>(tricks) & CHECK_TRICKS_MASK),
+    std::memory_order_relaxed);
+}
+
+
+/////////////////////////////////////////////////////////////
+//                                                         //
+// The per-thread table.                                   //
+//                                                         //
+/////////////////////////////////////////////////////////////
+
+TransTableShared::TransTableShared() {
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      holding_[h][s] = 0;
+
+  trump_ = DDS_NOTRUMP;
+  hit_ = NodeCards{0, 0, 0, 0, {0, 0, 0, 0}};
+  store_ = &SharedTTStore::instance();
+  shared_hits_ = 0;
+}
+
+
+auto TransTableShared::init(const int handLookup[][15]) -> void {
+  TransTableL::init(handLookup);
+  TransTableShared::set_holding(handLookup);
+}
+
+
+auto TransTableShared::init_deal(
+  const int handLookup[][15],
+  const unsigned short held[]) -> void {
+  TransTableL::init_deal(handLookup, held);
+  TransTableShared::set_holding(handLookup);
+}
+
+
+auto TransTableShared::set_holding(const int handLookup[][15]) -> void {
+  // Bit 0 of an aggregate is the deuce.
+  for (int h = 0; h < DDS_HANDS; h++) {
+    for (int s = 0; s < DDS_SUITS; s++) {
+      unsigned short hold = 0;
+      for (int r = 2; r <= 14; r++) {
+        if (handLookup[s][r] == h)
+          hold |= static_cast<unsigned short>(1 << (r - 2));
+      }
+      holding_[h][s] = hold;
+    }
+  }
+}
+
+
+auto TransTableShared::set_strain(const int trump) -> void {
+  trump_ = trump;
+}
+
+
+auto TransTableShared::make_key(
+  const int tricks,
+  const int hand,
+  const unsigned short aggrTarget[]) const -> SharedTTStore::keyType {
+  SharedTTStore::keyType key;
+  key.lo = 0x6a09e667f3bcc908ULL;
+  key.hi = 0xbb67ae8584caa73bULL;
+
+  for (int s = 0; s < DDS_SUITS; s++) {
+    const uint64_t word =
+      (static_cast<uint64_t>(aggrTarget[s] & holding_[0][s]) << 48) |
+      (static_cast<uint64_t>(aggrTarget[s] & holding_[1][s]) << 32) |
+      (static_cast<uint64_t>(aggrTarget[s] & holding_[2][s]) << 16) |
+       static_cast<uint64_t>(aggrTarget[s] & holding_[3][s]);
+    key.lo = Mix(key.lo + word);
+    key.hi = Mix(key.hi ^ (word * 0x9e3779b97f4a7c15ULL));
+  }
+
+  const uint64_t rest = (static_cast<uint64_t>(trump_) << 16) |
+    (static_cast<uint64_t>(hand) << 8) | static_cast<uint64_t>(tricks);
+  key.lo = Mix(key.lo + rest);
+  key.hi = Mix(key.hi ^ (rest * 0x9e3779b97f4a7c15ULL));
+  return key;
+}
+
+
+auto TransTableShared::lookup(
+  const int tricks,
+  const int hand,
+  const unsigned short aggrTarget[],
+  const int handDist[],
+  const int limit,
+  bool& lowerFlag) -> NodeCards const * {
+  // The private table first, which also prepares add().
+  NodeCards const * cardsP = TransTableL::lookup(
+    tricks, hand, aggrTarget, handDist, limit, lowerFlag);
+  if (cardsP || tricks < SHARED_MIN_TRICKS)
+    return cardsP;
+
+  if (! store_->probe(
+      TransTableShared::make_key(tricks, hand, aggrTarget), hit_))
+    return nullptr;
+
+  // Same bound test as the private table.
+  if (hit_.lower_bound > limit)
+    lowerFlag = true;
+  else if (hit_.upper_bound <= limit)
+    lowerFlag = false;
+  else
+    return nullptr;
+
+  shared_hits_++;
+  return &hit_;
+}
+
+
+auto TransTableShared::add(
+  const int tricks,
+  const int hand,
+  const unsigned short aggrTarget[],
+  const unsigned short ourWinRanks[],
+  const NodeCards& first,
+  const bool flag) -> void {
+  TransTableL::add(tricks, hand, aggrTarget, ourWinRanks, first, flag);
+  if (tricks < SHARED_MIN_TRICKS)
+    return;
+
+  // least_win as TransTableL::add derives it: the number of cards
+  // from the ace down to the lowest rank that mattered.
+  NodeCards node = first;
+  for (int s = 0; s < DDS_SUITS; s++) {
+    const int w = static_cast<int>(ourWinRanks[s]);
+    if (w == 0)
+      node.least_win[s] = 0;
+    else
+      node.least_win[s] = static_cast<char>(
+        count_table[aggrTarget[s] & (-(w & (-w))) & 0x1fff]);
+  }
+
+  store_->store(TransTableShared::make_key(tricks, hand, aggrTarget),
+    tricks, node);
+}
+
+
+auto TransTableShared::shared_hits() const -> long long {
+  return shared_hits_;
+}
@@ -0,0 +1,145 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_TRANSTABLESHARED_H
+#define DDS_TRANSTABLESHARED_H
+
+/*
+   This is TransTableL with a second level that all threads share.
+
+   The private table matches positions by the ranks that mattered,
+   but it depends on the deal that init() was called with, so it
+   cannot be shared. The second level stores exact positions under a
+   128-bit key made up of the actual cards of each hand, the hand on
+   lead and the strain. The same position then has the same key in
+   every thread and for every deal it occurs in.
+
+   The shared store is a lock-free hash table. Each slot is two 64-bit
+   words: the NodeCards payload and a check word, which is the key
+   XOR'ed with the payload. A reader validates the pair against its
+   own key, so a slot that is torn by a concurrent writer simply does
+   not match. Each bucket of four slots is one cache line, and a new
+   entry replaces the slot with the fewest tricks left. Positions near
+   the end of the hand stay private.
+*/
+
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "TransTableL.hpp"
+
+
+#define DDS_SHARED_TT_DEF_MB 64
+
+
+class SharedTTStore
+{
+  public:
+
+    struct keyType
+    {
+      uint64_t lo; // Selects the bucket
+      uint64_t hi; // Validates the slot
+    };
+
+  private:
+
+    struct slotType
+    {
+      std::atomic<uint64_t> check_;
+      std::atomic<uint64_t> data_;
+    };
+
+    struct alignas(64) bucketType
+    {
+      slotType slots_[4];
+    };
+
+    std::vector<bucketType> buckets_;
+    uint64_t mask_;
+
+  public:
+
+    SharedTTStore();
+
+    // The process-wide store that all TransTableShared tables use.
+    static auto instance() -> SharedTTStore&;
+
+    // Not while any thread is solving. 0 releases the memory.
+    auto resize(int megabytes) -> void;
+
+    auto clear() -> void;
+
+    auto memory_in_use() const -> double;
+
+    auto probe(
+      const keyType& key,
+      NodeCards& node) const -> bool;
+
+    auto store(
+      const keyType& key,
+      int tricks,
+      const NodeCards& node) -> void;
+};
+
+
+class TransTableShared: public TransTableL
+{
+  private:
+
+    // The cards of each hand in the current deal, in the same 13-bit
+    // form as aggr_target.
+    unsigned short holding_[DDS_HANDS][DDS_SUITS];
+
+    int trump_;
+
+    NodeCards hit_;
+
+    SharedTTStore * store_;
+
+    long long shared_hits_;
+
+    auto set_holding(const int hand_lookup[][15]) -> void;
+
+    auto make_key(
+      int tricks,
+      int hand,
+      const unsigned short aggr_target[]) const -> SharedTTStore::keyType;
+
+  public:
+
+    TransTableShared();
+
+    void init(const int hand_lookup[][15]) override;
+    void init_deal(
+      const int hand_lookup[][15],
+      const unsigned short held[]) override;
+    void set_strain(int trump) override;
+    auto lookup(
+      int trick,
+      int hand,
+      const unsigned short aggr_target[],
+      const int hand_dist[],
+      int limit,
+      bool& lower_flag) -> NodeCards const * override;
+    void add(
+      int trick,
+      int hand,
+      const unsigned short aggr_target[],
+      const unsigned short win_ranks_arg[],
+      const NodeCards& first,
+      bool flag) override;
+
+    // Lookups answered by the shared store since construction.
+    auto shared_hits() const -> long long;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+
+#include <atomic>
+
+#include "WinMatchScan.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define DDS_SCAN_X86
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
+// GCC and Clang compile a single function for AVX2 this way. MSVC
+// accepts the intrinsics without it.
+#if defined(DDS_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+  #define DDS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+  #define DDS_TARGET_AVX2
+#endif
+
+
+static_assert(SCAN_COLUMNS % 64 == 0,
+  "A column must fill whole bitmap words");
+
+
+static auto clear_tail(
+  const int count,
+  uint64_t bits[SCAN_WORDS]) -> void {
+  for (int w = 0; w < SCAN_WORDS; w++) {
+    const int lo = 64 * w;
+    if (count <= lo)
+      bits[w] = 0;
+    else if (count < lo + 64)
+      bits[w] &= (uint64_t{1} << (count - lo)) - 1;
+  }
+}
+
+
+static auto scan_scalar(
+  const WinColumns& cols,
+  const int count,
+  const unsigned search[3],
+  uint64_t bits[SCAN_WORDS]) -> void {
+  for (int w = 0; w < SCAN_WORDS; w++)
+    bits[w] = 0;
+
+  for (int i = 0; i < count; i++) {
+    const unsigned diff =
+      ((cols.top_set_[0][i] ^ search[0]) & cols.top_mask_[0][i]) |
+      ((cols.top_set_[1][i] ^ search[1]) & cols.top_mask_[1][i]) |
+      ((cols.top_set_[2][i] ^ search[2]) & cols.top_mask_[2][i]);
+    if (diff == 0)
+      bits[i >> 6] |= uint64_t{1} << (i & 63);
+  }
+}
+
+
+#ifdef DDS_SCAN_X86
+
+static auto scan_sse2(
+  const WinColumns& cols,
+  const int count,
+  const unsigned search[3],
+  uint64_t bits[SCAN_WORDS]) -> void {
+  const __m128i s0 = _mm_set1_epi32(static_cast<int>(search[0]));
+  const __m128i s1 = _mm_set1_epi32(static_cast<int>(search[1]));
+  const __m128i s2 = _mm_set1_epi32(static_cast<int>(search[2]));
+  const __m128i zero = _mm_setzero_si128();
+
+  for (int w = 0; w < SCAN_WORDS; w++)
+    bits[w] = 0;
+
+  for (int i = 0; i < count; i += 4) {
+    const __m128i d0 = _mm_and_si128(_mm_xor_si128(s0,
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_set_[0][i]))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_mask_[0][i])));
+    const __m128i d1 = _mm_and_si128(_mm_xor_si128(s1,
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_set_[1][i]))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_mask_[1][i])));
+    const __m128i d2 = _mm_and_si128(_mm_xor_si128(s2,
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_set_[2][i]))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        &cols.top_mask_[2][i])));
+
+    const __m128i eq = _mm_cmpeq_epi32(
+      _mm_or_si128(_mm_or_si128(d0, d1), d2), zero);
+    const unsigned m = static_cast<unsigned>(
+      _mm_movemask_ps(_mm_castsi128_ps(eq)));
+    bits[i >> 6] |= static_cast<uint64_t>(m) << (i & 63);
+  }
+
+  clear_tail(count, bits);
+}
+
+
+DDS_TARGET_AVX2
+static auto scan_avx2(
+  const WinColumns& cols,
+  const int count,
+  const unsigned search[3],
+  uint64_t bits[SCAN_WORDS]) -> void {
+  const __m256i s0 = _mm256_set1_epi32(static_cast<int>(search[0]));
+  const __m256i s1 = _mm256_set1_epi32(static_cast<int>(search[1]));
+  const __m256i s2 = _mm256_set1_epi32(static_cast<int>(search[2]));
+  const __m256i zero = _mm256_setzero_si256();
+
+  for (int w = 0; w < SCAN_WORDS; w++)
+    bits[w] = 0;
+
+  for (int i = 0; i < count; i += 8) {
+    const __m256i d0 = _mm256_and_si256(_mm256_xor_si256(s0,
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_set_[0][i]))),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_mask_[0][i])));
+    const __m256i d1 = _mm256_and_si256(_mm256_xor_si256(s1,
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_set_[1][i]))),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_mask_[1][i])));
+    const __m256i d2 = _mm256_and_si256(_mm256_xor_si256(s2,
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_set_[2][i]))),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        &cols.top_mask_[2][i])));
+
+    const __m256i eq = _mm256_cmpeq_epi32(
+      _mm256_or_si256(_mm256_or_si256(d0, d1), d2), zero);
+    const unsigned m = static_cast<unsigned>(
+      _mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    bits[i >> 6] |= static_cast<uint64_t>(m) << (i & 63);
+  }
+
+  // The rest of the library is not built for AVX, and dirty upper
+  // halves would slow down its SSE code.
+  _mm256_zeroupper();
+
+  clear_tail(count, bits);
+}
+
+
+static auto cpu_has_avx2() -> bool {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+
+  // The OS must also save the YMM registers.
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (! osxsave || ! avx || (_xgetbv(0) & 0x6) != 0x6)
+    return false;
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+
+auto scan_kernel_supported(const ScanKernel kernel) -> bool {
+  switch (kernel) {
+    case ScanKernel::Scalar:
+      return true;
+#ifdef DDS_SCAN_X86
+    case ScanKernel::Sse2:
+      return true;
+    case ScanKernel::Avx2:
+      return cpu_has_avx2();
+#endif
+    default:
+      return false;
+  }
+}
+
+
+auto best_scan_kernel() -> ScanKernel {
+  if (scan_kernel_supported(ScanKernel::Avx2))
+    return ScanKernel::Avx2;
+  if (scan_kernel_supported(ScanKernel::Sse2))
+    return ScanKernel::Sse2;
+  return ScanKernel::Scalar;
+}
+
+
+auto scan_function(const ScanKernel kernel) -> ScanFunction {
+  switch (kernel) {
+#ifdef DDS_SCAN_X86
+    case ScanKernel::Sse2:
+      return scan_sse2;
+    case ScanKernel::Avx2:
+      return scan_avx2;
+#endif
+    default:
+      return scan_scalar;
+  }
+}
+
+
+// Tables read the kernel in init() while a test or a caller may set
+// it from another thread, so it is kept as an atomic.
+static auto scan_state() -> std::atomic<ScanKernel>& {
+  static std::atomic<ScanKernel> state(best_scan_kernel());
+  return state;
+}
+
+
+auto set_scan_kernel(const ScanKernel kernel) -> bool {
+  if (! scan_kernel_supported(kernel))
+    return false;
+
+  scan_state().store(kernel);
+  return true;
+}
+
+
+auto active_scan_kernel() -> ScanKernel {
+  return scan_state().load();
+}
+
+
+auto active_scan_function() -> ScanFunction {
+  return scan_function(scan_state().load());
+}
@@ -0,0 +1,76 @@
+/*
+   DDS, a bridge double dummy solver.
+
+   Copyright (C) 2006-2014 by Bo Haglund /
+   2014-2018 by Bo Haglund & Soren Hein.
+
+   See LICENSE and README.
+*/
+
+#ifndef DDS_WINMATCHSCAN_H
+#define DDS_WINMATCHSCAN_H
+
+/*
+   The card match in TransTableL::lookup_cards compares a position
+   against every entry of a WinBlock. An entry matches when
+
+     ((top_set[k] ^ search[k]) & top_mask[k]) == 0 for k = 0 .. 2.
+
+   The masks of the ranks that did not matter are zero, so the test
+   needs no branches and can be done for many entries at once. The
+   entries are therefore kept as columns, and a kernel turns a whole
+   block into a bitmap of the entries that match.
+
+   The kernel is chosen once from what the CPU supports. The scalar
+   kernel is always available and is the reference for the others.
+*/
+
+
+#include <cstdint>
+
+
+enum {
+  // Entries per column, BLOCKS_PER_ENTRY rounded up to whole
+  // vectors of the widest kernel.
+  SCAN_COLUMNS = 128,
+  SCAN_WORDS = SCAN_COLUMNS / 64
+};
+
+struct WinColumns
+{
+  unsigned top_set_[3][SCAN_COLUMNS];
+  unsigned top_mask_[3][SCAN_COLUMNS];
+};
+
+enum class ScanKernel
+{
+  Scalar,
+  Sse2,
+  Avx2
+};
+
+// Sets bit i of bits for each entry i < count that matches search.
+// Entries from count up to the next whole vector are read but not
+// reported, so the columns must be initialised up to SCAN_COLUMNS.
+using ScanFunction = void (*)(
+  const WinColumns& cols,
+  int count,
+  const unsigned search[3],
+  uint64_t bits[SCAN_WORDS]);
+
+// The fastest kernel that this CPU supports.
+auto best_scan_kernel() -> ScanKernel;
+
+auto scan_kernel_supported(ScanKernel kernel) -> bool;
+
+// Used by all TransTableL tables from their next init(). Returns
+// false, and changes nothing, if the CPU lacks the kernel.
+auto set_scan_kernel(ScanKernel kernel) -> bool;
+
+auto active_scan_kernel() -> ScanKernel;
+
+auto active_scan_function() -> ScanFunction;
+
+auto scan_function(ScanKernel kernel) -> ScanFunction;
+
+#endif
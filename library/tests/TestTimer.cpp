@@ -35,6 +35,8 @@ void TestTimer::reset()
   userCum = 0;
   userCumOld = 0;
   sysCum = 0;
+  units = 0;
+  unitName = "";
 }
 
 
@@ -66,6 +68,18 @@ void TestTimer::end()
 }
 
 
+void TestTimer::setunits(const string& s)
+{
+  unitName = s;
+}
+
+
+void TestTimer::addunits(const long number)
+{
+  units += number;
+}
+
+
 void TestTimer::printRunning(
   const int reached,
   const int divisor)
@@ -144,6 +158,16 @@ void TestTimer::printHands() const
         static_cast<float>(1000. * count) << "\n";
   }
 
+  if (units > 0)
+  {
+    cout << setw(21) << left << ("Number of " + unitName) <<
+      setw(12) << right << units << "\n";
+    if (userCum > 0)
+      cout << setw(21) << left << (unitName + "/s") <<
+        setw(12) << right << fixed << setprecision(1) <<
+        1.e6 * units / static_cast<double>(userCum) << "\n";
+  }
+
   if (sysCum == 0)
     cout << setw(21) << left << "Sys time" << 
       setw(12) << right << "zero" << "\n";
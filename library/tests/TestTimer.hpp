@@ -27,6 +27,8 @@ class TestTimer
     long userCum;
     long userCumOld;
     long sysCum;
+    long units;
+    string unitName;
 
     time_point<Clock> user0;
     clock_t sys0;
@@ -43,6 +45,11 @@ class TestTimer
     void start(const int number = 1);
     void end();
 
+    // Work items other than hands, such as analysed cards. They are
+    // reported with a rate if there are any.
+    void setunits(const string& s);
+    void addunits(const long number);
+
     void printRunning(
       const int reached,
       const int number);
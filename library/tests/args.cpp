@@ -36,7 +36,7 @@ struct optEntry
   unsigned numArgs;
 };
 
-#define DTEST_NUM_OPTIONS 6
+#define DTEST_NUM_OPTIONS 8
 
 const optEntry optList[DTEST_NUM_OPTIONS] =
 {
@@ -45,6 +45,8 @@ const optEntry optList[DTEST_NUM_OPTIONS] =
   {"t", "threading", 1},
   {"n", "numthr", 1},
   {"m", "memory", 1},
+  {"b", "batch", 1},
+  {"x", "sharedtt", 1},
   {"r", "report", 0}
 };
 
@@ -54,7 +56,13 @@ const vector<string> solverList =
   "calc",
   "play",
   "par",
-  "dealerpar"
+  "dealerpar",
+  "single",
+  "stream",
+  "trace",
+  "parallel",
+  "table",
+  "tablepar"
 };
 
 const vector<string> threadingList =
@@ -96,7 +104,17 @@ void Usage(
     "                   '100' means ../hands/list100.txt).\n" <<
     "                   (Default: input.txt)\n" <<
     "\n" <<
-    "-s, --solver       One of: solve, calc, play, par, dealerpar.\n" <<
+    "-s, --solver       One of: solve, calc, play, par, dealerpar,\n" <<
+    "                   single (one SolveBoard call per hand on\n" <<
+    "                   thread 0, reporting per-call latency),\n" <<
+    "                   stream (all hands in one SolveBoardStream),\n" <<
+    "                   trace (one AnalysePlayPBNParallel call per\n" <<
+    "                   hand, reporting per-trace latency),\n" <<
+    "                   parallel (as single, but SolveBoardPBNParallel\n" <<
+    "                   on all threads),\n" <<
+    "                   table (one CalcDDtablePBN call per hand,\n" <<
+    "                   reporting per-table latency),\n" <<
+    "                   tablepar (as table, but CalcDDtablePBNParallel).\n" <<
     "                   (Default: solve)\n" <<
     "\n" <<
     "-t, --threading t  Currently one of (case-insensitive):\n" <<
@@ -112,6 +130,14 @@ void Usage(
     "-m, --memory n     Total DDS memory size in MB.\n" <<
     "                   (Default: 0 meaning that DDS decides)\n" <<
     "\n" <<
+    "-b, --batch n      Boards per batch call for solve, calc, play,\n" <<
+    "                   or the look-ahead window for stream.\n" <<
+    "                   (Default: 0 meaning the DDS maximum)\n" <<
+    "\n" <<
+    "-x, --sharedtt n   Size in MB of a transposition table that\n" <<
+    "                   all threads share (see SetSharedTTSize).\n" <<
+    "                   (Default: 0 meaning private tables only)\n" <<
+    "\n" <<
     endl;
 }
 
@@ -173,6 +199,8 @@ void SetDefaults()
   options.threading = DTEST_THREADING_DEFAULT;
   options.numThreads = 0;
   options.memoryMB = 0;
+  options.batchSize = 0;
+  options.sharedTTMB = 0;
   options.reportSlowBoards = false;
 }
 
@@ -190,6 +218,10 @@ void PrintOptions()
     options.numThreads << "\n";
   cout << setw(12) << "memory" << setw(12) <<  
     options.memoryMB << " MB\n";
+  cout << setw(12) << "batch" << setw(12) <<  
+    options.batchSize << "\n";
+  cout << setw(12) << "sharedtt" << setw(12) <<  
+    options.sharedTTMB << " MB\n";
   cout << "\n" << right;
 }
 
@@ -317,6 +349,28 @@ void ReadArgs(
         options.memoryMB = m;
         break;
 
+      case 'b':
+        m = static_cast<int>(strtol(optarg, &ctmp, 0));
+        if (m < 0)
+        {
+          cout << "Batch size must be >= 0\n\n";
+          nextToken -= 2;
+          errFlag = true;
+        }
+        options.batchSize = m;
+        break;
+
+      case 'x':
+        m = static_cast<int>(strtol(optarg, &ctmp, 0));
+        if (m < 0)
+        {
+          cout << "Shared TT size in MB must be >= 0\n\n";
+          nextToken -= 2;
+          errFlag = true;
+        }
+        options.sharedTTMB = m;
+        break;
+
       case 'r':
         options.reportSlowBoards = true;
         break;
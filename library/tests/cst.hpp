@@ -22,7 +22,13 @@ enum Solver
   DTEST_SOLVER_PLAY = 2,
   DTEST_SOLVER_PAR = 3,
   DTEST_SOLVER_DEALERPAR = 4,
-  DTEST_SOLVER_SIZE = 5
+  DTEST_SOLVER_SINGLE = 5,
+  DTEST_SOLVER_STREAM = 6,
+  DTEST_SOLVER_TRACE = 7,
+  DTEST_SOLVER_PARALLEL = 8,
+  DTEST_SOLVER_TABLE = 9,
+  DTEST_SOLVER_TABLEPAR = 10,
+  DTEST_SOLVER_SIZE = 11
 };
 
 enum Threading
@@ -47,6 +53,8 @@ struct OptionsType
   Threading threading;
   int numThreads;
   int memoryMB;
+  int batchSize;
+  int sharedTTMB;
   bool reportSlowBoards;
 };
 
@@ -30,6 +30,9 @@ int main(int argc, char * argv[])
 
   SetResources(options.memoryMB, options.numThreads);
 
+  if (options.sharedTTMB > 0)
+    SetSharedTTSize(options.sharedTTMB);
+
   DDSInfo info;
   GetDDSInfo(&info);
   cout << info.systemString << endl;
@@ -25,14 +25,14 @@ class HeuristicSortingUnitTest : public ::testing::Test {
   HeuristicContext createBasicContext(pos& tpos, moveType* mply, int numMoves) {
     static moveType bestMove = {};
     static moveType bestMoveTT = {};
-    static relRanksType thrp_rel[1] = {};
+    static cardHoldersType holders = {};
     static trackType track = {};
     
     return HeuristicContext {
         tpos,
         bestMove,
         bestMoveTT,
-        thrp_rel,
+        holders,
         mply,
         numMoves,
         0, // lastNumMoves
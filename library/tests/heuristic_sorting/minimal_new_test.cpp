@@ -30,7 +30,7 @@ TEST(MinimalNewTest, TestWeightAllocTrump0) {
     
     moveType bestMove = {0, 14, 1, 0};
     moveType bestMoveTT = {0, 13, 1, 0};
-    relRanksType thrp_rel = {};
+    cardHoldersType holders = {};
     
     trackType track = {};
     track.leadHand = 0;
@@ -40,7 +40,7 @@ TEST(MinimalNewTest, TestWeightAllocTrump0) {
         tpos,           // pos
         bestMove,       // bestMove  
         bestMoveTT,     // bestMoveTT
-        &thrp_rel,      // thrp_rel
+        holders,        // holders
         moves,          // mply
         3,              // numMoves
         0,              // lastNumMoves
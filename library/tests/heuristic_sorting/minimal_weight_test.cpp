@@ -38,7 +38,7 @@ TEST_F(MinimalWeightTest, BasicWeightAllocCall) {
     // Create other required structures
     moveType bestMove = {0, 14, 1, 0};
     moveType bestMoveTT = {0, 13, 1, 0};
-    relRanksType thrp_rel[4] = {};
+    cardHoldersType holders = {};
     
     std::cout << "Creating HeuristicContext..." << std::endl;
     
@@ -47,7 +47,7 @@ TEST_F(MinimalWeightTest, BasicWeightAllocCall) {
         tpos,          // const pos& tpos
         bestMove,      // const moveType& bestMove  
         bestMoveTT,    // const moveType& bestMoveTT
-        thrp_rel,      // const relRanksType* thrp_rel
+        holders,       // const cardHoldersType& holders
         moves,         // moveType* mply
         3,             // numMoves
         0,             // lastNumMoves
@@ -16,7 +16,7 @@ TEST(TargetedUnitTests, RankForcesAceBasic) {
   // Build a safe HeuristicContext using local objects
   moveType bm = {};
   moveType bmtt = {};
-  relRanksType thrp_rel_dummy[1] = {};
+  cardHoldersType holders_dummy = {};
   moveType mply_dummy[1] = {};
   trackType track_dummy = {};
 
@@ -24,7 +24,7 @@ TEST(TargetedUnitTests, RankForcesAceBasic) {
     tpos,                   // pos
     bm,                     // bestMove
     bmtt,                   // bestMoveTT
-    thrp_rel_dummy,         // thrp_rel
+    holders_dummy,          // holders
     mply_dummy,             // mply
     0,                      // numMoves
     0,                      // lastNumMoves
@@ -60,10 +60,10 @@ TEST(TargetedUnitTests, GetTopNumberEdgeCases) {
   // Build a small HeuristicContext for GetTopNumber
   moveType bm = {};
   moveType bmtt = {};
-  relRanksType thrp_rel_dummy[1] = {};
+  cardHoldersType holders_dummy = {};
   moveType mply_dummy[1] = {};
   trackType track_dummy = {};
-  HeuristicContext ctx = { tpos, bm, bmtt, thrp_rel_dummy, mply_dummy, 0, 0, DDS_NOTRUMP, 0, &track_dummy, 0, 0, 0, 0 };
+  HeuristicContext ctx = { tpos, bm, bmtt, holders_dummy, mply_dummy, 0, 0, DDS_NOTRUMP, 0, &track_dummy, 0, 0, 0, 0 };
 
   // Call the free helper GetTopNumber from internal.hpp
   GetTopNumber(ctx, 0, 14, topNumber, mno);
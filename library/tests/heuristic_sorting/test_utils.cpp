@@ -45,8 +45,8 @@ std::string normalize_ordering(const moveType* moves, int numMoves, bool include
   return out.str();
 }
 
-// Initialize relRanks table and trackType based on a given pos (used by fuzz tests)
-void init_rel_and_track(const pos& tpos, relRanksType* relTable /* size 8192 assumed */, trackType* trackp,
+// Initialize card holders and trackType based on a given pos (used by fuzz tests)
+void init_holders_and_track(const pos& tpos, cardHoldersType* holders, trackType* trackp,
     int cardsPlayed, const moveType* playedMoves, int leadHand, int trump) {
   // zero track and set sane defaults
   if (trackp) {
@@ -75,7 +75,7 @@ void init_rel_and_track(const pos& tpos, relRanksType* relTable /* size 8192 ass
     trackp->trickData.nextLeadHand = leadHand;
   }
 
-  if (!relTable) return;
+  if (!holders) return;
 
   // Work on a mutable copy of pos so we can simulate cards removed by plays
   pos localPos = tpos;
@@ -119,14 +119,6 @@ void init_rel_and_track(const pos& tpos, relRanksType* relTable /* size 8192 ass
     }
   }
 
-  // Initialize relTable[0]
-  for (int s = 0; s < DDS_SUITS; s++) {
-    for (int ord = 1; ord <= 13; ord++) {
-      relTable[0].absRank[ord][s].hand = -1;
-      relTable[0].absRank[ord][s].rank = 0;
-    }
-  }
-
   // Build handLookup from current deal (use localPos which may have had cards removed)
   int handLookup[DDS_SUITS][15];
   for (int s = 0; s < DDS_SUITS; s++) {
@@ -141,28 +133,11 @@ void init_rel_and_track(const pos& tpos, relRanksType* relTable /* size 8192 ass
     }
   }
 
-  unsigned int topBitRank = 1;
-  unsigned int topBitNo = 2;
-  for (unsigned int aggr = 1; aggr < 8192; aggr++) {
-    if (aggr >= (topBitRank << 1)) {
-      topBitRank <<= 1;
-      topBitNo++;
-    }
-
-    relTable[aggr] = relTable[aggr ^ topBitRank];
-    relRanksType * relp = &relTable[aggr];
-
-  int weight = count_table[aggr];
-    for (int c = weight; c >= 2; c--) {
-      for (int s = 0; s < DDS_SUITS; s++) {
-        relp->absRank[c][s].hand = relp->absRank[c - 1][s].hand;
-        relp->absRank[c][s].rank = relp->absRank[c - 1][s].rank;
-      }
-    }
-    for (int s = 0; s < DDS_SUITS; s++) {
-      relp->absRank[1][s].hand = static_cast<signed char>(handLookup[s][topBitNo]);
-      relp->absRank[1][s].rank = static_cast<char>(topBitNo);
-    }
+  for (int s = 0; s < DDS_SUITS; s++) {
+    holders->hand[s][0] = -1;
+    holders->hand[s][1] = -1;
+    for (int r = 2; r <= 14; r++)
+      holders->hand[s][r] = static_cast<signed char>(handLookup[s][r]);
   }
 
   // If requested, simulate cards already played in the current trick.
@@ -7,14 +7,14 @@
 
 std::string normalize_ordering(const moveType* moves, int numMoves, bool include_scores = false);
 
-// Initialize relRanks table and trackType based on a given pos (used by fuzz tests)
+// Initialize card holders and trackType based on a given pos (used by fuzz tests)
 // Optional: simulate a mid-trick state by providing the number of cards already
 // played (0..4) and the array of played moves in play order (first to last).
 // leadHand is the absolute hand that led the trick (0..3). trump may be
 // provided to let the helper decide current winning card when trumps exist.
-void init_rel_and_track(
+void init_holders_and_track(
 	const pos& tpos,
-	relRanksType* relTable /* size 8192 assumed */,
+	cardHoldersType* holders,
 	trackType* trackp,
 	int cardsPlayed = 0,
 	const moveType* playedMoves = nullptr,
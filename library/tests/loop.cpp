@@ -11,12 +11,17 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 
 #include "loop.hpp"
 #include "TestTimer.hpp"
 #include "compare.hpp"
 #include "print.hpp"
 #include "moves/Moves.hpp"
+#include "PBN.hpp"
+#include <api/SolveStream.hpp>
 
 using namespace std;
 
@@ -67,6 +72,7 @@ void loop_solve(
 
     for (int j = 0; j < count; j++)
     {
+      timer.addunits(solvedbdp->solvedBoard[j].nodes);
       if (compare_FUT(solvedbdp->solvedBoard[j], fut_list[i + j]))
         continue;
 
@@ -86,6 +92,246 @@ void loop_solve(
 }
 
 
+static void print_latency(
+  const string& title,
+  vector<long>& latency)
+{
+  if (latency.empty())
+    return;
+
+  long sum = 0;
+  for (auto l: latency)
+    sum += l;
+  sort(latency.begin(), latency.end());
+
+  auto pct = [&latency](const unsigned p) -> long
+  {
+    const unsigned n = static_cast<unsigned>(latency.size());
+    return latency[min(n-1, (n * p) / 100)];
+  };
+
+  const long number = static_cast<long>(latency.size());
+  cout << title << "\n";
+  cout << setw(8) << left << "mean" << setw(12) << right <<
+    sum / number << "\n";
+  cout << setw(8) << left << "p50" << setw(12) << right << pct(50) << "\n";
+  cout << setw(8) << left << "p90" << setw(12) << right << pct(90) << "\n";
+  cout << setw(8) << left << "p99" << setw(12) << right << pct(99) << "\n";
+  cout << setw(8) << left << "max" << setw(12) << right <<
+    latency.back() << "\n\n";
+}
+
+
+void loop_single(
+  dealPBN * deal_list,
+  futureTricks * fut_list,
+  const int number,
+  const bool parallel)
+{
+  // One SolveBoardPBN call per hand, always on thread 0, as a caller
+  // with its own worker threads would do. Consecutive calls on the same
+  // thread reuse its solver context, so this measures warm latency.
+  // With parallel, each hand is split over all threads instead.
+
+  vector<long> latency(static_cast<unsigned>(number));
+  futureTricks fut;
+
+  timer.start(number);
+  for (int i = 0; i < number; i++)
+  {
+    const auto t0 = chrono::steady_clock::now();
+    int ret;
+    if ((ret = (parallel ?
+          SolveBoardPBNParallel(deal_list[i], -1, 3, 1, &fut) :
+          SolveBoardPBN(deal_list[i], -1, 3, 1, &fut, 0)))
+        != RETURN_NO_FAULT)
+    {
+      cout << "loop_single: i " << i << ", return " << ret << "\n";
+      exit(0);
+    }
+    const auto t1 = chrono::steady_clock::now();
+    latency[static_cast<unsigned>(i)] = static_cast<long>(
+      chrono::duration_cast<chrono::microseconds>(t1 - t0).count());
+
+    timer.addunits(fut.nodes);
+    if (compare_FUT(fut, fut_list[i]))
+      continue;
+
+    cout << "loop_single: i " << i << ": " << "Difference\n\n";
+    print_FUT(fut);
+    cout << "\n";
+    print_FUT(fut_list[i]);
+    cout << "\n";
+  }
+  timer.end();
+
+  print_latency("Per-call latency (us)", latency);
+}
+
+
+void loop_table(
+  dealPBN * deal_list,
+  ddTableResults * table_list,
+  const int number,
+  const bool parallel)
+{
+  // One CalcDDtablePBN call per hand, so the latency of a single table
+  // can be compared between the batch and the parallel version and
+  // across thread counts (-n).
+
+  vector<long> latency(static_cast<unsigned>(number));
+  ddTableDealPBN tableDeal;
+  ddTableResults table;
+
+  timer.start(number);
+  for (int i = 0; i < number; i++)
+  {
+    strcpy(tableDeal.cards, deal_list[i].remainCards);
+
+    const auto t0 = chrono::steady_clock::now();
+    int ret;
+    if ((ret = (parallel ?
+          CalcDDtablePBNParallel(tableDeal, &table) :
+          CalcDDtablePBN(tableDeal, &table)))
+        != RETURN_NO_FAULT)
+    {
+      cout << "loop_table: i " << i << ", return " << ret << "\n";
+      exit(0);
+    }
+    const auto t1 = chrono::steady_clock::now();
+    latency[static_cast<unsigned>(i)] = static_cast<long>(
+      chrono::duration_cast<chrono::microseconds>(t1 - t0).count());
+
+    if (compare_TABLE(table, table_list[i]))
+      continue;
+
+    cout << "loop_table: i " << i << ": " << "Difference\n\n";
+    print_TABLE(table);
+    cout << "\n";
+    print_TABLE(table_list[i]);
+    cout << "\n";
+  }
+  timer.end();
+
+  print_latency("Per-table latency (us)", latency);
+}
+
+
+void loop_trace(
+  dealPBN * deal_list,
+  playTracePBN * play_list,
+  solvedPlay * trace_list,
+  const int number)
+{
+  // One AnalysePlayPBNParallel call per hand, so the latency of a
+  // single trace can be compared across thread counts (-n).
+
+  vector<long> latency(static_cast<unsigned>(number));
+  solvedPlay solved;
+
+  timer.start(number);
+  for (int i = 0; i < number; i++)
+  {
+    const auto t0 = chrono::steady_clock::now();
+    int ret;
+    if ((ret = AnalysePlayPBNParallel(deal_list[i], play_list[i], &solved))
+        != RETURN_NO_FAULT)
+    {
+      cout << "loop_trace: i " << i << ", return " << ret << "\n";
+      exit(0);
+    }
+    const auto t1 = chrono::steady_clock::now();
+    latency[static_cast<unsigned>(i)] = static_cast<long>(
+      chrono::duration_cast<chrono::microseconds>(t1 - t0).count());
+
+    timer.addunits(solved.number);
+    if (compare_TRACE(solved, trace_list[i]))
+      continue;
+
+    cout << "loop_trace: i " << i << ": " << "Difference\n\n";
+    print_double_TRACE(solved, trace_list[i]);
+    cout << "\n";
+  }
+  timer.end();
+
+  print_latency("Per-trace latency (us)", latency);
+}
+
+
+void loop_stream(
+  dealPBN * deal_list,
+  futureTricks * fut_list,
+  const int number,
+  const int window)
+{
+  // All hands go through a single SolveBoardStream call, so there is
+  // no barrier between batches and no limit on the number of hands.
+
+  vector<deal> dl(static_cast<unsigned>(number));
+  for (int i = 0; i < number; i++)
+  {
+    deal& d = dl[static_cast<unsigned>(i)];
+    if (ConvertFromPBN(deal_list[i].remainCards, d.remainCards) != 1)
+    {
+      cout << "loop_stream: i " << i << ", PBN fault\n";
+      exit(0);
+    }
+    d.first = deal_list[i].first;
+    d.trump = deal_list[i].trump;
+    for (int k = 0; k <= 2; k++)
+    {
+      d.currentTrickSuit[k] = deal_list[i].currentTrickSuit[k];
+      d.currentTrickRank[k] = deal_list[i].currentTrickRank[k];
+    }
+  }
+
+  int produced = 0;
+  auto next = [&](streamBoard& bd) -> bool
+  {
+    if (produced == number)
+      return false;
+    bd.dl = dl[static_cast<unsigned>(produced++)];
+    bd.target = -1;
+    bd.solutions = 3;
+    bd.mode = 1;
+    return true;
+  };
+
+  int received = 0;
+  auto done = [&](int i, int status, const futureTricks& fut)
+  {
+    received++;
+    if (status != RETURN_NO_FAULT)
+    {
+      cout << "loop_stream: i " << i << ", return " << status << "\n";
+      return;
+    }
+
+    if (compare_FUT(fut, fut_list[i]))
+      return;
+
+    cout << "loop_stream: i " << i << ": " << "Difference\n\n";
+    print_FUT(fut);
+    cout << "\n";
+    print_FUT(fut_list[i]);
+    cout << "\n";
+  };
+
+  timer.start(number);
+  int ret;
+  if ((ret = SolveBoardStream(next, done, window)) != RETURN_NO_FAULT)
+  {
+    cout << "loop_stream: return " << ret << "\n";
+    exit(0);
+  }
+  timer.end();
+
+  if (received != number)
+    cout << "loop_stream: " << received << " results for " <<
+      number << " hands\n";
+}
+
+
 bool loop_calc(
   ddTableDealsPBN * dealsp,
   ddTablesRes * resp,
@@ -101,6 +347,7 @@ bool loop_calc(
 #endif
 
   int filter[5] = {0, 0, 0, 0, 0};
+  chrono::steady_clock::duration elapsed{0};
 
   for (int i = 0; i < number; i += stepsize)
   {
@@ -110,6 +357,7 @@ bool loop_calc(
       strcpy(dealsp->deals[j].cards, deal_list[i+j].remainCards);
 
     timer.start(count);
+    const auto t0 = chrono::steady_clock::now();
     int ret;
     if ((ret = CalcAllTablesPBN(dealsp, -1, filter, resp, parp))
         != RETURN_NO_FAULT)
@@ -117,6 +365,7 @@ bool loop_calc(
       cout << "loop_calc: i " << i << ", return " << ret << "\n";
       exit(0);
     }
+    elapsed += chrono::steady_clock::now() - t0;
     timer.end();
 
 #ifdef BATCHTIMES
@@ -141,6 +390,14 @@ bool loop_calc(
   cout << "\n";
 #endif
 
+  // Wall-clock throughput over all batches (par calculation included,
+  // as it is part of CalcAllTablesPBN).
+  const double secs = chrono::duration<double>(elapsed).count();
+  if (secs > 0.)
+    cout << setw(21) << left << "Tables/second" << setw(12) << right <<
+      fixed << setprecision(2) << number / secs << "\n\n" <<
+      defaultfloat;
+
   return true;
 }
 
@@ -282,6 +539,7 @@ bool loop_play(
 
     for (int j = 0; j < count; j++)
     {
+      timer.addunits(solvedplp->solved[j].number);
       if (compare_TRACE(solvedplp->solved[j], trace_list[i+j]))
         continue;
 
@@ -21,6 +21,24 @@ void loop_solve(
   const int number,
   const int stepsize);
 
+void loop_single(
+  dealPBN * deal_list,
+  futureTricks * fut_list,
+  const int number,
+  const bool parallel);
+
+void loop_table(
+  dealPBN * deal_list,
+  ddTableResults * table_list,
+  const int number,
+  const bool parallel);
+
+void loop_stream(
+  dealPBN * deal_list,
+  futureTricks * fut_list,
+  const int number,
+  const int window);
+
 bool loop_calc(
   ddTableDealsPBN * dealsp,
   ddTablesRes * resp,
@@ -45,6 +63,12 @@ bool loop_dealerpar(
   const int number,
   const int stepsize);
 
+void loop_trace(
+  dealPBN * deal_list,
+  playTracePBN * play_list,
+  solvedPlay * trace_list,
+  const int number);
+
 bool loop_play(
   boardsPBN * bop,
   playTracesPBN * playsp,
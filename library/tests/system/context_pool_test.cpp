@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <solver_context/ContextPool.hpp>
+#include <trans_table/TransTable.hpp>
+
+extern ContextPool contextPool;
+
+namespace {
+
+deal MakeDeal()
+{
+  // Same position as the trick-three regression test.
+  deal dl = {};
+  dl.trump = 4;
+  dl.first = 2;
+  dl.currentTrickRank[0] = 5;
+  dl.currentTrickRank[1] = 13;
+  const unsigned cards[DDS_HANDS][DDS_SUITS] =
+  {
+    {512, 4096, 12320, 27184},
+    {256, 2576, 16792, 5120},
+    {3076, 17408, 580, 264},
+    {192, 324, 3072, 196}
+  };
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      dl.remainCards[h][s] = cards[h][s];
+  return dl;
+}
+
+}
+
+TEST(ContextPoolTest, SizedBySetMaxThreads)
+{
+  SetMaxThreads(1);
+  EXPECT_GE(contextPool.NumThreads(), 1u);
+
+  futureTricks fut;
+  const int beyond = static_cast<int>(contextPool.NumThreads());
+  EXPECT_EQ(RETURN_THREAD_INDEX,
+    SolveBoard(MakeDeal(), -1, 1, 1, &fut, beyond));
+  EXPECT_EQ(RETURN_THREAD_INDEX,
+    SolveBoard(MakeDeal(), -1, 1, 1, &fut, -1));
+}
+
+TEST(ContextPoolTest, ThreadKeepsItsContextBetweenCalls)
+{
+  SetMaxThreads(1);
+  ASSERT_GE(contextPool.NumThreads(), 1u);
+
+  SolverContext& ctx = contextPool.Get(0);
+  auto thr = ctx.thread();
+
+  futureTricks fut1, fut2;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(MakeDeal(), -1, 3, 1, &fut1, 0));
+  TransTable* tt = ctx.maybeTransTable();
+  ASSERT_NE(nullptr, tt);
+
+  // The second call on the same thread runs in the same context and
+  // on the same transposition table.
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(MakeDeal(), -1, 3, 1, &fut2, 0));
+  EXPECT_EQ(&ctx, &contextPool.Get(0));
+  EXPECT_EQ(thr, contextPool.Get(0).thread());
+  EXPECT_EQ(tt, contextPool.Get(0).maybeTransTable());
+
+  ASSERT_EQ(fut1.cards, fut2.cards);
+  for (int i = 0; i < fut1.cards; i++)
+  {
+    EXPECT_EQ(fut1.suit[i], fut2.suit[i]);
+    EXPECT_EQ(fut1.rank[i], fut2.rank[i]);
+    EXPECT_EQ(fut1.score[i], fut2.score[i]);
+  }
+}
+
+TEST(ContextPoolTest, FreeMemoryKeepsContexts)
+{
+  SetMaxThreads(1);
+  ASSERT_GE(contextPool.NumThreads(), 1u);
+
+  futureTricks fut;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(MakeDeal(), -1, 1, 1, &fut, 0));
+  const int score = fut.score[0];
+
+  FreeMemory();
+  EXPECT_GE(contextPool.NumThreads(), 1u);
+
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(MakeDeal(), -1, 1, 1, &fut, 0));
+  EXPECT_EQ(score, fut.score[0]);
+}
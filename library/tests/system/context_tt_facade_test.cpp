@@ -98,3 +98,17 @@ TEST(SystemContextTTFacades, Lifecycle_LookupAddClearDispose)
   ctx.DisposeTransTable();
   EXPECT_EQ(nullptr, ctx.maybeTransTable());
 }
+
+TEST(SystemContextTTFacades, SearchViewPointsIntoTheContext)
+{
+  SolverContext ctx;
+  const long owners = ctx.thread().use_count();
+
+  // The view creates the TT on demand and shares ownership with nothing.
+  const SearchView sv = ctx.searchView();
+  ASSERT_NE(nullptr, ctx.maybeTransTable());
+  EXPECT_EQ(ctx.maybeTransTable(), sv.transTable());
+  EXPECT_EQ(ctx.thread().get(), sv.thread());
+  EXPECT_EQ(&ctx.thread()->moves, &sv.moves());
+  EXPECT_EQ(owners, ctx.thread().use_count());
+}
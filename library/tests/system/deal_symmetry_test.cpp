@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <system/DealSymmetry.hpp>
+#include <system/Scheduler.hpp>
+#include "CalcTables.hpp"
+
+#include <random>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+// Hand h goes to hand h + rot, and suit s to suit perm[s].
+deal Transform(const deal& dl, const int rot, const int perm[DDS_SUITS])
+{
+  deal out = dl;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      out.remainCards[(h + rot) % DDS_HANDS][perm[s]] = dl.remainCards[h][s];
+  if (dl.trump < DDS_SUITS)
+    out.trump = perm[dl.trump];
+  out.first = (dl.first + rot) % DDS_HANDS;
+  return out;
+}
+
+}
+
+TEST(DealSymmetryTest, RotatedAndRelabelledDealsShareACanonicalForm)
+{
+  std::mt19937 rng(21);
+  const int perm[DDS_SUITS] = {2, 0, 3, 1};
+
+  for (int trump = 0; trump < DDS_STRAINS; trump++)
+  {
+    const deal dl = RandomDeal(rng, trump);
+
+    deal c1, c2;
+    dealSymmetry s1, s2;
+    CanonicalDeal(dl, c1, s1);
+
+    for (int rot = 0; rot < DDS_HANDS; rot++)
+    {
+      CanonicalDeal(Transform(dl, rot, perm), c2, s2);
+      EXPECT_TRUE(SameCardsAndStrain(c1, c2));
+      EXPECT_EQ(c1.first, c2.first);
+    }
+
+    // Mapping the original with sym gives the canonical deal.
+    EXPECT_TRUE(SameCardsAndStrain(c1, Transform(dl, s1.rotation, s1.suit)));
+    EXPECT_EQ(trump == DDS_SUITS ? DDS_SUITS : 0, c1.trump);
+  }
+}
+
+TEST(DealSymmetryTest, DifferentStrainsStayApart)
+{
+  std::mt19937 rng(23);
+  deal dl = RandomDeal(rng, 0);
+
+  deal c1, c2;
+  dealSymmetry sym;
+  CanonicalDeal(dl, c1, sym);
+
+  // Spades and hearts exchanged, but spades stay trumps.
+  const int perm[DDS_SUITS] = {1, 0, 2, 3};
+  deal other = Transform(dl, 0, perm);
+  other.trump = 0;
+  CanonicalDeal(other, c2, sym);
+  EXPECT_FALSE(SameCardsAndStrain(c1, c2));
+}
+
+TEST(DealSymmetryTest, TrickInProgressIsLeftAlone)
+{
+  std::mt19937 rng(25);
+  deal dl = RandomDeal(rng, 4);
+  dl.currentTrickSuit[0] = 1;
+  dl.currentTrickRank[0] = 14;
+
+  deal canon;
+  dealSymmetry sym;
+  CanonicalDeal(dl, canon, sym);
+
+  EXPECT_EQ(0, sym.rotation);
+  for (int s = 0; s < DDS_SUITS; s++)
+    EXPECT_EQ(s, sym.suit[s]);
+  EXPECT_TRUE(SameCardsAndStrain(dl, canon));
+}
+
+TEST(DealSymmetryTest, RotatedTableComesFromTheCache)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  FreeMemory();
+
+  std::mt19937 rng(27);
+  const deal dl = RandomDeal(rng, 4);
+  const int perm[DDS_SUITS] = {3, 2, 0, 1};
+  const int rot = 1;
+  const deal moved = Transform(dl, rot, perm);
+
+  ddTableDeal t1, t2;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+    {
+      t1.cards[h][s] = dl.remainCards[h][s];
+      t2.cards[h][s] = moved.remainCards[h][s];
+    }
+
+  ddTableResults r1, r2;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(t1, &r1));
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(t2, &r2));
+
+  resultCacheStats st, tst;
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(DDS_STRAINS, tst.hits);
+
+  for (int h = 0; h < DDS_HANDS; h++)
+  {
+    const int h2 = (h + rot) % DDS_HANDS;
+    for (int s = 0; s < DDS_SUITS; s++)
+      EXPECT_EQ(r1.resTable[s][h], r2.resTable[perm[s]][h2]);
+    EXPECT_EQ(r1.resTable[DDS_SUITS][h], r2.resTable[DDS_SUITS][h2]);
+  }
+
+  FreeMemory();
+  SetResultCacheSize(0);
+}
+
+TEST(DealSymmetryTest, DetectCalcDuplicatesFindsRotations)
+{
+  std::mt19937 rng(29);
+  static boards bds;
+
+  const deal dl = RandomDeal(rng, 2);
+  const int perm[DDS_SUITS] = {0, 3, 2, 1};
+
+  bds.noOfBoards = 4;
+  bds.deals[0] = dl;
+  bds.deals[1] = Transform(dl, 3, perm);
+  bds.deals[2] = dl;
+  bds.deals[2].trump = 4;
+  bds.deals[3] = Transform(bds.deals[2], 2, perm);
+  for (int i = 0; i < bds.noOfBoards; i++)
+  {
+    bds.target[i] = -1;
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+  }
+
+  std::vector<int> uniques, crossrefs;
+  DetectCalcDuplicates(bds, uniques, crossrefs);
+
+  EXPECT_EQ((std::vector<int>{0, 2}), uniques);
+  EXPECT_EQ((std::vector<int>{-1, 0, -1, 2}), crossrefs);
+}
+
+TEST(DealSymmetryTest, SchedulerGroupsRotatedTables)
+{
+  std::mt19937 rng(31);
+  static boards bds;
+
+  const deal dl = RandomDeal(rng, 1);
+  const int perm[DDS_SUITS] = {3, 2, 1, 0};
+
+  bds.noOfBoards = 3;
+  bds.deals[0] = dl;
+  bds.deals[1] = Transform(dl, 1, perm);
+  bds.deals[2] = RandomDeal(rng, 1);
+  for (int i = 0; i < bds.noOfBoards; i++)
+  {
+    bds.target[i] = -1;
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+  }
+
+  // Only calc runs, which solve all four declarers, group them.
+  Scheduler sched;
+  sched.RegisterThreads(1);
+  sched.RegisterRun(DDS_RUN_SOLVE, bds);
+  int repeats = 0;
+  for (schedType st = sched.GetNumber(0); st.number != -1;
+      st = sched.GetNumber(0))
+    repeats += (st.repeatOf == -1 ? 0 : 1);
+  EXPECT_EQ(0, repeats);
+
+  sched.RegisterRun(DDS_RUN_CALC, bds);
+  std::vector<int> repeatOf(3, -2);
+  for (schedType st = sched.GetNumber(0); st.number != -1;
+      st = sched.GetNumber(0))
+    repeatOf[static_cast<unsigned>(st.number)] = st.repeatOf;
+
+  EXPECT_EQ(-1, repeatOf[2]);
+  EXPECT_TRUE((repeatOf[0] == -1 && repeatOf[1] == 0) ||
+    (repeatOf[0] == 1 && repeatOf[1] == -1));
+  // Hand h of deal 0 is hand h + 1 of deal 1, and both map onto the
+  // same canonical hand.
+  EXPECT_EQ(DDS_HANDS - 1,
+    (sched.Rotation(1) - sched.Rotation(0) + DDS_HANDS) % DDS_HANDS);
+}
+
+TEST(DealSymmetryTest, RotatedTablesInABatchMatch)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(37);
+
+  const deal dl = RandomDeal(rng, 4);
+  const int perm[DDS_SUITS] = {1, 3, 0, 2};
+  const int rot = 3;
+  const deal moved = Transform(dl, rot, perm);
+
+  ddTableDeals deals;
+  deals.noOfTables = 2;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+    {
+      deals.deals[0].cards[h][s] = dl.remainCards[h][s];
+      deals.deals[1].cards[h][s] = moved.remainCards[h][s];
+    }
+
+  // The second table is copied from the first within the batch.
+  int filter[DDS_STRAINS] = {0, 0, 0, 0, 0};
+  ddTablesRes res;
+  allParResults pres;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcAllTables(&deals, -1, filter, &res, &pres));
+
+  const ddTableResults& r1 = res.results[0];
+  const ddTableResults& r2 = res.results[1];
+  for (int h = 0; h < DDS_HANDS; h++)
+  {
+    const int h2 = (h + rot) % DDS_HANDS;
+    for (int s = 0; s < DDS_SUITS; s++)
+      EXPECT_EQ(r1.resTable[s][h], r2.resTable[perm[s]][h2]);
+    EXPECT_EQ(r1.resTable[DDS_SUITS][h], r2.resTable[DDS_SUITS][h2]);
+  }
+
+  ddTableResults single;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(deals.deals[1], &single));
+  for (int s = 0; s < DDS_STRAINS; s++)
+    for (int h = 0; h < DDS_HANDS; h++)
+      EXPECT_EQ(single.resTable[s][h], r2.resTable[s][h]);
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/PlaySession.hpp>
+
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+// Chooses a card for the hand to play in dl, which may have a trick
+// in progress.
+using CardChooser = std::function<void(const deal& dl, int& suit, int& rank)>;
+
+// Plays out the whole hand. Also returns the tricks won by declarer,
+// the side that is not on lead at the start.
+playTraceBin PlayOut(
+  const deal& start,
+  const CardChooser& choose,
+  int& declarerTricks)
+{
+  playTraceBin play = {};
+  deal dl = start;
+  int winner = 0, winSuit = 0, winRank = 0;
+  declarerTricks = 0;
+
+  for (int n = 0; n < 52; n++)
+  {
+    const int inTrick = n % 4;
+    const int hand = (dl.first + inTrick) % 4;
+
+    int suit, rank;
+    choose(dl, suit, rank);
+    play.suit[n] = suit;
+    play.rank[n] = rank;
+    play.number++;
+
+    dl.remainCards[hand][suit] &= ~(1u << rank);
+
+    if (inTrick == 0 ||
+        (suit == winSuit && rank > winRank) ||
+        (suit == dl.trump && winSuit != dl.trump))
+    {
+      winner = hand;
+      winSuit = suit;
+      winRank = rank;
+    }
+
+    if (inTrick < 3)
+    {
+      dl.currentTrickSuit[inTrick] = suit;
+      dl.currentTrickRank[inTrick] = rank;
+    }
+    else
+    {
+      if (winner % 2 != start.first % 2)
+        declarerTricks++;
+      dl.first = winner;
+      for (int i = 0; i < 3; i++)
+      {
+        dl.currentTrickSuit[i] = 0;
+        dl.currentTrickRank[i] = 0;
+      }
+    }
+  }
+  return play;
+}
+
+// The double dummy best card.
+void BestCard(const deal& dl, int& suit, int& rank)
+{
+  futureTricks fut;
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1, &fut, 0));
+  suit = fut.suit[0];
+  rank = fut.rank[0];
+}
+
+// Any card that follows suit.
+CardChooser RandomCard(std::mt19937& rng)
+{
+  return [&rng](const deal& dl, int& suit, int& rank)
+  {
+    int inTrick = 0;
+    while (inTrick < 3 && dl.currentTrickRank[inTrick] != 0)
+      inTrick++;
+    const int hand = (dl.first + inTrick) % 4;
+
+    std::vector<std::pair<int, int>> legal;
+    for (int s = 0; s < DDS_SUITS; s++)
+    {
+      if (inTrick > 0 && s != dl.currentTrickSuit[0] &&
+          dl.remainCards[hand][dl.currentTrickSuit[0]] != 0)
+        continue;
+      for (int r = 2; r <= 14; r++)
+        if (dl.remainCards[hand][s] & (1u << r))
+          legal.push_back({s, r});
+    }
+    const auto& c = legal[rng() % legal.size()];
+    suit = c.first;
+    rank = c.second;
+  };
+}
+
+// The tricks that a card gives away, from a solve of the position
+// before it with all cards scored.
+int ExpectedCost(const deal& dl, const int suit, const int rank)
+{
+  futureTricks fut;
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 3, 1, &fut, 0));
+  for (int k = 0; k < fut.cards; k++)
+  {
+    if (fut.suit[k] == suit &&
+        (fut.rank[k] == rank || (fut.equals[k] & (1 << rank))))
+      return fut.score[0] - fut.score[k];
+  }
+  ADD_FAILURE() << "card " << suit << "/" << rank << " not scored";
+  return -1;
+}
+
+}
+
+TEST(PlayAnalysisTest, OptimalPlayKeepsTheTrickCount)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(101);
+
+  for (int trump = 0; trump < DDS_STRAINS; trump += 4)
+  {
+    const deal dl = RandomDeal(rng, trump);
+    int declarerTricks;
+    const playTraceBin play = PlayOut(dl, BestCard, declarerTricks);
+
+    solvedPlay solved;
+    ASSERT_EQ(RETURN_NO_FAULT, AnalysePlayBin(dl, play, &solved, 0));
+    // The initial solve and every card but the last trick.
+    ASSERT_EQ(49, solved.number);
+    for (int n = 1; n < solved.number; n++)
+      EXPECT_EQ(solved.tricks[0], solved.tricks[n])
+        << "strain " << trump << ", card " << n;
+    EXPECT_EQ(declarerTricks, solved.tricks[0]);
+  }
+}
+
+TEST(PlaySessionTest, MatchesAnalysePlayBinCardByCard)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(202);
+
+  for (int trump = 1; trump < DDS_STRAINS; trump += 3)
+  {
+    const deal dl = RandomDeal(rng, trump);
+    int declarerTricks;
+    std::vector<deal> positions;
+    const CardChooser random = RandomCard(rng);
+    const playTraceBin play = PlayOut(dl,
+      [&](const deal& pos, int& suit, int& rank)
+      {
+        positions.push_back(pos);
+        random(pos, suit, rank);
+      }, declarerTricks);
+
+    solvedPlay solved;
+    ASSERT_EQ(RETURN_NO_FAULT, AnalysePlayBin(dl, play, &solved, 0));
+
+    PlaySession session;
+    ASSERT_EQ(RETURN_NO_FAULT, session.Start(dl));
+    EXPECT_EQ(solved.tricks[0], session.Tricks());
+    EXPECT_EQ(dl.first, session.NextHand());
+
+    for (int n = 0; n < play.number; n++)
+    {
+      playCardResult res;
+      ASSERT_EQ(RETURN_NO_FAULT,
+        session.Play(play.suit[n], play.rank[n], &res)) << "card " << n;
+      EXPECT_EQ(ExpectedCost(positions[n], play.suit[n], play.rank[n]),
+        res.cost) << "card " << n;
+      if (n + 1 < solved.number)
+      {
+        EXPECT_EQ(solved.tricks[n + 1], res.tricks) << "card " << n;
+      }
+      EXPECT_EQ(res.next, session.NextHand());
+    }
+
+    EXPECT_TRUE(session.Done());
+    EXPECT_EQ(52, session.CardsPlayed());
+    EXPECT_EQ(declarerTricks, session.Tricks());
+  }
+}
+
+TEST(PlaySessionTest, RejectsCardsThatCannotBePlayed)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(303);
+  const deal dl = RandomDeal(rng, 4);
+
+  PlaySession session;
+  EXPECT_EQ(RETURN_PLAY_FAULT, session.Play(0, 14));
+  ASSERT_EQ(RETURN_NO_FAULT, session.Start(dl));
+
+  // A card that North does not hold.
+  int suit = 0, rank = 2;
+  while (dl.remainCards[0][suit] & (1u << rank))
+    if (++rank > 14) { rank = 2; suit++; }
+  EXPECT_EQ(RETURN_PLAY_FAULT, session.Play(suit, rank));
+  EXPECT_EQ(0, session.CardsPlayed());
+  EXPECT_EQ(0, session.NextHand());
+
+  // North leads a suit that East holds, and East discards instead.
+  int lead;
+  for (lead = 0; lead < DDS_SUITS; lead++)
+    if (dl.remainCards[0][lead] && dl.remainCards[1][lead] &&
+        dl.remainCards[1][(lead + 1) % 4])
+      break;
+  ASSERT_LT(lead, DDS_SUITS);
+  int leadRank = 2;
+  while ((dl.remainCards[0][lead] & (1u << leadRank)) == 0)
+    leadRank++;
+  ASSERT_EQ(RETURN_NO_FAULT, session.Play(lead, leadRank));
+
+  const int other = (lead + 1) % 4;
+  int otherRank = 2;
+  while ((dl.remainCards[1][other] & (1u << otherRank)) == 0)
+    otherRank++;
+  const int tricks = session.Tricks();
+  EXPECT_EQ(RETURN_PLAY_FAULT, session.Play(other, otherRank));
+  EXPECT_EQ(1, session.CardsPlayed());
+  EXPECT_EQ(1, session.NextHand());
+  EXPECT_EQ(tricks, session.Tricks());
+}
+
+TEST(PlayAnalysisTest, ParallelMatchesSequential)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(404);
+
+  for (int trump = 0; trump < DDS_STRAINS; trump += 2)
+  {
+    deal dl = RandomDeal(rng, trump);
+    int declarerTricks;
+    playTraceBin play = PlayOut(dl, RandomCard(rng), declarerTricks);
+
+    // Also a deal with a trick in progress and a short trace.
+    if (trump == 2)
+    {
+      for (int c = 0; c < 2; c++)
+      {
+        const int hand = (dl.first + c) % 4;
+        dl.currentTrickSuit[c] = play.suit[c];
+        dl.currentTrickRank[c] = play.rank[c];
+        dl.remainCards[hand][play.suit[c]] &= ~(1u << play.rank[c]);
+      }
+      for (int n = 0; n + 2 < play.number; n++)
+      {
+        play.suit[n] = play.suit[n + 2];
+        play.rank[n] = play.rank[n + 2];
+      }
+      play.number = 21;
+    }
+
+    solvedPlay expected, solved;
+    ASSERT_EQ(RETURN_NO_FAULT, AnalysePlayBin(dl, play, &expected, 0));
+    ASSERT_EQ(RETURN_NO_FAULT, AnalysePlayBinParallel(dl, play, &solved));
+
+    ASSERT_EQ(expected.number, solved.number) << "strain " << trump;
+    for (int n = 0; n < expected.number; n++)
+      EXPECT_EQ(expected.tricks[n], solved.tricks[n])
+        << "strain " << trump << ", card " << n;
+  }
+}
+
+TEST(PlayAnalysisTest, ParallelRejectsABadTrace)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(505);
+  const deal dl = RandomDeal(rng, 4);
+  int declarerTricks;
+  playTraceBin play = PlayOut(dl, RandomCard(rng), declarerTricks);
+
+  // The fifth card is played a second time.
+  play.suit[9] = play.suit[4];
+  play.rank[9] = play.rank[4];
+
+  solvedPlay solved;
+  EXPECT_EQ(RETURN_PLAY_FAULT, AnalysePlayBin(dl, play, &solved, 0));
+  EXPECT_EQ(RETURN_PLAY_FAULT, AnalysePlayBinParallel(dl, play, &solved));
+}
@@ -0,0 +1,316 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <system/DealFingerprint.hpp>
+#include <system/ResultCache.hpp>
+#include <api/SolveBoard.hpp>
+#include <solver_context/SolverContext.hpp>
+#include "SolveBoard.hpp"
+#include "CalcTables.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+extern ResultCache solveCache;
+
+TEST(DealFingerprintTest, EveryInputChangesTheFingerprint)
+{
+  std::mt19937 rng(3);
+  const deal base = RandomDeal(rng, 4);
+  const dealFingerprint fp = DealFingerprint(base, -1, 3, 1);
+
+  EXPECT_EQ(fp, DealFingerprint(base, -1, 3, 1));
+  EXPECT_NE(fp, DealFingerprint(base, 0, 3, 1));
+  EXPECT_NE(fp, DealFingerprint(base, -1, 1, 1));
+  EXPECT_NE(fp, DealFingerprint(base, -1, 3, 2));
+
+  deal dl = base;
+  dl.trump = 0;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 3, 1));
+
+  dl = base;
+  dl.first = 1;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 3, 1));
+
+  dl = base;
+  dl.currentTrickRank[0] = 14;
+  dl.currentTrickSuit[0] = 2;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 3, 1));
+
+  // Same cards, but North and East exchange their clubs.
+  dl = base;
+  std::swap(dl.remainCards[0][3], dl.remainCards[1][3]);
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 3, 1));
+}
+
+TEST(DealFingerprintTest, OutOfRangeValuesStayDistinct)
+{
+  std::mt19937 rng(4);
+  const deal base = RandomDeal(rng, 4);
+  const dealFingerprint fp = DealFingerprint(base, -1, 1, 1);
+
+  // Values that agree in their low byte or nibble only.
+  EXPECT_NE(fp, DealFingerprint(base, 255, 1, 1));
+  EXPECT_NE(fp, DealFingerprint(base, -1, 257, 1));
+  EXPECT_NE(fp, DealFingerprint(base, -1, 1, 257));
+
+  deal dl = base;
+  dl.trump = 4 + 256;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 1, 1));
+
+  dl = base;
+  dl.currentTrickRank[1] = 16;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 1, 1));
+
+  // Bits above the 16 that a suit holding uses.
+  dl = base;
+  dl.remainCards[2][1] |= 0x10000u;
+  EXPECT_NE(fp, DealFingerprint(dl, -1, 1, 1));
+}
+
+TEST(DealFingerprintTest, DetectDuplicatesInOnePass)
+{
+  std::mt19937 rng(5);
+  static boards bds;
+  bds.noOfBoards = 0;
+
+  std::vector<deal> layouts;
+  for (int l = 0; l < 4; l++)
+    layouts.push_back(RandomDeal(rng, 4));
+
+  // 0 1 2 3 0 1 2 3 ... with every fifth board a different target.
+  for (int i = 0; i < 40; i++)
+  {
+    bds.deals[i] = layouts[static_cast<unsigned>(i % 4)];
+    bds.target[i] = (i % 5 == 4 ? 7 : -1);
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+    bds.noOfBoards++;
+  }
+
+  std::vector<int> uniques, crossrefs;
+  DetectSolveDuplicates(bds, uniques, crossrefs);
+
+  ASSERT_EQ(crossrefs.size(), 40u);
+  for (int i = 0; i < 40; i++)
+  {
+    const int c = crossrefs[static_cast<unsigned>(i)];
+    if (c == -1)
+    {
+      EXPECT_NE(std::find(uniques.begin(), uniques.end(), i),
+        uniques.end());
+      continue;
+    }
+
+    EXPECT_LT(c, i);
+    EXPECT_EQ(-1, crossrefs[static_cast<unsigned>(c)]);
+    EXPECT_EQ(i % 4, c % 4);
+    EXPECT_EQ(bds.target[i], bds.target[c]);
+  }
+
+  // Four layouts, each with target -1 and target 7.
+  EXPECT_EQ(8u, uniques.size());
+}
+
+TEST(ResultCacheTest, SecondBatchIsAnsweredFromTheCache)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  FreeMemory();
+
+  std::mt19937 rng(9);
+  static boards bds;
+  bds.noOfBoards = 6;
+  for (int i = 0; i < bds.noOfBoards; i++)
+  {
+    bds.deals[i] = RandomDeal(rng, 4);
+    bds.target[i] = -1;
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+  }
+
+  resultCacheStats st, tst;
+  static solvedBoards first, second;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds, &first));
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(0, st.hits);
+  EXPECT_EQ(6, st.misses);
+  EXPECT_EQ(6, st.entries);
+
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds, &second));
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(6, st.hits);
+
+  for (int i = 0; i < bds.noOfBoards; i++)
+  {
+    EXPECT_EQ(first.solvedBoard[i].cards, second.solvedBoard[i].cards);
+    EXPECT_EQ(first.solvedBoard[i].score[0], second.solvedBoard[i].score[0]);
+  }
+
+  FreeMemory();
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(0, st.entries);
+  EXPECT_EQ(0, st.hits);
+  SetResultCacheSize(0);
+}
+
+TEST(ResultCacheTest, TablesAreCachedPerStrain)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  FreeMemory();
+
+  std::mt19937 rng(13);
+  const deal dl = RandomDeal(rng, 4);
+  ddTableDeal td;
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      td.cards[h][s] = dl.remainCards[h][s];
+
+  ddTableResults t1, t2;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(td, &t1));
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(td, &t2));
+
+  resultCacheStats st, tst;
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(DDS_STRAINS, tst.hits);
+  EXPECT_EQ(DDS_STRAINS, tst.entries);
+
+  for (int s = 0; s < DDS_STRAINS; s++)
+    for (int h = 0; h < DDS_HANDS; h++)
+      EXPECT_EQ(t1.resTable[s][h], t2.resTable[s][h]);
+
+  FreeMemory();
+  SetResultCacheSize(0);
+}
+
+TEST(ResultCacheTest, ContextCanOptOut)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  FreeMemory();
+
+  std::mt19937 rng(17);
+  const deal dl = RandomDeal(rng, 4);
+
+  SolverConfig cfg;
+  cfg.useResultCache = false;
+  SolverContext ctx(cfg);
+
+  futureTricks fut;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(ctx, dl, -1, 1, 1, &fut));
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(ctx, dl, -1, 1, 1, &fut));
+
+  resultCacheStats st, tst;
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(0, st.hits + st.misses);
+  EXPECT_EQ(0, st.entries);
+  SetResultCacheSize(0);
+}
+
+TEST(ResultCacheTest, OffUntilSized)
+{
+  SetMaxThreads(0);
+  FreeMemory();
+
+  std::mt19937 rng(19);
+  const deal dl = RandomDeal(rng, 4);
+  futureTricks fut;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1, &fut, 0));
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1, &fut, 0));
+
+  // An unused cache counts nothing.
+  resultCacheStats st, tst;
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(0, st.hits);
+  EXPECT_EQ(0, st.misses);
+  EXPECT_EQ(0, st.entries);
+  EXPECT_EQ(0, st.capacity);
+
+  SetResultCacheSize(65536);
+  SetResultCacheSize(0);
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1, &fut, 0));
+  GetResultCacheStats(&st, &tst);
+  EXPECT_EQ(0, st.hits + st.misses);
+  FreeMemory();
+}
+
+TEST(ResultCacheTest, InvalidInputIsNotAnsweredFromTheCache)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  FreeMemory();
+
+  // Each hand holds one full suit.
+  deal dl = {};
+  for (int h = 0; h < DDS_HANDS; h++)
+    dl.remainCards[h][h] = 0x7ffc;
+  dl.trump = 4;
+  dl.first = 0;
+
+  futureTricks fut;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1, &fut, 0));
+  EXPECT_EQ(RETURN_TARGET_WRONG_HI, SolveBoard(dl, 255, 1, 1, &fut, 0));
+  EXPECT_EQ(RETURN_SOLNS_WRONG_HI, SolveBoard(dl, -1, 257, 1, &fut, 0));
+
+  // The same for the four declarers of a table entry.
+  SolverContext ctx;
+  deal td = dl;
+  int score[DDS_HANDS];
+  ASSERT_EQ(RETURN_NO_FAULT, CalcSingleDeal(ctx, td, -1, 1, 1, score));
+  td = dl;
+  EXPECT_EQ(RETURN_TARGET_WRONG_HI, CalcSingleDeal(ctx, td, 255, 1, 1, score));
+
+  FreeMemory();
+  SetResultCacheSize(0);
+}
+
+TEST(ResultCacheTest, EvictsTheLeastRecentlyUsed)
+{
+  // All keys in one shard, which then holds two entries.
+  ResultCache cache;
+  cache.SetCapacity(2 * DDS_RESULT_CACHE_SHARDS);
+
+  const dealFingerprint a{1, 0}, b{2, 0}, c{3, 0};
+  futureTricks fut = {};
+  cache.Store(a, fut);
+  cache.Store(b, fut);
+  EXPECT_TRUE(cache.Lookup(a, fut));
+  cache.Store(c, fut);
+
+  EXPECT_TRUE(cache.Lookup(a, fut));
+  EXPECT_FALSE(cache.Lookup(b, fut));
+  EXPECT_TRUE(cache.Lookup(c, fut));
+
+  resultCacheStats st;
+  cache.GetStats(st);
+  EXPECT_EQ(3, st.hits);
+  EXPECT_EQ(1, st.misses);
+  EXPECT_EQ(1, st.evictions);
+  EXPECT_EQ(2, st.entries);
+
+  cache.SetCapacity(0);
+  cache.Store(c, fut);
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_FALSE(cache.Lookup(c, fut));
+}
+
+TEST(ResultCacheTest, HoldsNoMoreThanItsCapacity)
+{
+  ResultCache cache;
+  EXPECT_EQ(0u, cache.Capacity());
+
+  // Fewer entries than shards, and a size that does not divide.
+  for (const size_t cap: {5u, 37u})
+  {
+    cache.SetCapacity(cap);
+    futureTricks fut = {};
+    for (uint64_t k = 0; k < 1000; k++)
+      cache.Store(dealFingerprint{k, k * 0x9e3779b97f4a7c15ULL}, fut);
+    EXPECT_LE(cache.Size(), cap);
+  }
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+
+#include <random>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+// Removes whole tricks, one card of a suit from each hand where it can,
+// so the deal stays legal. Then starts a trick with the lowest cards of
+// the first inTrick hands.
+void Shorten(deal& dl, const int tricks, const int inTrick)
+{
+  for (int t = 0; t < tricks; t++)
+  {
+    for (int h = 0; h < DDS_HANDS; h++)
+    {
+      for (int s = 0; s < DDS_SUITS; s++)
+      {
+        const unsigned holding = dl.remainCards[h][s];
+        if (holding)
+        {
+          dl.remainCards[h][s] &= ~(holding & -holding);
+          break;
+        }
+      }
+    }
+  }
+
+  int leadSuit = -1;
+  for (int c = 0; c < inTrick; c++)
+  {
+    const int hand = (dl.first + c) % DDS_HANDS;
+    int suit = leadSuit;
+    if (suit == -1 || dl.remainCards[hand][suit] == 0)
+    {
+      suit = 0;
+      while (dl.remainCards[hand][suit] == 0)
+        suit++;
+    }
+    if (leadSuit == -1)
+      leadSuit = suit;
+
+    const unsigned holding = dl.remainCards[hand][suit];
+    const unsigned low = holding & -holding;
+    int rank = 0;
+    while ((1u << rank) != low)
+      rank++;
+
+    dl.remainCards[hand][suit] &= ~low;
+    dl.currentTrickSuit[c] = suit;
+    dl.currentTrickRank[c] = rank;
+  }
+}
+
+void ExpectSame(const deal& dl, const char * what)
+{
+  futureTricks expected, solved;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 3, 1, &expected, 0))
+    << what;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoardParallel(dl, -1, 3, 1, &solved))
+    << what;
+
+  ASSERT_EQ(expected.cards, solved.cards) << what;
+  for (int i = 0; i < expected.cards; i++)
+  {
+    EXPECT_EQ(expected.suit[i], solved.suit[i]) << what << ", card " << i;
+    EXPECT_EQ(expected.rank[i], solved.rank[i]) << what << ", card " << i;
+    EXPECT_EQ(expected.equals[i], solved.equals[i]) << what << ", card " << i;
+    EXPECT_EQ(expected.score[i], solved.score[i]) << what << ", card " << i;
+  }
+}
+
+}
+
+TEST(RootParallelTest, MatchesSolveBoardInEveryStrain)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(606);
+
+  for (int trump = 0; trump < DDS_STRAINS; trump++)
+  {
+    const deal dl = RandomDeal(rng, trump, trump % DDS_HANDS);
+    ExpectSame(dl, "full deal");
+  }
+}
+
+TEST(RootParallelTest, MatchesSolveBoardInsideATrick)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(707);
+
+  for (int inTrick = 0; inTrick < 4; inTrick++)
+  {
+    for (int tricks = 3; tricks <= 11; tricks += 4)
+    {
+      deal dl = RandomDeal(rng, (tricks + inTrick) % DDS_STRAINS, inTrick);
+      Shorten(dl, tricks, inTrick);
+      ExpectSame(dl, "partial deal");
+    }
+  }
+}
+
+TEST(RootParallelTest, OtherSolutionsAsInSolveBoard)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(808);
+  const deal dl = RandomDeal(rng, 4, 1);
+
+  for (int solutions = 1; solutions <= 2; solutions++)
+  {
+    futureTricks expected, solved;
+    ASSERT_EQ(RETURN_NO_FAULT,
+      SolveBoard(dl, -1, solutions, 1, &expected, 0));
+    ASSERT_EQ(RETURN_NO_FAULT,
+      SolveBoardParallel(dl, -1, solutions, 1, &solved));
+    ASSERT_EQ(expected.cards, solved.cards);
+    for (int i = 0; i < expected.cards; i++)
+      EXPECT_EQ(expected.score[i], solved.score[i]);
+  }
+
+  futureTricks fut;
+  EXPECT_EQ(RETURN_SOLNS_WRONG_HI, SolveBoardParallel(dl, -1, 4, 1, &fut));
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <system/Scheduler.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+constexpr int kThreads = 4;
+constexpr int kLayouts = 12;
+
+// Every layout in two strains with each hand on lead, so the
+// scheduler forms groups with several repeats each.
+void MakeBoards(boards& bds)
+{
+  std::mt19937 rng(20240517);
+  bds.noOfBoards = 0;
+  for (int l = 0; l < kLayouts; l++)
+  {
+    const deal base = RandomDeal(rng);
+    for (int strain = 0; strain < DDS_STRAINS; strain += 4)
+    {
+      for (int first = 0; first < DDS_HANDS; first++)
+      {
+        const int n = bds.noOfBoards++;
+        bds.deals[n] = base;
+        bds.deals[n].trump = strain;
+        bds.deals[n].first = first;
+        bds.target[n] = -1;
+        bds.solutions[n] = 1;
+        bds.mode[n] = 1;
+      }
+    }
+  }
+}
+
+struct Taken
+{
+  int thrId;
+  int number;
+  int repeatOf;
+};
+
+}
+
+TEST(SchedulerTest, EveryBoardHandedOutOnceAcrossThreads)
+{
+  static boards bds;
+  MakeBoards(bds);
+
+  Scheduler sched;
+  sched.RegisterThreads(kThreads);
+  sched.RegisterRun(DDS_RUN_CALC, bds);
+
+  std::mutex mtx;
+  std::vector<Taken> taken;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < kThreads; t++)
+  {
+    workers.emplace_back([&, t]()
+    {
+      while (true)
+      {
+        const schedType st = sched.GetNumber(t);
+        if (st.number == -1)
+          break;
+        std::lock_guard<std::mutex> lk(mtx);
+        taken.push_back({t, st.number, st.repeatOf});
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  ASSERT_EQ(static_cast<int>(taken.size()), bds.noOfBoards);
+
+  std::vector<int> seen(static_cast<unsigned>(bds.noOfBoards), 0);
+  for (const auto& tk : taken)
+  {
+    ASSERT_GE(tk.number, 0);
+    ASSERT_LT(tk.number, bds.noOfBoards);
+    seen[static_cast<unsigned>(tk.number)]++;
+  }
+  for (int n = 0; n < bds.noOfBoards; n++)
+    EXPECT_EQ(seen[static_cast<unsigned>(n)], 1) << "board " << n;
+}
+
+TEST(SchedulerTest, RepeatsFollowTheirHeadOnTheSameThread)
+{
+  static boards bds;
+  MakeBoards(bds);
+
+  Scheduler sched;
+  sched.RegisterThreads(kThreads);
+  sched.RegisterRun(DDS_RUN_CALC, bds);
+
+  std::vector<std::vector<schedType>> perThread(kThreads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < kThreads; t++)
+  {
+    workers.emplace_back([&, t]()
+    {
+      while (true)
+      {
+        const schedType st = sched.GetNumber(t);
+        if (st.number == -1)
+          break;
+        perThread[static_cast<unsigned>(t)].push_back(st);
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  // A stolen group moves as a whole, so the head of every repeat was
+  // solved earlier by the same thread and shares the card layout.
+  int repeats = 0;
+  for (const auto& list : perThread)
+  {
+    std::vector<int> solved;
+    for (const auto& st : list)
+    {
+      if (st.repeatOf != -1)
+      {
+        repeats++;
+        EXPECT_NE(std::find(solved.begin(), solved.end(), st.repeatOf),
+          solved.end()) << "board " << st.number;
+
+        for (int h = 0; h < DDS_HANDS; h++)
+          for (int s = 0; s < DDS_SUITS; s++)
+            EXPECT_EQ(bds.deals[st.number].remainCards[h][s],
+              bds.deals[st.repeatOf].remainCards[h][s]);
+      }
+      solved.push_back(st.number);
+    }
+  }
+  EXPECT_GT(repeats, 0);
+}
+
+TEST(SchedulerTest, SingleThreadDrainsAllGroups)
+{
+  static boards bds;
+  MakeBoards(bds);
+
+  Scheduler sched;
+  sched.RegisterThreads(1);
+  sched.RegisterRun(DDS_RUN_CALC, bds);
+
+  int count = 0;
+  while (sched.GetNumber(0).number != -1)
+    count++;
+
+  EXPECT_EQ(count, bds.noOfBoards);
+  EXPECT_EQ(sched.GetNumber(0).number, -1);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/SolveBoard.hpp>
+#include <solver_context/SolverContext.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+SolverConfig Uncached()
+{
+  SolverConfig cfg;
+  cfg.useResultCache = false;
+  return cfg;
+}
+
+int Score(const deal& dl)
+{
+  SolverContext ctx(Uncached());
+  futureTricks fut = {};
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoard(ctx, dl, -1, 1, 1, &fut));
+  return fut.score[0];
+}
+
+}
+
+TEST(SearchLimitsTest, CancelledBeforeTheStart)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(11);
+  const deal dl = RandomDeal(rng, 4);
+
+  SolverContext ctx(Uncached());
+  SearchLimits limits;
+  limits.cancel = std::make_shared<std::atomic<bool>>(true);
+  ctx.SetSearchLimits(limits);
+
+  futureTricks fut = {};
+  EXPECT_EQ(RETURN_CANCELLED, SolveBoard(ctx, dl, -1, 3, 1, &fut));
+  EXPECT_EQ(0, fut.cards);
+  EXPECT_LE(ctx.stoppedBounds().lower, ctx.stoppedBounds().upper);
+
+  // The stopped search leaves the context usable.
+  ctx.SetSearchLimits(SearchLimits{});
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoard(ctx, dl, -1, 1, 1, &fut));
+  EXPECT_EQ(Score(dl), fut.score[0]);
+}
+
+TEST(SearchLimitsTest, DeadlineBoundsContainTheScore)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(12);
+
+  for (int i = 0; i < 6; i++)
+  {
+    const deal dl = RandomDeal(rng, i % 5);
+
+    SolverContext ctx(Uncached());
+    SearchLimits limits;
+    limits.deadline =
+      std::chrono::steady_clock::now() + std::chrono::microseconds(200 * i);
+    ctx.SetSearchLimits(limits);
+
+    futureTricks fut = {};
+    const int res = SolveBoard(ctx, dl, -1, 1, 1, &fut);
+    const int score = Score(dl);
+    if (res == RETURN_NO_FAULT)
+    {
+      EXPECT_EQ(score, fut.score[0]);
+      continue;
+    }
+
+    ASSERT_EQ(RETURN_TIMEOUT, res);
+    EXPECT_LE(ctx.stoppedBounds().lower, score);
+    EXPECT_GE(ctx.stoppedBounds().upper, score);
+  }
+}
+
+TEST(SearchLimitsTest, CancelFromAnotherThread)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(13);
+  const deal dl = RandomDeal(rng, 4);
+
+  SolverContext ctx(Uncached());
+  SearchLimits limits;
+  limits.cancel = std::make_shared<std::atomic<bool>>(false);
+  ctx.SetSearchLimits(limits);
+
+  std::thread canceller([flag = limits.cancel]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    flag->store(true);
+  });
+
+  futureTricks fut = {};
+  const int res = SolveBoard(ctx, dl, -1, 3, 1, &fut);
+  canceller.join();
+
+  if (res == RETURN_NO_FAULT)
+    GTEST_SKIP() << "The solve finished before the cancel";
+  ASSERT_EQ(RETURN_CANCELLED, res);
+
+  const int score = Score(dl);
+  EXPECT_LE(ctx.stoppedBounds().lower, score);
+  EXPECT_GE(ctx.stoppedBounds().upper, score);
+  if (fut.cards > 0)
+  {
+    EXPECT_EQ(score, fut.score[0]);
+  }
+}
+
+TEST(SearchLimitsTest, CancelledBatchSkipsItsBoards)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(14);
+
+  static boards bds;
+  static solvedBoards solved;
+  bds.noOfBoards = 8;
+  for (int i = 0; i < bds.noOfBoards; i++)
+  {
+    bds.deals[i] = RandomDeal(rng, i % 5);
+    bds.target[i] = -1;
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+  }
+
+  SearchLimits limits;
+  limits.cancel = std::make_shared<std::atomic<bool>>(true);
+  EXPECT_EQ(RETURN_CANCELLED, SolveAllBoardsBin(bds, solved, limits));
+  for (int i = 0; i < bds.noOfBoards; i++)
+    EXPECT_EQ(0, solved.solvedBoard[i].cards);
+
+  // Without limits the same batch solves as before.
+  EXPECT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds, &solved));
+  for (int i = 0; i < bds.noOfBoards; i++)
+    EXPECT_EQ(Score(bds.deals[i]), solved.solvedBoard[i].score[0]);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/SolveAsync.hpp>
+
+#include <atomic>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+struct cResult
+{
+  std::atomic<int> calls{0};
+  int status = 0;
+  futureTricks fut = {};
+};
+
+void STDCALL OnSolved(
+  void * user,
+  int status,
+  const futureTricks * futp)
+{
+  cResult * res = static_cast<cResult *>(user);
+  res->status = status;
+  res->fut = * futp;
+  res->calls++;
+}
+
+}
+
+TEST(SolveAsyncTest, FuturesFromManyClients)
+{
+  SetMaxThreads(0);
+
+  std::mt19937 rng(17);
+  std::vector<streamBoard> input;
+  for (int i = 0; i < 24; i++)
+  {
+    streamBoard bd;
+    bd.dl = RandomDeal(rng);
+    bd.dl.trump = i % 5;
+    bd.dl.first = i % 4;
+    bd.target = -1;
+    bd.solutions = 1;
+    bd.mode = 1;
+    input.push_back(bd);
+  }
+
+  std::vector<futureTricks> expected(input.size());
+  for (unsigned i = 0; i < input.size(); i++)
+    ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(input[i].dl, -1, 1, 1,
+      &expected[i], 0));
+
+  // Four clients submit at the same time, and each waits for its own.
+  std::vector<std::future<asyncBoardResult>> results(input.size());
+  std::vector<std::thread> clients;
+  for (unsigned c = 0; c < 4; c++)
+  {
+    clients.emplace_back([&, c]()
+    {
+      for (unsigned i = c; i < input.size(); i += 4)
+        results[i] = SubmitBoard(input[i]);
+    });
+  }
+  for (auto& t: clients)
+    t.join();
+
+  for (unsigned i = 0; i < input.size(); i++)
+  {
+    const asyncBoardResult res = results[i].get();
+    EXPECT_EQ(RETURN_NO_FAULT, res.status);
+    EXPECT_EQ(expected[i].score[0], res.fut.score[0]) << "board " << i;
+  }
+}
+
+TEST(SolveAsyncTest, TablesAndCallbacks)
+{
+  SetMaxThreads(0);
+
+  std::mt19937 rng(19);
+  ddTableDeal td;
+  const deal dl = RandomDeal(rng);
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      td.cards[h][s] = dl.remainCards[h][s];
+
+  ddTableResults expected;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(td, &expected));
+
+  std::atomic<int> calls{0};
+  ddTableResults fromCallback = {};
+  SubmitTable(td, [&](int status, const ddTableResults& table)
+  {
+    EXPECT_EQ(RETURN_NO_FAULT, status);
+    fromCallback = table;
+    calls++;
+  });
+  std::future<asyncTableResult> fromFuture = SubmitTable(td);
+
+  const asyncTableResult res = fromFuture.get();
+  WaitAllAsync();
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(RETURN_NO_FAULT, res.status);
+  for (int s = 0; s < DDS_STRAINS; s++)
+  {
+    for (int h = 0; h < DDS_HANDS; h++)
+    {
+      EXPECT_EQ(expected.resTable[s][h], res.table.resTable[s][h]);
+      EXPECT_EQ(expected.resTable[s][h], fromCallback.resTable[s][h]);
+    }
+  }
+}
+
+TEST(SolveAsyncTest, CInterfaceReportsErrors)
+{
+  SetMaxThreads(0);
+
+  std::mt19937 rng(23);
+  deal dl = RandomDeal(rng);
+  dl.trump = 4;
+  dl.first = 0;
+
+  cResult good, bad;
+  EXPECT_EQ(RETURN_NO_FAULT,
+    SolveBoardAsync(dl, -1, 3, 1, OnSolved, &good));
+  EXPECT_EQ(RETURN_NO_FAULT,
+    SolveBoardAsync(dl, -1, 4, 1, OnSolved, &bad));
+  EXPECT_EQ(RETURN_UNKNOWN_FAULT,
+    SolveBoardAsync(dl, -1, 1, 1, nullptr, nullptr));
+  WaitAllAsync();
+
+  EXPECT_EQ(1, good.calls.load());
+  EXPECT_EQ(RETURN_NO_FAULT, good.status);
+  EXPECT_GT(good.fut.cards, 0);
+
+  EXPECT_EQ(1, bad.calls.load());
+  EXPECT_EQ(RETURN_SOLNS_WRONG_HI, bad.status);
+}
+
+TEST(SolveAsyncTest, FreeMemoryDrainsTheQueue)
+{
+  SetMaxThreads(0);
+
+  std::mt19937 rng(29);
+  std::atomic<int> calls{0};
+  for (int i = 0; i < 6; i++)
+  {
+    streamBoard bd;
+    bd.dl = RandomDeal(rng);
+    bd.dl.trump = i % 5;
+    bd.dl.first = i % 4;
+    bd.target = -1;
+    bd.solutions = 1;
+    bd.mode = 1;
+    SubmitBoard(bd, [&](int status, const futureTricks&)
+    {
+      EXPECT_EQ(RETURN_NO_FAULT, status);
+      calls++;
+    });
+  }
+
+  FreeMemory();
+  EXPECT_EQ(6, calls.load());
+
+  // The next request starts the dispatcher again.
+  streamBoard bd;
+  bd.dl = RandomDeal(rng);
+  bd.target = -1;
+  bd.solutions = 1;
+  bd.mode = 1;
+  EXPECT_EQ(RETURN_NO_FAULT, SubmitBoard(bd).get().status);
+}
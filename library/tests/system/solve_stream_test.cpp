@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/SolveStream.hpp>
+
+#include <random>
+#include <vector>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+TEST(SolveStreamTest, MoreBoardsThanOneBatch)
+{
+  SetMaxThreads(0);
+
+  // A few layouts repeated past MAXNOOFBOARDS, with varying strain and
+  // leader, interleaved as a tournament file would have them.
+  std::mt19937 rng(7);
+  std::vector<deal> layouts;
+  for (int l = 0; l < 3; l++)
+    layouts.push_back(RandomDeal(rng));
+
+  const int number = MAXNOOFBOARDS + 40;
+  std::vector<deal> input;
+  for (int i = 0; i < number; i++)
+  {
+    deal dl = layouts[static_cast<unsigned>(i % 3)];
+    dl.trump = (i / 3) % 2 == 0 ? 4 : 0;
+    dl.first = (i / 6) % 2;
+    input.push_back(dl);
+  }
+
+  std::vector<futureTricks> expected(4);
+  auto slot = [](const deal& dl) { return (dl.trump == 4 ? 0 : 2) + dl.first; };
+  std::vector<std::vector<futureTricks>> ref(3, expected);
+  for (int l = 0; l < 3; l++)
+  {
+    for (int v = 0; v < 4; v++)
+    {
+      deal dl = layouts[static_cast<unsigned>(l)];
+      dl.trump = (v < 2 ? 4 : 0);
+      dl.first = v % 2;
+      ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 1, 1,
+        &ref[static_cast<unsigned>(l)][static_cast<unsigned>(slot(dl))], 0));
+    }
+  }
+
+  int produced = 0;
+  auto next = [&](streamBoard& bd) -> bool
+  {
+    if (produced == number)
+      return false;
+    bd.dl = input[static_cast<unsigned>(produced++)];
+    bd.target = -1;
+    bd.solutions = 1;
+    bd.mode = 1;
+    return true;
+  };
+
+  std::vector<int> seen(static_cast<unsigned>(number), 0);
+  auto done = [&](int i, int status, const futureTricks& fut)
+  {
+    ASSERT_GE(i, 0);
+    ASSERT_LT(i, number);
+    seen[static_cast<unsigned>(i)]++;
+    EXPECT_EQ(RETURN_NO_FAULT, status);
+
+    const deal& dl = input[static_cast<unsigned>(i)];
+    const futureTricks& r =
+      ref[static_cast<unsigned>(i % 3)][static_cast<unsigned>(slot(dl))];
+    EXPECT_EQ(r.score[0], fut.score[0]) << "board " << i;
+  };
+
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoardStream(next, done, 32));
+  EXPECT_EQ(number, produced);
+  for (int i = 0; i < number; i++)
+    EXPECT_EQ(1, seen[static_cast<unsigned>(i)]) << "board " << i;
+}
+
+TEST(SolveStreamTest, TablesMatchCalcDDtable)
+{
+  SetMaxThreads(0);
+
+  std::mt19937 rng(11);
+  std::vector<ddTableDeal> input(2);
+  for (auto& td: input)
+  {
+    const deal dl = RandomDeal(rng);
+    for (int h = 0; h < DDS_HANDS; h++)
+      for (int s = 0; s < DDS_SUITS; s++)
+        td.cards[h][s] = dl.remainCards[h][s];
+  }
+
+  std::vector<ddTableResults> expected(input.size());
+  for (unsigned t = 0; t < input.size(); t++)
+    ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(input[t], &expected[t]));
+
+  unsigned produced = 0;
+  auto next = [&](ddTableDeal& td) -> bool
+  {
+    if (produced == input.size())
+      return false;
+    td = input[produced++];
+    return true;
+  };
+
+  std::vector<int> seen(input.size(), 0);
+  auto done = [&](int i, int status, const ddTableResults& table)
+  {
+    const unsigned t = static_cast<unsigned>(i);
+    ASSERT_LT(t, input.size());
+    seen[t]++;
+    EXPECT_EQ(RETURN_NO_FAULT, status);
+    for (int s = 0; s < DDS_STRAINS; s++)
+      for (int h = 0; h < DDS_HANDS; h++)
+        EXPECT_EQ(expected[t].resTable[s][h], table.resTable[s][h])
+          << "table " << i << " strain " << s << " hand " << h;
+  };
+
+  EXPECT_EQ(RETURN_NO_FAULT, CalcTableStream(next, done));
+  for (auto n: seen)
+    EXPECT_EQ(1, n);
+}
+
+TEST(SolveStreamTest, AllStrainsFilteredIsAnError)
+{
+  auto next = [](ddTableDeal&) { return false; };
+  auto done = [](int, int, const ddTableResults&) {};
+  const int filter[DDS_STRAINS] = {1, 1, 1, 1, 1};
+
+  EXPECT_EQ(RETURN_NO_SUIT, CalcTableStream(next, done, filter));
+}
+
+TEST(SolveStreamTest, EmptyStream)
+{
+  int calls = 0;
+  auto next = [](streamBoard&) { return false; };
+  auto done = [&](int, int, const futureTricks&) { calls++; };
+
+  EXPECT_EQ(RETURN_NO_FAULT, SolveBoardStream(next, done));
+  EXPECT_EQ(0, calls);
+}
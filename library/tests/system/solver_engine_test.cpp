@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/SolverEngine.hpp>
+
+#include <random>
+#include <thread>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+void MakeBoards(
+  const unsigned seed,
+  const int number,
+  boards& bds)
+{
+  std::mt19937 rng(seed);
+  bds.noOfBoards = number;
+  for (int i = 0; i < number; i++)
+  {
+    bds.deals[i] = RandomDeal(rng, i % 5, i % 4);
+    bds.target[i] = -1;
+    bds.solutions[i] = 1;
+    bds.mode[i] = 1;
+  }
+}
+
+void MakeTables(
+  const unsigned seed,
+  const int number,
+  ddTableDeals& deals)
+{
+  std::mt19937 rng(seed);
+  deals.noOfTables = number;
+  for (int m = 0; m < number; m++)
+  {
+    const deal dl = RandomDeal(rng, 0, 0);
+    for (int h = 0; h < DDS_HANDS; h++)
+      for (int s = 0; s < DDS_SUITS; s++)
+        deals.deals[m].cards[h][s] = dl.remainCards[h][s];
+  }
+}
+
+}
+
+TEST(SolverEngineTest, TwoEnginesSideBySide)
+{
+  // The process-wide result caches are off, so every result is
+  // searched on the engine that returns it.
+  SetMaxThreads(2);
+
+  static boards bds;
+  static solvedBoards expectedBoards, solvedBoards1;
+  static ddTableDeals deals;
+  static ddTablesRes expectedTables, tables2;
+  static allParResults par;
+  const int filter[DDS_STRAINS] = {0, 0, 0, 0, 0};
+
+  MakeBoards(31, 8, bds);
+  MakeTables(32, 2, deals);
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds, &expectedBoards));
+  ASSERT_EQ(RETURN_NO_FAULT, SolverEngine::Default().CalcAllTables(
+    deals, -1, filter, &expectedTables, &par));
+
+  SolverEngine engine1(0, 2);
+  SolverEngine engine2(0, 2);
+  int ret1 = RETURN_UNKNOWN_FAULT;
+  int ret2 = RETURN_UNKNOWN_FAULT;
+
+  std::thread t1([&]()
+  {
+    ret1 = engine1.SolveAllBoardsBin(bds, solvedBoards1);
+  });
+  std::thread t2([&]()
+  {
+    ret2 = engine2.CalcAllTables(deals, -1, filter, &tables2, &par);
+  });
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ(RETURN_NO_FAULT, ret1);
+  ASSERT_EQ(RETURN_NO_FAULT, ret2);
+
+  for (int i = 0; i < bds.noOfBoards; i++)
+    EXPECT_EQ(expectedBoards.solvedBoard[i].score[0],
+      solvedBoards1.solvedBoard[i].score[0]) << "board " << i;
+
+  for (int m = 0; m < deals.noOfTables; m++)
+    for (int s = 0; s < DDS_STRAINS; s++)
+      for (int h = 0; h < DDS_HANDS; h++)
+        EXPECT_EQ(expectedTables.results[m].resTable[s][h],
+          tables2.results[m].resTable[s][h]) << "table " << m;
+}
+
+TEST(SolverEngineTest, BatchesOnOneEngineWait)
+{
+  SetMaxThreads(2);
+
+  static boards bds1, bds2;
+  static solvedBoards expected1, expected2, solved1, solved2;
+  MakeBoards(41, 6, bds1);
+  MakeBoards(42, 6, bds2);
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds1, &expected1));
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds2, &expected2));
+
+  // Two clients of one engine: the second batch runs after the first.
+  SolverEngine engine(0, 2);
+  int ret1 = RETURN_UNKNOWN_FAULT;
+  int ret2 = RETURN_UNKNOWN_FAULT;
+
+  std::thread t1([&]() { ret1 = engine.SolveAllBoardsBin(bds1, solved1); });
+  std::thread t2([&]() { ret2 = engine.SolveAllBoardsBin(bds2, solved2); });
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ(RETURN_NO_FAULT, ret1);
+  ASSERT_EQ(RETURN_NO_FAULT, ret2);
+  for (int i = 0; i < bds1.noOfBoards; i++)
+  {
+    EXPECT_EQ(expected1.solvedBoard[i].score[0],
+      solved1.solvedBoard[i].score[0]);
+    EXPECT_EQ(expected2.solvedBoard[i].score[0],
+      solved2.solvedBoard[i].score[0]);
+  }
+}
+
+TEST(SolverEngineTest, SingleBoardOnAThreadOfTheEngine)
+{
+  SetMaxThreads(1);
+
+  std::mt19937 rng(43);
+  const deal dl = RandomDeal(rng, 4, 1);
+
+  futureTricks expected;
+  ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(dl, -1, 3, 1, &expected, 0));
+
+  SolverEngine engine(0, 2);
+  futureTricks fut;
+  EXPECT_EQ(RETURN_THREAD_INDEX,
+    engine.SolveBoard(dl, -1, 3, 1, &fut, engine.NumThreads()));
+  ASSERT_EQ(RETURN_NO_FAULT,
+    engine.SolveBoard(dl, -1, 3, 1, &fut, engine.NumThreads() - 1));
+
+  EXPECT_EQ(expected.cards, fut.cards);
+  for (int k = 0; k < expected.cards; k++)
+  {
+    EXPECT_EQ(expected.suit[k], fut.suit[k]);
+    EXPECT_EQ(expected.rank[k], fut.rank[k]);
+    EXPECT_EQ(expected.score[k], fut.score[k]);
+  }
+}
+
+TEST(SolverEngineTest, ProcessWideBackendsOnlyOnTheDefault)
+{
+  SolverEngine engine(0, 2);
+
+  // Windows, OpenMP, GCD, STL-impl and PPL-impl.
+  for (const int code: {1, 2, 3, 7, 8})
+    EXPECT_EQ(RETURN_THREAD_MISSING, engine.SetThreading(code)) << code;
+
+  EXPECT_EQ(RETURN_NO_FAULT, engine.SetThreading(0));
+}
+
+TEST(SolverEngineTest, SharedTTSizeWaitsForTheRuns)
+{
+  SetMaxThreads(2);
+
+  static boards bds;
+  static solvedBoards expected, solved;
+  MakeBoards(47, 6, bds);
+  ASSERT_EQ(RETURN_NO_FAULT, SolveAllBoardsBin(&bds, &expected));
+
+  // The shared table is switched on and off while a batch runs on
+  // another engine. Both switches reach that engine after its batch.
+  SolverEngine engine(0, 2);
+  int ret = RETURN_UNKNOWN_FAULT;
+  std::thread t([&]() { ret = engine.SolveAllBoardsBin(bds, solved); });
+  SetSharedTTSize(16);
+  SetSharedTTSize(0);
+  t.join();
+
+  ASSERT_EQ(RETURN_NO_FAULT, ret);
+  for (int i = 0; i < bds.noOfBoards; i++)
+    EXPECT_EQ(expected.solvedBoard[i].score[0],
+      solved.solvedBoard[i].score[0]);
+
+  SetSharedTTSize(16);
+  ASSERT_EQ(RETURN_NO_FAULT, engine.SolveAllBoardsBin(bds, solved));
+  for (int i = 0; i < bds.noOfBoards; i++)
+    EXPECT_EQ(expected.solvedBoard[i].score[0],
+      solved.solvedBoard[i].score[0]);
+  SetSharedTTSize(0);
+}
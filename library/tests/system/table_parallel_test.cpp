@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+
+#include <random>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomTableDeal;
+
+namespace {
+
+void ExpectSameTable(
+  const ddTableResults& expected,
+  const ddTableResults& table)
+{
+  for (int strain = 0; strain < DDS_STRAINS; strain++)
+    for (int hand = 0; hand < DDS_HANDS; hand++)
+      EXPECT_EQ(expected.resTable[strain][hand],
+        table.resTable[strain][hand])
+        << "strain " << strain << ", hand " << hand;
+}
+
+}
+
+TEST(TableParallelTest, MatchesCalcDDtable)
+{
+  SetMaxThreads(0);
+  std::mt19937 rng(909);
+
+  for (int n = 0; n < 4; n++)
+  {
+    const ddTableDeal dl = RandomTableDeal(rng);
+    ddTableResults expected, table;
+    ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(dl, &expected));
+    ASSERT_EQ(RETURN_NO_FAULT, CalcDDtableParallel(dl, &table));
+    ExpectSameTable(expected, table);
+  }
+}
+
+TEST(TableParallelTest, UsesTheResultCache)
+{
+  SetMaxThreads(0);
+  SetResultCacheSize(65536);
+  std::mt19937 rng(1010);
+  const ddTableDeal dl = RandomTableDeal(rng);
+
+  ddTableResults expected, table;
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtableParallel(dl, &expected));
+
+  resultCacheStats solveStats, tableStats;
+  GetResultCacheStats(&solveStats, &tableStats);
+  const auto hits = tableStats.hits;
+
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtableParallel(dl, &table));
+  GetResultCacheStats(&solveStats, &tableStats);
+  EXPECT_EQ(hits + DDS_STRAINS, tableStats.hits);
+  ExpectSameTable(expected, table);
+
+  // The batch version finds the same entries.
+  ASSERT_EQ(RETURN_NO_FAULT, CalcDDtable(dl, &table));
+  ExpectSameTable(expected, table);
+
+  SetResultCacheSize(0);
+}
@@ -0,0 +1,34 @@
+#include "test_utilities.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace dds_test {
+
+deal RandomDeal(std::mt19937& rng, const int trump, const int first)
+{
+  const ddTableDeal table = RandomTableDeal(rng);
+
+  deal dl = {};
+  for (int h = 0; h < DDS_HANDS; h++)
+    for (int s = 0; s < DDS_SUITS; s++)
+      dl.remainCards[h][s] = table.cards[h][s];
+  dl.trump = trump;
+  dl.first = first;
+  return dl;
+}
+
+ddTableDeal RandomTableDeal(std::mt19937& rng)
+{
+  std::vector<int> cards(52);
+  for (int c = 0; c < 52; c++)
+    cards[c] = c;
+  std::shuffle(cards.begin(), cards.end(), rng);
+
+  ddTableDeal dl = {};
+  for (int c = 0; c < 52; c++)
+    dl.cards[c / 13][cards[c] / 13] |= (1u << (cards[c] % 13 + 2));
+  return dl;
+}
+
+} // namespace dds_test
@@ -0,0 +1,17 @@
+#ifndef DDS_SYSTEM_TEST_UTILITIES_H
+#define DDS_SYSTEM_TEST_UTILITIES_H
+
+#include <random>
+#include <api/dll.h>
+
+namespace dds_test {
+
+// The 52 cards shuffled by rng and dealt 13 to each hand.
+deal RandomDeal(std::mt19937& rng, int trump = 0, int first = 0);
+
+// The same deal as RandomDeal, as a table deal.
+ddTableDeal RandomTableDeal(std::mt19937& rng);
+
+} // namespace dds_test
+
+#endif // DDS_SYSTEM_TEST_UTILITIES_H
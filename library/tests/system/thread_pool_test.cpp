@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <system/ThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr unsigned kWorkers = 4;
+
+std::atomic<int> calls[kWorkers];
+std::thread::id ids[kWorkers];
+
+void RecordCall(const int thrId)
+{
+  calls[thrId]++;
+  ids[thrId] = std::this_thread::get_id();
+}
+
+// Stand-in for a batch of boards: the workers share a counter of
+// boards and each board costs a small fixed amount of work.
+std::atomic<int> nextBoard;
+int numBoards = 0;
+std::atomic<unsigned> sink;
+
+void SolveFakeBoards(const int /*thrId*/)
+{
+  while (nextBoard.fetch_add(1) < numBoards)
+  {
+    unsigned x = 0;
+    for (unsigned i = 0; i < 2000; i++)
+      x = x * 31 + i;
+    sink += x;
+  }
+}
+
+}
+
+TEST(ThreadPoolTest, EveryWorkerRunsOncePerRun)
+{
+  ThreadPool pool;
+  pool.Start(kWorkers);
+  ASSERT_EQ(kWorkers, pool.NumWorkers());
+
+  for (auto& c: calls)
+    c = 0;
+
+  for (int run = 1; run <= 5; run++)
+  {
+    pool.Run(&RecordCall);
+    for (unsigned k = 0; k < kWorkers; k++)
+      EXPECT_EQ(run, calls[k].load());
+  }
+}
+
+TEST(ThreadPoolTest, WorkerKeepsItsThreadAcrossRuns)
+{
+  ThreadPool pool;
+  pool.Start(kWorkers);
+
+  pool.Run(&RecordCall);
+  std::thread::id first[kWorkers];
+  for (unsigned k = 0; k < kWorkers; k++)
+    first[k] = ids[k];
+
+  pool.Run(&RecordCall);
+  for (unsigned k = 0; k < kWorkers; k++)
+  {
+    EXPECT_EQ(first[k], ids[k]);
+    EXPECT_NE(std::this_thread::get_id(), ids[k]);
+  }
+}
+
+TEST(ThreadPoolTest, StopAndRestart)
+{
+  ThreadPool pool;
+  pool.Stop();
+  EXPECT_EQ(0u, pool.NumWorkers());
+
+  pool.Start(2);
+  pool.Stop();
+  EXPECT_EQ(0u, pool.NumWorkers());
+
+  for (auto& c: calls)
+    c = 0;
+  pool.Start(3);
+  pool.Run(&RecordCall);
+  EXPECT_EQ(1, calls[0].load());
+  EXPECT_EQ(1, calls[2].load());
+  EXPECT_EQ(0, calls[3].load());
+}
+
+// Not a pass/fail test: prints the per-batch cost of the persistent
+// pool against creating and joining threads for every batch, which is
+// what the STL backend used to do.
+TEST(ThreadPoolTest, BatchOverheadBenchmark)
+{
+  const unsigned nthr = std::max(2u, std::thread::hardware_concurrency());
+  const int reps = 200;
+
+  ThreadPool pool;
+  pool.Start(nthr);
+
+  std::cout << "threads " << nthr << ", " << reps << " batches each\n";
+  std::cout << std::setw(8) << "boards" <<
+    std::setw(16) << "spawn (us)" <<
+    std::setw(16) << "pool (us)" << "\n";
+
+  for (const int n: {1, 10, 200})
+  {
+    numBoards = n;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+    {
+      nextBoard = 0;
+      std::vector<std::thread> threads;
+      for (unsigned k = 0; k < nthr; k++)
+        threads.emplace_back(&SolveFakeBoards, static_cast<int>(k));
+      for (auto& t: threads)
+        t.join();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+    {
+      nextBoard = 0;
+      pool.Run(&SolveFakeBoards);
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    using us = std::chrono::duration<double, std::micro>;
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(1) <<
+      std::setw(16) << us(t1 - t0).count() / reps <<
+      std::setw(16) << us(t2 - t1).count() / reps << "\n";
+  }
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <api/dll.h>
+#include <api/SolveBoard.hpp>
+#include <solver_context/SolverContext.hpp>
+
+#include <random>
+
+#include "library/tests/system/test_utilities.hpp"
+
+using dds_test::RandomDeal;
+
+namespace {
+
+futureTricks Solve(
+  const deal& dl,
+  const int target,
+  const int solutions,
+  const bool useTrickEstimate)
+{
+  SolverConfig cfg;
+  cfg.useResultCache = false;
+  cfg.useTrickEstimate = useTrickEstimate;
+  SolverContext ctx(cfg);
+
+  futureTricks fut = {};
+  EXPECT_EQ(RETURN_NO_FAULT,
+    SolveBoard(ctx, dl, target, solutions, 1, &fut));
+  return fut;
+}
+
+}
+
+// The first guess only changes how many root searches are made, so
+// every card and score must come out as with the fixed guess.
+TEST(TrickEstimateTest, SameResultsAsTheFixedGuess)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(2222);
+
+  for (int strain = 0; strain < DDS_STRAINS; strain++)
+  {
+    const deal dl = RandomDeal(rng, strain, strain % DDS_HANDS);
+    for (int solutions = 1; solutions <= 3; solutions++)
+    {
+      const futureTricks fixed = Solve(dl, -1, solutions, false);
+      const futureTricks guessed = Solve(dl, -1, solutions, true);
+
+      ASSERT_EQ(fixed.cards, guessed.cards)
+        << "strain " << strain << ", solutions " << solutions;
+      for (int i = 0; i < fixed.cards; i++)
+      {
+        EXPECT_EQ(fixed.suit[i], guessed.suit[i]) << "card " << i;
+        EXPECT_EQ(fixed.rank[i], guessed.rank[i]) << "card " << i;
+        EXPECT_EQ(fixed.equals[i], guessed.equals[i]) << "card " << i;
+        EXPECT_EQ(fixed.score[i], guessed.score[i]) << "card " << i;
+      }
+    }
+  }
+}
+
+// With solutions 3 the estimate is not used, so the search is the
+// same node for node.
+TEST(TrickEstimateTest, AllCardsKeepTheFixedGuess)
+{
+  SetMaxThreads(1);
+  std::mt19937 rng(3333);
+
+  for (int strain = 0; strain < DDS_STRAINS; strain++)
+  {
+    const deal dl = RandomDeal(rng, strain, strain % DDS_HANDS);
+    const futureTricks fixed = Solve(dl, -1, 3, false);
+    const futureTricks guessed = Solve(dl, -1, 3, true);
+    EXPECT_EQ(fixed.nodes, guessed.nodes) << "strain " << strain;
+  }
+}
@@ -1,31 +1,78 @@
 #include <gtest/gtest.h>
 #include <solver_context/SolverContext.hpp>
-#include "system/Memory.hpp"
+#include <trans_table/TransTableShared.hpp>
+#include <api/SolveBoard.hpp>
 
-extern Memory memory;
+#include <algorithm>
+#include <random>
+#include <vector>
 
-TEST(TransTableSharingTest, SameThreadSharesTT)
+TEST(TransTableSharingTest, ContextsOnOneThreadOwnTheirTTs)
 {
-  if (memory.NumThreads() == 0)
-    memory.Resize(1, DDS_TT_SMALL, THREADMEM_SMALL_DEF_MB, THREADMEM_SMALL_MAX_MB);
-
-  // Create an owning context for this (simulates a thread-local owner)
+  // The TT belongs to the context, not to the thread data, so two
+  // contexts over the same ThreadData do not share it.
   SolverContext owner;
   auto thr = owner.thread();
   SolverContext ctx1{thr};
   SolverContext ctx2{thr};
 
-  // Initially no TT
   EXPECT_EQ(ctx1.maybeTransTable(), nullptr);
   EXPECT_EQ(ctx2.maybeTransTable(), nullptr);
 
   TransTable* t1 = ctx1.transTable();
   ASSERT_NE(t1, nullptr);
-  TransTable* t2 = ctx2.maybeTransTable();
+  EXPECT_EQ(ctx2.maybeTransTable(), nullptr);
+
+  TransTable* t2 = ctx2.transTable();
   ASSERT_NE(t2, nullptr);
-  EXPECT_EQ(t1, t2);
+  EXPECT_NE(t1, t2);
 
-  // Dispose via one context should remove from registry
   ctx1.DisposeTransTable();
-  EXPECT_EQ(ctx2.maybeTransTable(), nullptr);
+  EXPECT_EQ(ctx1.maybeTransTable(), nullptr);
+  EXPECT_EQ(ctx2.maybeTransTable(), t2);
+}
+
+TEST(TransTableSharingTest, SharedKindMatchesPrivateResults)
+{
+  // Ten cards each: the ranks from the ace down to the five.
+  std::vector<int> cards;
+  for (int s = 0; s < DDS_SUITS; s++)
+    for (int r = 5; r <= 14; r++)
+      cards.push_back(s * 16 + r);
+  std::mt19937 rng(31);
+  std::shuffle(cards.begin(), cards.end(), rng);
+
+  deal dl = {};
+  dl.trump = 1;
+  for (unsigned c = 0; c < cards.size(); c++)
+    dl.remainCards[c % DDS_HANDS][cards[c] / 16] |= 1u << (cards[c] % 16);
+
+  SolverConfig priv, shared;
+  priv.ttKind = TTKind::Large;
+  priv.useResultCache = false;
+  shared.ttKind = TTKind::Shared;
+  shared.useResultCache = false;
+
+  SolverContext ref(priv), first(shared), second(shared);
+  for (int lead = 0; lead < DDS_HANDS; lead++)
+  {
+    dl.first = lead;
+    futureTricks fr, f1, f2;
+    ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(ref, dl, -1, 3, 0, &fr));
+    ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(first, dl, -1, 3, 0, &f1));
+    ASSERT_EQ(RETURN_NO_FAULT, SolveBoard(second, dl, -1, 3, 0, &f2));
+
+    ASSERT_EQ(fr.cards, f1.cards);
+    ASSERT_EQ(fr.cards, f2.cards);
+    for (int c = 0; c < fr.cards; c++)
+    {
+      EXPECT_EQ(fr.score[c], f1.score[c]);
+      EXPECT_EQ(fr.score[c], f2.score[c]);
+    }
+  }
+
+  // The second context found the first one's work.
+  auto* tt = dynamic_cast<TransTableShared*>(second.maybeTransTable());
+  ASSERT_NE(nullptr, tt);
+  EXPECT_GT(tt->shared_hits(), 0);
 }
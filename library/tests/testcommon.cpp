@@ -71,6 +71,15 @@ int realMain([[maybe_unused]] int argc, [[maybe_unused]] char * argv[])
     stepsize = 1;
   else if (options.solver == DTEST_SOLVER_DEALERPAR)
     stepsize = 1;
+  else if (options.solver == DTEST_SOLVER_SINGLE ||
+      options.solver == DTEST_SOLVER_PARALLEL ||
+      options.solver == DTEST_SOLVER_TABLE ||
+      options.solver == DTEST_SOLVER_TABLEPAR)
+    stepsize = 1;
+
+  // A smaller batch size shows the fixed cost of each batch call.
+  if (options.batchSize > 0 && options.batchSize < stepsize)
+    stepsize = options.batchSize;
 
   set_constants();
   main_identify();
@@ -112,6 +121,7 @@ int realMain([[maybe_unused]] int argc, [[maybe_unused]] char * argv[])
 
   if (options.solver == DTEST_SOLVER_SOLVE)
   {
+    timer.setunits("trick nodes");
     loop_solve(&bop, &solvedbdp, deal_list, fut_list, number, stepsize);
   }
   else if (options.solver == DTEST_SOLVER_CALC)
@@ -121,6 +131,7 @@ int realMain([[maybe_unused]] int argc, [[maybe_unused]] char * argv[])
   }
   else if (options.solver == DTEST_SOLVER_PLAY)
   {
+    timer.setunits("cards");
     loop_play(&bop, &playsp, &solvedplp, deal_list, play_list, trace_list, 
       number, stepsize);
   }
@@ -128,6 +139,33 @@ int realMain([[maybe_unused]] int argc, [[maybe_unused]] char * argv[])
   {
     loop_par(vul_list, table_list, par_list, number, stepsize);
   }
+  else if (options.solver == DTEST_SOLVER_SINGLE)
+  {
+    timer.setunits("trick nodes");
+    loop_single(deal_list, fut_list, number, false);
+  }
+  else if (options.solver == DTEST_SOLVER_PARALLEL)
+  {
+    timer.setunits("trick nodes");
+    loop_single(deal_list, fut_list, number, true);
+  }
+  else if (options.solver == DTEST_SOLVER_TABLE)
+  {
+    loop_table(deal_list, table_list, number, false);
+  }
+  else if (options.solver == DTEST_SOLVER_TABLEPAR)
+  {
+    loop_table(deal_list, table_list, number, true);
+  }
+  else if (options.solver == DTEST_SOLVER_TRACE)
+  {
+    timer.setunits("cards");
+    loop_trace(deal_list, play_list, trace_list, number);
+  }
+  else if (options.solver == DTEST_SOLVER_STREAM)
+  {
+    loop_stream(deal_list, fut_list, number, options.batchSize);
+  }
   else if (options.solver == DTEST_SOLVER_DEALERPAR)
   {
     loop_dealerpar(dealer_list, vul_list, table_list, dealerpar_list, 
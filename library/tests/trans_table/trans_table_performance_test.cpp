@@ -4,13 +4,17 @@
 */
 
 #include <gtest/gtest.h>
+#include <array>
 #include <chrono>
+#include <iostream>
+#include <random>
 #include <vector>
 #include <memory>
 
 #include "trans_table/TransTable.hpp"
 #include "trans_table/TransTableS.hpp"
 #include "trans_table/TransTableL.hpp"
+#include "trans_table/WinMatchScan.hpp"
 #include "library/tests/trans_table/mock_data_generators.hpp"
 
 using dds_test::MockDataFactory;
@@ -172,6 +176,75 @@ TEST_F(TransTablePerformanceTest, SearchTimeComplexityScaling) {
     }
 }
 
+// Lookup time per scan kernel, on one WinBlock where each lookup has
+// to compare against all entries. Reported, not asserted, as timings
+// depend on the host. win_match_scan_test checks the results agree.
+// Not a fixture test, as it needs a table per kernel.
+TEST(TransTableScanPerformanceTest, ScanKernelLookupTime) {
+    MockDataFactory factory(98765);
+    TestScenario scenario = factory.CreateBasicScenario();
+    const int trick = 10, hand = 0;
+    const int handDist[DDS_HANDS] = {0x333, 0x333, 0x333, 0x333};
+    const unsigned short winRanks[DDS_SUITS] = {0x0100, 0x0040, 0x0200, 0x0010};
+    std::mt19937 rng(4242);
+
+    std::vector<std::array<unsigned short, DDS_SUITS>> stored, probes;
+    for (int i = 0; i < BLOCKS_PER_ENTRY; ++i) {
+        std::array<unsigned short, DDS_SUITS> ag;
+        for (auto& a : ag) a = static_cast<unsigned short>(rng() & 0x1fff);
+        stored.push_back(ag);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        std::array<unsigned short, DDS_SUITS> ag;
+        for (auto& a : ag) a = static_cast<unsigned short>(rng() & 0x1fff);
+        probes.push_back(i % 10 == 0 ? stored[static_cast<unsigned>(i) % stored.size()] : ag);
+    }
+
+    const ScanKernel before = active_scan_kernel();
+    const char * const names[] = {"scalar", "sse2", "avx2"};
+    for (const ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::Sse2, ScanKernel::Avx2}) {
+        if (! set_scan_kernel(kernel))
+            continue;
+
+        auto table = std::make_unique<TransTableL>();
+        TransTableL& tt = *table;
+        tt.set_memory_default(64);
+        tt.set_memory_maximum(64);
+        tt.make_tt();
+        tt.init(scenario.handLookup);
+
+        for (const auto& ag : stored) {
+            bool lowerFlag = false;
+            tt.lookup(trick, hand, ag.data(), handDist, 13, lowerFlag);
+            NodeCards node = {2, 1, 0, 0, {0, 0, 0, 0}};
+            tt.add(trick, hand, ag.data(), winRanks, node, false);
+        }
+
+        // The fastest of several short runs.
+        double ns = 0.0;
+        for (int run = 0; run < 5; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < 50; ++r) {
+                for (const auto& ag : probes) {
+                    bool lowerFlag = false;
+                    tt.lookup(trick, hand, ag.data(), handDist, 3, lowerFlag);
+                }
+            }
+            const double t = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            if (run == 0 || t < ns)
+                ns = t;
+        }
+
+        std::cout << "scan kernel " << names[static_cast<int>(kernel)]
+                  << (kernel == best_scan_kernel() ? " (best)" : "")
+                  << ": " << ns / (50.0 * probes.size()) << " ns/lookup\n";
+        tt.return_all_memory();
+    }
+    EXPECT_TRUE(set_scan_kernel(before));
+}
+
 // Thread Safety/Concurrent Access Test (Task 12)
 TEST_F(TransTablePerformanceTest, DISABLED_ConcurrentAccessNotSupported) {
     // The TransTable implementations are not thread-safe.
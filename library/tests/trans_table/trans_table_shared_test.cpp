@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <api/dll.h>
+#include "trans_table/TransTableShared.hpp"
+
+namespace dds_test {
+
+// Rank r of suit s is held by hand (r + s + shift) % 4.
+static void CreateHandLookup(int handLookup[DDS_SUITS][15], int shift) {
+    for (int s = 0; s < DDS_SUITS; ++s) {
+        handLookup[s][0] = handLookup[s][1] = -1;
+        for (int r = 2; r <= 14; ++r)
+            handLookup[s][r] = (r + s + shift) % DDS_HANDS;
+    }
+}
+
+static NodeCards MakeNode(char lower, char upper) {
+    NodeCards node = {upper, lower, 1, 14, {0, 0, 0, 0}};
+    return node;
+}
+
+class TransTableSharedTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SharedTTStore::instance().resize(1);
+    }
+    void TearDown() override {
+        SharedTTStore::instance().clear();
+    }
+
+    static void Prepare(TransTableShared& tt, int shift, int trump) {
+        int handLookup[DDS_SUITS][15];
+        CreateHandLookup(handLookup, shift);
+        tt.set_memory_default(8);
+        tt.set_memory_maximum(8);
+        tt.make_tt();
+        tt.init(handLookup);
+        tt.set_strain(trump);
+    }
+
+    // Eight cards left in each suit, two per hand in the basic layout.
+    // The tricks used below are deep enough to be shared.
+    const unsigned short aggr[DDS_SUITS] = {0x1fe0, 0x0ff0, 0x07f8, 0x03fc};
+    const int handDist[DDS_HANDS] = {0x222, 0x222, 0x222, 0x222};
+    const unsigned short winRanks[DDS_SUITS] = {0, 0, 0, 0};
+};
+
+TEST_F(TransTableSharedTest, StoreAndProbeByKey) {
+    SharedTTStore store;
+    store.resize(1);
+
+    const SharedTTStore::keyType a = {1, 0x1234567890abcdefULL};
+    const SharedTTStore::keyType b = {1, 0x0fedcba987654321ULL};
+    NodeCards node;
+
+    EXPECT_FALSE(store.probe(a, node));
+    store.store(a, 7, MakeNode(3, 5));
+    ASSERT_TRUE(store.probe(a, node));
+    EXPECT_EQ(3, node.lower_bound);
+    EXPECT_EQ(5, node.upper_bound);
+    EXPECT_FALSE(store.probe(b, node));
+
+    // An update of the same position overwrites it.
+    store.store(a, 7, MakeNode(4, 4));
+    ASSERT_TRUE(store.probe(a, node));
+    EXPECT_EQ(4, node.lower_bound);
+
+    store.clear();
+    EXPECT_FALSE(store.probe(a, node));
+}
+
+TEST_F(TransTableSharedTest, FullBucketKeepsTheDeepestEntries) {
+    SharedTTStore store;
+    store.resize(1);
+
+    // All keys in bucket 0.
+    std::vector<SharedTTStore::keyType> keys;
+    for (uint64_t k = 1; k <= 5; ++k)
+        keys.push_back({0, k << 32});
+
+    for (int i = 0; i < 4; ++i)
+        store.store(keys[static_cast<unsigned>(i)], 12 - i, MakeNode(1, 2));
+    store.store(keys[4], 10, MakeNode(1, 2));
+
+    // The entry with 9 tricks left made way.
+    NodeCards node;
+    EXPECT_TRUE(store.probe(keys[0], node));
+    EXPECT_TRUE(store.probe(keys[1], node));
+    EXPECT_TRUE(store.probe(keys[2], node));
+    EXPECT_FALSE(store.probe(keys[3], node));
+    EXPECT_TRUE(store.probe(keys[4], node));
+}
+
+TEST_F(TransTableSharedTest, OtherTableSeesTheEntry) {
+    TransTableShared writer, reader, otherStrain;
+    Prepare(writer, 0, 4);
+    Prepare(reader, 0, 4);
+    Prepare(otherStrain, 0, 1);
+
+    bool lowerFlag;
+    ASSERT_EQ(nullptr, writer.lookup(9, 0, aggr, handDist, 3, lowerFlag));
+    writer.add(9, 0, aggr, winRanks, MakeNode(6, 8), false);
+
+    NodeCards const * hit = reader.lookup(9, 0, aggr, handDist, 3, lowerFlag);
+    ASSERT_NE(nullptr, hit);
+    EXPECT_TRUE(lowerFlag);
+    EXPECT_EQ(6, hit->lower_bound);
+    EXPECT_EQ(1, reader.shared_hits());
+
+    // Not decisive for this limit.
+    EXPECT_EQ(nullptr, reader.lookup(9, 0, aggr, handDist, 6, lowerFlag));
+
+    // Another hand on lead or another strain is another position.
+    EXPECT_EQ(nullptr, reader.lookup(9, 1, aggr, handDist, 3, lowerFlag));
+    EXPECT_EQ(nullptr, otherStrain.lookup(9, 0, aggr, handDist, 3, lowerFlag));
+}
+
+TEST_F(TransTableSharedTest, PositionIsSharedAcrossDeals) {
+    // The deals differ in the cards that are already played.
+    int lookupB[DDS_SUITS][15];
+    CreateHandLookup(lookupB, 0);
+    std::swap(lookupB[0][2], lookupB[0][3]);
+    std::swap(lookupB[1][2], lookupB[1][4]);
+
+    TransTableShared a, b, c;
+    Prepare(a, 0, 0);
+    Prepare(b, 0, 0);
+    Prepare(c, 1, 0);
+    b.init(lookupB);
+
+    bool lowerFlag;
+    (void) a.lookup(10, 2, aggr, handDist, 1, lowerFlag);
+    a.add(10, 2, aggr, winRanks, MakeNode(0, 1), false);
+
+    NodeCards const * hit = b.lookup(10, 2, aggr, handDist, 1, lowerFlag);
+    ASSERT_NE(nullptr, hit);
+    EXPECT_FALSE(lowerFlag);
+
+    // A deal where the remaining cards sit differently.
+    EXPECT_EQ(nullptr, c.lookup(10, 2, aggr, handDist, 1, lowerFlag));
+}
+
+TEST_F(TransTableSharedTest, DealInitFindsTheSameEntries) {
+    // init_deal() only fills the aggregates of the cards still out,
+    // which are all that a search of the deal can look up.
+    int handLookup[DDS_SUITS][15];
+    CreateHandLookup(handLookup, 0);
+    const unsigned short wins[DDS_SUITS] = {0x1000, 0x0100, 0, 0x0008};
+
+    for (const bool dealInit : {false, true}) {
+        TransTableL tt;
+        tt.set_memory_default(8);
+        tt.set_memory_maximum(8);
+        tt.make_tt();
+        if (dealInit)
+            tt.init_deal(handLookup, aggr);
+        else
+            tt.init(handLookup);
+
+        bool lowerFlag;
+        (void) tt.lookup(5, 0, aggr, handDist, 3, lowerFlag);
+        tt.add(5, 0, aggr, wins, MakeNode(4, 6), false);
+
+        NodeCards const * hit = tt.lookup(5, 0, aggr, handDist, 3, lowerFlag);
+        ASSERT_NE(nullptr, hit) << "dealInit " << dealInit;
+        EXPECT_TRUE(lowerFlag);
+        EXPECT_EQ(4, hit->lower_bound);
+    }
+}
+
+TEST_F(TransTableSharedTest, ConcurrentReadersNeverSeeTornEntries) {
+    SharedTTStore store;
+    store.resize(1);
+
+    // Every writer stores lower == upper == key index, so a reader
+    // can tell a mixed-up payload from a real one.
+    const int numKeys = 64;
+    std::atomic<bool> bad{false};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&store, &bad, t, numKeys]() {
+            for (int it = 0; it < 20000; ++it) {
+                const int k = (it * 7 + t) % numKeys;
+                const SharedTTStore::keyType key =
+                    {static_cast<uint64_t>(k % 4),
+                     (static_cast<uint64_t>(k) + 1) * 0x9e3779b97f4a7c15ULL};
+                if ((it + t) % 2) {
+                    store.store(key, k % 13, MakeNode(
+                        static_cast<char>(k), static_cast<char>(k)));
+                } else {
+                    NodeCards node;
+                    if (store.probe(key, node) &&
+                        (node.lower_bound != k || node.upper_bound != k))
+                        bad = true;
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_FALSE(bad);
+}
+
+} // namespace dds_test
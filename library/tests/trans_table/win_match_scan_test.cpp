@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "trans_table/TransTableL.hpp"
+#include "trans_table/WinMatchScan.hpp"
+#include "library/tests/trans_table/mock_data_generators.hpp"
+
+namespace dds_test {
+
+static const ScanKernel kKernels[] =
+    {ScanKernel::Scalar, ScanKernel::Sse2, ScanKernel::Avx2};
+
+// Random entries where about one in four matches search, with masks
+// that run from the top down like the real ones.
+static void FillColumns(WinColumns& cols, unsigned search[3], std::mt19937& rng) {
+    for (int k = 0; k < 3; ++k)
+        search[k] = rng();
+
+    for (int i = 0; i < SCAN_COLUMNS; ++i) {
+        const int depth = static_cast<int>(rng() % 4);
+        for (int k = 0; k < 3; ++k) {
+            const unsigned mask = (k < depth ? rng() | 0x80000000u : 0);
+            cols.top_mask_[k][i] = mask;
+            cols.top_set_[k][i] = (rng() % 4 == 0 ? search[k] ^ ~mask : rng());
+        }
+    }
+}
+
+TEST(WinMatchScanTest, ScalarKernelIsAlwaysThere) {
+    EXPECT_TRUE(scan_kernel_supported(ScanKernel::Scalar));
+    EXPECT_TRUE(scan_kernel_supported(best_scan_kernel()));
+}
+
+TEST(WinMatchScanTest, KernelsAgreeWithScalar) {
+    std::mt19937 rng(2024);
+    WinColumns cols;
+    unsigned search[3];
+
+    for (int round = 0; round < 50; ++round) {
+        FillColumns(cols, search, rng);
+        for (int count = 0; count <= SCAN_COLUMNS; ++count) {
+            uint64_t expected[SCAN_WORDS];
+            scan_function(ScanKernel::Scalar)(cols, count, search, expected);
+
+            for (const ScanKernel kernel : kKernels) {
+                if (! scan_kernel_supported(kernel))
+                    continue;
+                uint64_t bits[SCAN_WORDS];
+                scan_function(kernel)(cols, count, search, bits);
+                for (int w = 0; w < SCAN_WORDS; ++w)
+                    ASSERT_EQ(expected[w], bits[w])
+                        << "kernel " << static_cast<int>(kernel)
+                        << ", count " << count;
+            }
+        }
+    }
+}
+
+TEST(WinMatchScanTest, ScalarMatchesTheDefinition) {
+    std::mt19937 rng(77);
+    WinColumns cols;
+    unsigned search[3];
+    FillColumns(cols, search, rng);
+
+    uint64_t bits[SCAN_WORDS];
+    scan_function(ScanKernel::Scalar)(cols, BLOCKS_PER_ENTRY, search, bits);
+
+    int matches = 0;
+    for (int i = 0; i < SCAN_COLUMNS; ++i) {
+        bool match = (i < BLOCKS_PER_ENTRY);
+        for (int k = 0; k < 3; ++k)
+            if ((cols.top_set_[k][i] ^ search[k]) & cols.top_mask_[k][i])
+                match = false;
+        EXPECT_EQ(match, ((bits[i >> 6] >> (i & 63)) & 1) != 0) << i;
+        matches += match;
+    }
+    EXPECT_GT(matches, 0);
+}
+
+TEST(WinMatchScanTest, SetKernelRejectsWhatTheCpuLacks) {
+    const ScanKernel before = active_scan_kernel();
+    for (const ScanKernel kernel : kKernels) {
+        EXPECT_EQ(scan_kernel_supported(kernel), set_scan_kernel(kernel));
+        if (scan_kernel_supported(kernel)) {
+            EXPECT_EQ(kernel, active_scan_kernel());
+        }
+    }
+    EXPECT_TRUE(set_scan_kernel(before));
+}
+
+// Fill one WinBlock and probe it with lookups that have to compare
+// against all of its entries. Every kernel must give the lookups the
+// scalar kernel gives. Their speed is reported by
+// trans_table_performance_test.
+TEST(WinMatchScanTest, LookupsAgreeAcrossKernels) {
+    MockDataFactory factory(98765);
+    MockDataFactory::TestScenario scenario = factory.CreateBasicScenario();
+    const int trick = 10, hand = 0;
+    const int handDist[DDS_HANDS] = {0x333, 0x333, 0x333, 0x333};
+    const unsigned short winRanks[DDS_SUITS] = {0x0100, 0x0040, 0x0200, 0x0010};
+    std::mt19937 rng(4242);
+
+    std::vector<std::array<unsigned short, DDS_SUITS>> stored, probes;
+    std::vector<NodeCards> nodes;
+    for (int i = 0; i < BLOCKS_PER_ENTRY; ++i) {
+        std::array<unsigned short, DDS_SUITS> ag;
+        for (auto& a : ag) a = static_cast<unsigned short>(rng() & 0x1fff);
+        stored.push_back(ag);
+        const char lower = static_cast<char>(rng() % 8);
+        nodes.push_back({static_cast<char>(lower + rng() % 3), lower, 0, 0, {0, 0, 0, 0}});
+    }
+    for (int i = 0; i < 1000; ++i) {
+        std::array<unsigned short, DDS_SUITS> ag;
+        for (auto& a : ag) a = static_cast<unsigned short>(rng() & 0x1fff);
+        probes.push_back(i % 10 == 0 ? stored[static_cast<unsigned>(i) % stored.size()] : ag);
+    }
+
+    const ScanKernel before = active_scan_kernel();
+    std::vector<int> reference;
+
+    for (const ScanKernel kernel : kKernels) {
+        if (! set_scan_kernel(kernel))
+            continue;
+
+        // Large enough that it does not belong on the stack.
+        auto table = std::make_unique<TransTableL>();
+        TransTableL& tt = *table;
+        tt.set_memory_default(64);
+        tt.set_memory_maximum(64);
+        tt.make_tt();
+        tt.init(scenario.handLookup);
+
+        for (unsigned i = 0; i < stored.size(); ++i) {
+            bool lowerFlag = false;
+            tt.lookup(trick, hand, stored[i].data(), handDist, 13, lowerFlag);
+            tt.add(trick, hand, stored[i].data(), winRanks, nodes[i], false);
+        }
+
+        std::vector<int> results;
+        for (const auto& ag : probes) {
+            bool lowerFlag = false;
+            NodeCards const * np = tt.lookup(trick, hand, ag.data(), handDist, 3, lowerFlag);
+            results.push_back(np ? (lowerFlag ? 1 : 0) + 2 * np->lower_bound : -1);
+        }
+        if (kernel == ScanKernel::Scalar)
+            reference = results;
+        EXPECT_EQ(reference, results) << "kernel " << static_cast<int>(kernel);
+
+        tt.return_all_memory();
+    }
+
+    EXPECT_TRUE(set_scan_kernel(before));
+}
+
+} // namespace dds_test
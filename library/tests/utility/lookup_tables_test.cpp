@@ -1,7 +1,108 @@
 #include <gtest/gtest.h>
 #include <chrono>
+#include <memory>
 #include <lookup_tables/LookupTables.hpp>
 
+namespace {
+
+// The runtime generator that filled the tables before they were
+// generated at compile time. It is the reference for the constant
+// tables, so it deliberately uses the old loops.
+struct ReferenceTables {
+    int highest[8192] = {};
+    int lowest[8192] = {};
+    int count[8192] = {};
+    char rel[8192][15] = {};
+    unsigned short win[8192][14] = {};
+    MoveGroupType group[8192] = {};
+};
+
+void BuildReference(ReferenceTables& t) {
+    for (int aggr = 1; aggr < 8192; aggr++) {
+        for (int r = 14; r >= 2; r--) {
+            if (aggr & (1 << (r - 2))) {
+                t.highest[aggr] = r;
+                break;
+            }
+        }
+        for (int r = 2; r <= 14; r++) {
+            if (aggr & (1 << (r - 2))) {
+                t.lowest[aggr] = r;
+                break;
+            }
+        }
+    }
+
+    for (int aggr = 0; aggr < 8192; aggr++)
+        for (int r = 0; r < 13; r++)
+            if (aggr & (1 << r))
+                t.count[aggr]++;
+
+    for (int aggr = 1; aggr < 8192; aggr++) {
+        char ord = 0;
+        for (int r = 14; r >= 2; r--)
+            if (aggr & (1 << (r - 2)))
+                t.rel[aggr][r] = ++ord;
+    }
+
+    for (int aggr = 0; aggr < 8192; aggr++) {
+        for (int leastWin = 1; leastWin < 14; leastWin++) {
+            int res = 0;
+            int nextBitNo = 1;
+            for (int r = 14; r >= 2; r--) {
+                if (aggr & (1 << (r - 2))) {
+                    if (nextBitNo > leastWin)
+                        break;
+                    res |= 1 << (r - 2);
+                    nextBitNo++;
+                }
+            }
+            t.win[aggr][leastWin] = static_cast<unsigned short>(res);
+        }
+    }
+
+    const int topside[15] = {
+        0x0000, 0x0000, 0x0000, 0x0001, 0x0003, 0x0007, 0x000f, 0x001f,
+        0x003f, 0x007f, 0x00ff, 0x01ff, 0x03ff, 0x07ff, 0x0fff};
+    const int botside[15] = {
+        0xffff, 0xffff, 0x1ffe, 0x1ffc, 0x1ff8, 0x1ff0, 0x1fe0, 0x1fc0,
+        0x1f80, 0x1f00, 0x1e00, 0x1c00, 0x1800, 0x1000, 0x0000};
+
+    t.group[0].last_group_ = -1;
+    t.group[1].last_group_ = 0;
+    t.group[1].rank_[0] = 2;
+    t.group[1].fullseq_[0] = 1;
+
+    int topBitRank = 1;
+    int nextBitRank = 0;
+    int topBitNo = 2;
+    for (int ris = 2; ris < 8192; ris++) {
+        if (ris >= (topBitRank << 1)) {
+            nextBitRank = topBitRank;
+            topBitRank <<= 1;
+            topBitNo++;
+        }
+        MoveGroupType& gd = t.group[ris];
+        gd = t.group[ris ^ topBitRank];
+        if (ris & nextBitRank) {
+            const int g = gd.last_group_;
+            gd.rank_[g]++;
+            gd.sequence_[g] |= nextBitRank;
+            gd.fullseq_[g] |= topBitRank;
+        } else {
+            const int g = ++gd.last_group_;
+            gd.rank_[g] = topBitNo;
+            gd.sequence_[g] = 0;
+            gd.fullseq_[g] = topBitRank;
+            // rank_[-1] overlays last_group_, which is 0 here.
+            const int below = (g == 0 ? gd.last_group_ : gd.rank_[g - 1]);
+            gd.gap_[g] = topside[topBitNo] & botside[below];
+        }
+    }
+}
+
+} // namespace
+
 class LookupTablesTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -30,6 +131,34 @@ TEST_F(LookupTablesTest, InitLookupTablesIdempotent) {
     SUCCEED();
 }
 
+// The compile-time tables must equal the runtime generator entry by entry.
+TEST_F(LookupTablesTest, MatchesRuntimeGenerator) {
+    auto ref = std::make_unique<ReferenceTables>();
+    BuildReference(*ref);
+
+    for (int i = 0; i < 8192; i++) {
+        ASSERT_EQ(highest_rank[i], ref->highest[i]) << "highest_rank[" << i << "]";
+        ASSERT_EQ(lowest_rank[i], ref->lowest[i]) << "lowest_rank[" << i << "]";
+        ASSERT_EQ(count_table[i], ref->count[i]) << "count_table[" << i << "]";
+        for (int r = 0; r < 15; r++)
+            ASSERT_EQ(rel_rank[i][r], ref->rel[i][r])
+                << "rel_rank[" << i << "][" << r << "]";
+        for (int w = 0; w < 14; w++)
+            ASSERT_EQ(win_ranks[i][w], ref->win[i][w])
+                << "win_ranks[" << i << "][" << w << "]";
+
+        const MoveGroupType& got = group_data[i];
+        const MoveGroupType& want = ref->group[i];
+        ASSERT_EQ(got.last_group_, want.last_group_) << "group_data[" << i << "]";
+        for (int g = 0; g < 7; g++) {
+            ASSERT_EQ(got.rank_[g], want.rank_[g]) << "group_data[" << i << "].rank_[" << g << "]";
+            ASSERT_EQ(got.sequence_[g], want.sequence_[g]) << "group_data[" << i << "].sequence_[" << g << "]";
+            ASSERT_EQ(got.fullseq_[g], want.fullseq_[g]) << "group_data[" << i << "].fullseq_[" << g << "]";
+            ASSERT_EQ(got.gap_[g], want.gap_[g]) << "group_data[" << i << "].gap_[" << g << "]";
+        }
+    }
+}
+
 // Test lookup table properties
 TEST_F(LookupTablesTest, HighestRankArray) {
     // Test that highest_rank array has valid values